@@ -101,6 +101,7 @@ int ChromeMain(int argc, const char* argv[]);
 
 #if defined(OS_WIN)
 int APIENTRY wWinMain(HINSTANCE instance, HINSTANCE, wchar_t* cmd, int) {
+  const base::TimeTicks exe_entry_point_ticks = base::TimeTicks::Now();
   int argc = 0;
   wchar_t** argv_setup = ::CommandLineToArgvW(::GetCommandLineW(), &argc);
   base::CommandLine::Init(0, nullptr);
@@ -112,11 +113,10 @@ int ChromeMain(int argc, const char* argv[]) {
 #else  // OS_MACOSX
 int main(int argc, const char* argv[]) {
 #endif
+  const base::TimeTicks exe_entry_point_ticks = base::TimeTicks::Now();
   char** argv_setup = uv_setup_args(argc, const_cast<char**>(argv));
   base::CommandLine::Init(argc, argv_setup);
 #endif  // OS_WIN
-  int64_t exe_entry_point_ticks = 0;
-  // const base::TimeTicks exe_entry_point_ticks = base::TimeTicks::Now();
 
   const base::CommandLine* command_line =
       base::CommandLine::ForCurrentProcess();
@@ -191,8 +191,7 @@ int main(int argc, const char* argv[]) {
   }
 
 #endif
-  atom::AtomMainDelegate chrome_main_delegate(
-      base::TimeTicks::FromInternalValue(exe_entry_point_ticks));
+  atom::AtomMainDelegate chrome_main_delegate(exe_entry_point_ticks);
   content::ContentMainParams params(&chrome_main_delegate);
 
 #if defined(OS_WIN)
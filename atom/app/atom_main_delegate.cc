@@ -13,6 +13,7 @@
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/relauncher.h"
 #include "atom/common/atom_command_line.h"
+#include "atom/common/startup_timeline.h"
 #include "atom/utility/atom_content_utility_client.h"
 #include "base/base_switches.h"
 #include "base/command_line.h"
@@ -232,6 +233,8 @@ AtomMainDelegate::AtomMainDelegate()
     : AtomMainDelegate(base::TimeTicks()) {}
 
 AtomMainDelegate::AtomMainDelegate(base::TimeTicks exe_entry_point_ticks) {
+  if (!exe_entry_point_ticks.is_null())
+    StartupTimeline::GetInstance()->SetOrigin(exe_entry_point_ticks);
 }
 
 AtomMainDelegate::~AtomMainDelegate() {
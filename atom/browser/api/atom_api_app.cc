@@ -24,10 +24,12 @@
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/image_converter.h"
 #include "atom/common/native_mate_converters/net_converter.h"
+#include "atom/common/native_mate_converters/v8_profiler_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
 #include "atom/common/pepper_flash_util.h"
+#include "atom/common/startup_timeline.h"
 #include "base/base_paths.h"
 #include "base/command_line.h"
 #include "base/environment.h"
@@ -36,6 +38,7 @@
 #include "base/memory/memory_pressure_listener.h"
 #include "base/path_service.h"
 #include "base/strings/string_util.h"
+#include "base/time/time.h"
 #include "brave/browser/brave_content_browser_client.h"
 #include "brave/common/workers/v8_worker_thread.h"
 #include "brave/common/workers/worker_bindings.h"
@@ -377,6 +380,22 @@ struct Converter<CertificateRequestResultType> {
   }
 };
 
+template<>
+struct Converter<atom::V8ProfilingHost::Target> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     atom::V8ProfilingHost::Target* out) {
+    mate::Dictionary dict;
+    if (!ConvertFromV8(isolate, val, &dict))
+      return false;
+
+    bool has_process_id = dict.Get("processId", &out->process_id);
+    bool has_worker_id = dict.Get("workerId", &out->worker_id);
+    return !(has_process_id && has_worker_id) &&
+        out->process_id >= 0 && (!has_worker_id || out->worker_id >= 0);
+  }
+};
+
 }  // namespace mate
 
 
@@ -470,13 +489,21 @@ void PassLoginInformation(scoped_refptr<LoginHandler> login_handler,
 
 }  // namespace
 
-App::App(v8::Isolate* isolate) {
+App::App(v8::Isolate* isolate)
+    : worker_memory_consumer_id_(0),
+      sampling_resource_usage_(false) {
   static_cast<brave::BraveContentBrowserClient*>(
     brave::BraveContentBrowserClient::Get())->set_delegate(this);
   atom::Browser::Get()->AddObserver(this);
   content::GpuDataManager::GetInstance()->AddObserver(this);
   Init(isolate);
   static_cast<MuonBrowserProcessImpl*>(g_browser_process)->set_app(this);
+  MemoryCoordinator* memory_coordinator = MemoryCoordinator::GetInstance();
+  memory_coordinator->AddObserver(this);
+  worker_memory_consumer_id_ = memory_coordinator->RegisterConsumer(
+      "worker-isolates", MemoryCoordinator::PRIORITY_ISOLATES,
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE,
+      base::Bind(&brave::V8WorkerThread::ReclaimMemory));
 #if BUILDFLAG(ENABLE_EXTENSIONS)
   registrar_.Add(this,
                  content::NOTIFICATION_WEB_CONTENTS_RENDER_VIEW_HOST_CREATED,
@@ -522,6 +549,10 @@ App::~App() {
   atom::Browser::Get()->RemoveObserver(this);
   net::NetworkChangeNotifier::RemoveMaxBandwidthObserver(this);
   content::GpuDataManager::GetInstance()->RemoveObserver(this);
+  MemoryCoordinator* memory_coordinator = MemoryCoordinator::GetInstance();
+  memory_coordinator->UnregisterConsumer(worker_memory_consumer_id_);
+  memory_coordinator->RemoveObserver(this);
+  StopResourceUsageSampling();
 }
 
 void App::OnBeforeQuit(bool* prevent_default) {
@@ -670,6 +701,78 @@ void App::OnGpuProcessCrashed(base::TerminationStatus exit_code) {
   Emit("gpu-process-crashed");
 }
 
+void App::OnMemoryReclaimed(const MemoryCoordinator::Report& report) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  uint64_t bytes_freed = 0;
+  std::vector<mate::Dictionary> consumers;
+  for (const auto& consumer : report.consumers) {
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate());
+    dict.Set("name", consumer.name);
+    dict.Set("bytesFreed", static_cast<double>(consumer.bytes_freed));
+    dict.Set("duration", consumer.duration.InMillisecondsF());
+    consumers.push_back(dict);
+    bytes_freed += consumer.bytes_freed;
+  }
+
+  mate::Dictionary details = mate::Dictionary::CreateEmpty(isolate());
+  details.Set("level", report.level ==
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL ?
+          "critical" : "moderate");
+  details.Set("bytesFreed", static_cast<double>(bytes_freed));
+  details.Set("consumers", consumers);
+  Emit("memory-reclaimed", details);
+}
+
+void App::OnResourceUsageSampled(const ResourceUsageSampler::Sample& sample) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  std::vector<mate::Dictionary> processes;
+  for (const auto& process : sample.processes) {
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate());
+    dict.Set("id", process.id);
+    dict.Set("pid", static_cast<int>(process.pid));
+    dict.Set("type", process.type);
+    if (!process.extension_ids.empty())
+      dict.Set("extensionIds", process.extension_ids);
+    dict.Set("tabIds", process.tab_ids);
+    dict.Set("cpuUsage", process.cpu_usage);
+    dict.Set("residentMemory", static_cast<double>(process.resident_bytes));
+    dict.Set("privateMemory", static_cast<double>(process.private_bytes));
+    dict.Set("v8HeapSize", static_cast<double>(process.v8_heap.size));
+    dict.Set("v8HeapUsed", static_cast<double>(process.v8_heap.used));
+    dict.Set("bytesSent", static_cast<double>(process.network.sent));
+    dict.Set("bytesReceived", static_cast<double>(process.network.received));
+    processes.push_back(dict);
+  }
+
+  std::vector<mate::Dictionary> tabs;
+  for (const auto& tab : sample.tabs) {
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate());
+    dict.Set("tabId", tab.tab_id);
+    dict.Set("processIds", tab.process_ids);
+    dict.Set("bytesSent", static_cast<double>(tab.network.sent));
+    dict.Set("bytesReceived", static_cast<double>(tab.network.received));
+    tabs.push_back(dict);
+  }
+
+  std::vector<mate::Dictionary> workers;
+  for (const auto& worker : sample.workers) {
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate());
+    dict.Set("workerId", worker.worker_id);
+    dict.Set("v8HeapSize", static_cast<double>(worker.v8_heap.size));
+    dict.Set("v8HeapUsed", static_cast<double>(worker.v8_heap.used));
+    workers.push_back(dict);
+  }
+
+  mate::Dictionary details = mate::Dictionary::CreateEmpty(isolate());
+  details.Set("time", sample.time.ToJsTime());
+  details.Set("processes", processes);
+  details.Set("tabs", tabs);
+  details.Set("workers", workers);
+  Emit("resource-usage", details);
+}
+
 base::FilePath App::GetPath(mate::Arguments* args, const std::string& name) {
   bool succeed = false;
   base::FilePath path;
@@ -792,9 +895,122 @@ bool App::IsAccessibilitySupportEnabled() {
   return ax_state->IsAccessibleBrowser();
 }
 
-void App::SendMemoryPressureAlert() {
-  base::MemoryPressureListener::NotifyMemoryPressure(
-      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+void App::SendMemoryPressureAlert(mate::Arguments* args) {
+  std::string level = "critical";
+  if (args->Length() > 0 && !args->GetNext(&level)) {
+    args->ThrowError("`level` must be a string");
+    return;
+  }
+
+  if (level == "critical") {
+    base::MemoryPressureListener::NotifyMemoryPressure(
+        base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  } else if (level == "moderate") {
+    base::MemoryPressureListener::NotifyMemoryPressure(
+        base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  } else {
+    args->ThrowError("`level` must be 'moderate' or 'critical'");
+  }
+}
+
+std::vector<mate::Dictionary> App::GetStartupTimeline() {
+  std::vector<mate::Dictionary> result;
+  for (const auto& event : StartupTimeline::GetInstance()->GetEvents()) {
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate());
+    dict.Set("name", event.name);
+    dict.Set("startTime", event.start.InMillisecondsF());
+    dict.Set("duration", event.duration.InMillisecondsF());
+    result.push_back(dict);
+  }
+  return result;
+}
+
+void App::WriteStartupTrace(const base::FilePath& path) {
+  StartupTimeline::GetInstance()->WriteTrace(path);
+}
+
+void App::StartResourceUsageSampling(mate::Arguments* args) {
+  ResourceUsageSampler* sampler = ResourceUsageSampler::GetInstance();
+  v8::Local<v8::Value> value;
+  if (args->GetNext(&value) && !value->IsUndefined()) {
+    int interval;
+    if (!mate::ConvertFromV8(isolate(), value, &interval)) {
+      args->ThrowError("`interval` must be a number");
+      return;
+    }
+    if (interval < ResourceUsageSampler::kMinIntervalMs) {
+      args->ThrowError("`interval` must be at least 100");
+      return;
+    }
+    sampler->SetInterval(base::TimeDelta::FromMilliseconds(interval));
+  }
+
+  if (!sampling_resource_usage_) {
+    sampling_resource_usage_ = true;
+    sampler->AddObserver(this);
+  }
+}
+
+void App::StopResourceUsageSampling() {
+  if (!sampling_resource_usage_)
+    return;
+  sampling_resource_usage_ = false;
+  ResourceUsageSampler::GetInstance()->RemoveObserver(this);
+}
+
+bool App::StartProfiling(mate::Arguments* args) {
+  V8ProfilingHost::Target target;
+  if (!args->GetNext(&target)) {
+    args->ThrowError("Invalid profiling target");
+    return false;
+  }
+  V8Profiler::Options options;
+  if (args->Length() > 1 && !args->GetNext(&options)) {
+    args->ThrowError("Invalid profiling options");
+    return false;
+  }
+  return V8ProfilingHost::GetInstance()->Start(target, options);
+}
+
+bool App::StopProfiling(const V8ProfilingHost::Target& target,
+                        int fd,
+                        const V8Profiler::DoneCallback& callback) {
+  return V8ProfilingHost::GetInstance()->Stop(
+      target, DuplicateFileDescriptor(fd), callback);
+}
+
+bool App::WriteHeapSnapshot(const V8ProfilingHost::Target& target,
+                            int fd,
+                            const V8Profiler::DoneCallback& callback) {
+  return V8ProfilingHost::GetInstance()->WriteHeapSnapshot(
+      target, DuplicateFileDescriptor(fd), callback);
+}
+
+void App::EmitForTesting(const std::string& name, mate::Arguments* args) {
+  if (!base::CommandLine::ForCurrentProcess()->HasSwitch(
+          atom::switches::kEnableTestHooks)) {
+    args->ThrowError("Requires --enable-test-hooks");
+    return;
+  }
+  Emit(name, name);
+}
+
+double App::MeasureEmitCost(const std::string& name,
+                            int iterations,
+                            mate::Arguments* args) {
+  if (!base::CommandLine::ForCurrentProcess()->HasSwitch(
+          atom::switches::kEnableTestHooks)) {
+    args->ThrowError("Requires --enable-test-hooks");
+    return 0;
+  }
+  if (iterations <= 0)
+    return 0;
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < iterations; ++i)
+    Emit(name, i, name);
+  return (base::TimeTicks::Now() - start).InNanoseconds() /
+      static_cast<double>(iterations);
 }
 
 void App::PostMessage(int worker_id,
@@ -960,6 +1176,17 @@ void App::BuildPrototype(
       .SetMethod("isAccessibilitySupportEnabled",
                  &App::IsAccessibilitySupportEnabled)
       .SetMethod("sendMemoryPressureAlert", &App::SendMemoryPressureAlert)
+      .SetMethod("getStartupTimeline", &App::GetStartupTimeline)
+      .SetMethod("writeStartupTrace", &App::WriteStartupTrace)
+      .SetMethod("startResourceUsageSampling",
+                 &App::StartResourceUsageSampling)
+      .SetMethod("stopResourceUsageSampling", &App::StopResourceUsageSampling)
+      .SetMethod("startProfiling", &App::StartProfiling)
+      .SetMethod("stopProfiling", &App::StopProfiling)
+      .SetMethod("writeHeapSnapshot", &App::WriteHeapSnapshot)
+      .SetMethod("_setListening", &App::SetListening)
+      .SetMethod("_emitForTesting", &App::EmitForTesting)
+      .SetMethod("_measureEmitCost", &App::MeasureEmitCost)
       .SetMethod("_postMessage", &App::PostMessage)
       .SetMethod("_startWorker", &App::StartWorker)
       .SetMethod("stopWorker", &App::StopWorker)
@@ -7,15 +7,20 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/event_emitter.h"
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/browser_observer.h"
+#include "atom/browser/memory_coordinator.h"
+#include "atom/browser/resource_usage_sampler.h"
+#include "atom/browser/v8_profiling_host.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "chrome/browser/process_singleton.h"
 #include "content/public/browser/gpu_data_manager_observer.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
+#include "native_mate/dictionary.h"
 #include "native_mate/handle.h"
 #include "net/base/completion_callback.h"
 #include "net/base/network_change_notifier.h"
@@ -41,7 +46,9 @@ class App : public AtomBrowserClient::Delegate,
             public BrowserObserver,
             public net::NetworkChangeNotifier::MaxBandwidthObserver,
             public content::GpuDataManagerObserver,
-            public content::NotificationObserver {
+            public content::NotificationObserver,
+            public MemoryCoordinator::Observer,
+            public ResourceUsageSampler::Observer {
  public:
   static mate::Handle<App> Create(v8::Isolate* isolate);
 
@@ -103,6 +110,13 @@ class App : public AtomBrowserClient::Delegate,
   // content::GpuDataManagerObserver:
   void OnGpuProcessCrashed(base::TerminationStatus exit_code) override;
 
+  // MemoryCoordinator::Observer:
+  void OnMemoryReclaimed(const MemoryCoordinator::Report& report) override;
+
+  // ResourceUsageSampler::Observer:
+  void OnResourceUsageSampled(
+      const ResourceUsageSampler::Sample& sample) override;
+
   void Observe(
     int type, const content::NotificationSource& source,
     const content::NotificationDetails& details) override;
@@ -125,7 +139,27 @@ class App : public AtomBrowserClient::Delegate,
   bool Relaunch(mate::Arguments* args);
   void DisableHardwareAcceleration(mate::Arguments* args);
   bool IsAccessibilitySupportEnabled();
-  void SendMemoryPressureAlert();
+  void SendMemoryPressureAlert(mate::Arguments* args);
+  std::vector<mate::Dictionary> GetStartupTimeline();
+  void WriteStartupTrace(const base::FilePath& path);
+  void StartResourceUsageSampling(mate::Arguments* args);
+  void StopResourceUsageSampling();
+  bool StartProfiling(mate::Arguments* args);
+  bool StopProfiling(const V8ProfilingHost::Target& target,
+                     int fd,
+                     const V8Profiler::DoneCallback& callback);
+  bool WriteHeapSnapshot(const V8ProfilingHost::Target& target,
+                         int fd,
+                         const V8Profiler::DoneCallback& callback);
+  // Emits |name| from the native side, throws unless the test hooks are
+  // enabled.
+  void EmitForTesting(const std::string& name, mate::Arguments* args);
+  // Emits |name| |iterations| times and returns the average cost of an
+  // Emit() call in nanoseconds, for the EventEmitter benchmark. Throws unless
+  // the test hooks are enabled.
+  double MeasureEmitCost(const std::string& name,
+                         int iterations,
+                         mate::Arguments* args);
   void PostMessage(int worker_id,
                   v8::Local<v8::Value> message,
                   mate::Arguments* args);
@@ -144,6 +178,9 @@ class App : public AtomBrowserClient::Delegate,
 
   std::unique_ptr<ProcessSingleton> process_singleton_;
 
+  int worker_memory_consumer_id_;
+  bool sampling_resource_usage_;
+
   DISALLOW_COPY_AND_ASSIGN(App);
 };
 
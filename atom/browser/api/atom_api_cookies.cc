@@ -2,7 +2,10 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 
 #include "atom/browser/api/atom_api_cookies.h"
 
@@ -10,6 +13,8 @@
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/optional.h"
+#include "base/strings/string_util.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_context.h"
@@ -56,6 +61,26 @@ struct Converter<net::CanonicalCookie> {
   }
 };
 
+template<>
+struct Converter<atom::api::Cookies::QueryResult> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   const atom::api::Cookies::QueryResult& val) {
+    mate::Dictionary cookies(isolate, v8::Object::New(isolate));
+    cookies.Set("name", val.names);
+    cookies.Set("value", val.values);
+    cookies.Set("domain", val.domains);
+    cookies.Set("path", val.paths);
+    cookies.Set("secure", val.secure);
+    cookies.Set("httpOnly", val.http_only);
+    cookies.Set("expirationDate", val.expiration_dates);
+
+    mate::Dictionary dict(isolate, v8::Object::New(isolate));
+    dict.Set("cookies", cookies);
+    dict.Set("matches", val.matches);
+    return dict.GetHandle();
+  }
+};
+
 }  // namespace mate
 
 namespace atom {
@@ -144,6 +169,208 @@ void GetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
         filtered_callback);
 }
 
+// A filter of a batch query, parsed once on the UI thread.
+struct CookieQueryFilter {
+  base::Optional<std::string> name;
+  std::vector<std::string> name_prefixes;
+  base::Optional<std::string> path;
+  base::Optional<bool> secure;
+  base::Optional<bool> http_only;
+  base::Optional<bool> session;
+  base::Optional<base::Time> expires_after;
+  base::Optional<base::Time> expires_before;
+};
+
+// Compiled batch query. Filters with domains are reached through
+// |domain_index| so each cookie only visits the filters for its own domain and
+// its parent domains.
+struct CookieQuery {
+  std::vector<CookieQueryFilter> filters;
+  std::unordered_map<std::string, std::vector<size_t>> domain_index;
+  std::vector<size_t> any_domain_filters;
+};
+
+// Strips the leading '.' of domain cookies and filter domains.
+std::string NormalizeDomain(const std::string& domain) {
+  if (!domain.empty() && domain[0] == '.')
+    return domain.substr(1);
+  return domain;
+}
+
+bool GetStringOrList(const base::DictionaryValue& dict,
+                     const std::string& key,
+                     std::vector<std::string>* out) {
+  const base::Value* value;
+  if (!dict.Get(key, &value))
+    return true;
+  std::string str;
+  if (value->GetAsString(&str)) {
+    out->push_back(str);
+    return true;
+  }
+  const base::ListValue* list;
+  if (!value->GetAsList(&list))
+    return false;
+  for (const auto& item : *list) {
+    if (!item.GetAsString(&str))
+      return false;
+    out->push_back(str);
+  }
+  return true;
+}
+
+// Parses |filters| into |query|. Returns false and sets |error| on invalid
+// input.
+bool CompileCookieQuery(const base::ListValue& filters,
+                        CookieQuery* query,
+                        std::string* error) {
+  for (size_t i = 0; i < filters.GetSize(); ++i) {
+    const base::DictionaryValue* dict;
+    if (!filters.GetDictionary(i, &dict)) {
+      *error = "Each filter must be an object";
+      return false;
+    }
+
+    CookieQueryFilter filter;
+    std::vector<std::string> domains;
+    if (!GetStringOrList(*dict, "domain", &domains) ||
+        !GetStringOrList(*dict, "domains", &domains) ||
+        !GetStringOrList(*dict, "namePrefix", &filter.name_prefixes)) {
+      *error = "`domains` and `namePrefix` must be strings or string arrays";
+      return false;
+    }
+
+    std::string str;
+    bool b;
+    double d;
+    if (dict->GetString("name", &str))
+      filter.name = str;
+    if (dict->GetString("path", &str))
+      filter.path = str;
+    if (dict->GetBoolean("secure", &b))
+      filter.secure = b;
+    if (dict->GetBoolean("httpOnly", &b))
+      filter.http_only = b;
+    if (dict->GetBoolean("session", &b))
+      filter.session = b;
+    if (dict->GetDouble("expiresAfter", &d))
+      filter.expires_after = base::Time::FromDoubleT(d);
+    if (dict->GetDouble("expiresBefore", &d))
+      filter.expires_before = base::Time::FromDoubleT(d);
+
+    const size_t index = query->filters.size();
+    query->filters.push_back(std::move(filter));
+    if (domains.empty()) {
+      query->any_domain_filters.push_back(index);
+    } else {
+      for (const auto& domain : domains) {
+        auto& indices =
+            query->domain_index[NormalizeDomain(base::ToLowerASCII(domain))];
+        if (indices.empty() || indices.back() != index)
+          indices.push_back(index);
+      }
+    }
+  }
+  return true;
+}
+
+// Returns whether |cookie| matches the non domain parts of |filter|.
+bool MatchesQueryFilter(const CookieQueryFilter& filter,
+                        const net::CanonicalCookie& cookie) {
+  if (filter.name && *filter.name != cookie.Name())
+    return false;
+  if (!filter.name_prefixes.empty() &&
+      std::none_of(filter.name_prefixes.begin(), filter.name_prefixes.end(),
+                   [&cookie](const std::string& prefix) {
+                     return base::StartsWith(cookie.Name(), prefix,
+                                             base::CompareCase::SENSITIVE);
+                   }))
+    return false;
+  if (filter.path && *filter.path != cookie.Path())
+    return false;
+  if (filter.secure && *filter.secure != cookie.IsSecure())
+    return false;
+  if (filter.http_only && *filter.http_only != cookie.IsHttpOnly())
+    return false;
+  if (filter.session && *filter.session != !cookie.IsPersistent())
+    return false;
+  if (filter.expires_after || filter.expires_before) {
+    // Session cookies have no expiration date to compare.
+    if (!cookie.IsPersistent())
+      return false;
+    if (filter.expires_after && cookie.ExpiryDate() < *filter.expires_after)
+      return false;
+    if (filter.expires_before && cookie.ExpiryDate() >= *filter.expires_before)
+      return false;
+  }
+  return true;
+}
+
+void RunQueryCallback(const Cookies::QueryCallback& callback,
+                      std::unique_ptr<Cookies::QueryResult> result) {
+  callback.Run(Cookies::SUCCESS, *result);
+}
+
+// Answers every filter of |query| in one pass over |list|.
+void RunCookieQuery(std::unique_ptr<CookieQuery> query,
+                    const Cookies::QueryCallback& callback,
+                    const net::CookieList& list) {
+  std::unique_ptr<Cookies::QueryResult> result(new Cookies::QueryResult);
+  result->matches.resize(query->filters.size());
+  // Last row each filter matched, so a filter listing both a domain and one
+  // of its subdomains reports a cookie once.
+  std::vector<int> last_row(query->filters.size(), -1);
+
+  std::vector<size_t> candidates;
+  for (const auto& cookie : list) {
+    candidates = query->any_domain_filters;
+    // Look the cookie domain and all its parent domains up in the index.
+    const std::string domain = NormalizeDomain(cookie.Domain());
+    for (size_t pos = 0;;) {
+      auto it = query->domain_index.find(domain.substr(pos));
+      if (it != query->domain_index.end())
+        candidates.insert(candidates.end(), it->second.begin(),
+                          it->second.end());
+      const size_t next_dot = domain.find('.', pos);
+      if (next_dot == std::string::npos)
+        break;
+      pos = next_dot + 1;
+    }
+
+    int row = -1;
+    for (size_t index : candidates) {
+      if (row != -1 && last_row[index] == row)
+        continue;
+      if (!MatchesQueryFilter(query->filters[index], cookie))
+        continue;
+      if (row == -1) {
+        row = static_cast<int>(result->names.size());
+        result->names.push_back(cookie.Name());
+        result->values.push_back(cookie.Value());
+        result->domains.push_back(cookie.Domain());
+        result->paths.push_back(cookie.Path());
+        result->secure.push_back(cookie.IsSecure());
+        result->http_only.push_back(cookie.IsHttpOnly());
+        result->expiration_dates.push_back(
+            cookie.IsPersistent() ? cookie.ExpiryDate().ToDoubleT() : 0);
+      }
+      last_row[index] = row;
+      result->matches[index].push_back(row);
+    }
+  }
+
+  RunCallbackInUI(base::Bind(RunQueryCallback, callback,
+                             base::Passed(&result)));
+}
+
+// Runs |query| against the whole cookie jar in IO thread.
+void QueryCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                      std::unique_ptr<CookieQuery> query,
+                      const Cookies::QueryCallback& callback) {
+  GetCookieStore(getter)->GetAllCookiesAsync(
+      base::Bind(RunCookieQuery, base::Passed(&query), callback));
+}
+
 // Removes cookie with |url| and |name| in IO thread.
 void RemoveCookieOnIOThread(scoped_refptr<net::URLRequestContextGetter> getter,
                             const GURL& url, const std::string& name,
@@ -212,6 +439,10 @@ void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
 
 }  // namespace
 
+Cookies::QueryResult::QueryResult() {}
+
+Cookies::QueryResult::~QueryResult() {}
+
 Cookies::Cookies(v8::Isolate* isolate,
                  AtomBrowserContext* browser_context)
       : request_context_getter_(browser_context->url_request_context_getter()) {
@@ -258,6 +489,27 @@ void Cookies::Set(const base::DictionaryValue& details,
       base::Bind(SetCookieOnIO, getter, Passed(&copied), callback));
 }
 
+void Cookies::Query(mate::Arguments* args) {
+  base::ListValue filters;
+  QueryCallback callback;
+  if (!args->GetNext(&filters) || !args->GetNext(&callback)) {
+    args->ThrowError("`filters` array and `callback` are required");
+    return;
+  }
+
+  std::unique_ptr<CookieQuery> query(new CookieQuery);
+  std::string error;
+  if (!CompileCookieQuery(filters, query.get(), &error)) {
+    args->ThrowError(error);
+    return;
+  }
+
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(QueryCookiesOnIO, getter, Passed(&query), callback));
+}
+
 // static
 mate::Handle<Cookies> Cookies::Create(
     v8::Isolate* isolate,
@@ -273,6 +525,7 @@ void Cookies::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("get", &Cookies::Get)
       .SetMethod("remove", &Cookies::Remove)
       .SetMethod("set", &Cookies::Set)
+      .SetMethod("query", &Cookies::Query)
       .SetMethod("getAll", &Cookies::GetAll);
 }
 
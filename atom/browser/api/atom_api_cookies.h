@@ -6,6 +6,7 @@
 #define ATOM_BROWSER_API_ATOM_API_COOKIES_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
 #include "base/callback.h"
@@ -14,6 +15,11 @@
 
 namespace base {
 class DictionaryValue;
+class ListValue;
+}
+
+namespace mate {
+class Arguments;
 }
 
 namespace net {
@@ -33,8 +39,26 @@ class Cookies : public mate::TrackableObject<Cookies> {
     FAILED,
   };
 
+  // Result of a batch query. Every matching cookie is stored once, column by
+  // column, and |matches| lists for each filter the rows that matched it.
+  struct QueryResult {
+    QueryResult();
+    ~QueryResult();
+
+    std::vector<std::string> names;
+    std::vector<std::string> values;
+    std::vector<std::string> domains;
+    std::vector<std::string> paths;
+    std::vector<bool> secure;
+    std::vector<bool> http_only;
+    // 0 for session cookies.
+    std::vector<double> expiration_dates;
+    std::vector<std::vector<int>> matches;
+  };
+
   using GetCallback = base::Callback<void(Error, const net::CookieList&)>;
   using SetCallback = base::Callback<void(Error)>;
+  using QueryCallback = base::Callback<void(Error, const QueryResult&)>;
 
   static mate::Handle<Cookies> Create(v8::Isolate* isolate,
                                       AtomBrowserContext* browser_context);
@@ -52,6 +76,7 @@ class Cookies : public mate::TrackableObject<Cookies> {
   void Remove(const GURL& url, const std::string& name,
               const base::Closure& callback);
   void Set(const base::DictionaryValue& details, const SetCallback& callback);
+  void Query(mate::Arguments* args);
 
  private:
   net::URLRequestContextGetter* request_context_getter_;
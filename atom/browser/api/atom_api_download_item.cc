@@ -5,13 +5,16 @@
 #include "atom/browser/api/atom_api_download_item.h"
 
 #include <map>
+#include <utility>
 
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
+#include "atom/common/native_mate_converters/value_converter.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "base/values.h"
 #include "native_mate/dictionary.h"
 #include "net/base/filename_util.h"
 
@@ -60,7 +63,11 @@ DownloadItem::DownloadItem(v8::Isolate* isolate,
                            content::DownloadItem* download_item)
     : download_item_(download_item),
       prompt_(download_item->GetTargetDisposition() ==
-          content::DownloadItem::TARGET_DISPOSITION_PROMPT) {
+          content::DownloadItem::TARGET_DISPOSITION_PROMPT),
+      progress_min_bytes_(0),
+      last_update_bytes_(0),
+      last_update_state_(download_item->GetState()),
+      last_update_paused_(download_item->IsPaused()) {
   download_item_->AddObserver(this);
   Init(isolate);
   AttachAsUserData(download_item);
@@ -77,16 +84,64 @@ DownloadItem::~DownloadItem() {
   g_download_item_objects.erase(weak_map_id());
 }
 
+// static
+std::unique_ptr<base::DictionaryValue> DownloadItem::GetProgressValue(
+    content::DownloadItem* item) {
+  std::unique_ptr<base::DictionaryValue> progress(new base::DictionaryValue);
+  progress->SetString("guid", item->GetGuid());
+  progress->SetDouble("receivedBytes", item->GetReceivedBytes());
+  progress->SetDouble("totalBytes", item->GetTotalBytes());
+  progress->SetDouble("speed", item->CurrentSpeed());
+  base::TimeDelta remaining;
+  progress->SetDouble("eta", item->TimeRemaining(&remaining) ?
+      remaining.InSecondsF() : -1);
+  progress->SetBoolean("paused", item->IsPaused());
+  return progress;
+}
+
+void DownloadItem::SetProgressRate(base::TimeDelta interval,
+                                   int64_t min_bytes) {
+  progress_interval_ = interval;
+  progress_min_bytes_ = min_bytes;
+}
+
 void DownloadItem::OnDownloadUpdated(content::DownloadItem* item) {
   if (download_item_->IsDone()) {
+    pending_update_timer_.Stop();
     Emit("done", item->GetState());
 
     // Destroy the item once item is downloaded.
     base::ThreadTaskRunnerHandle::Get()->PostTask(
         FROM_HERE, GetDestroyClosure());
-  } else {
-    Emit("updated", item->GetState());
+    return;
   }
+
+  // State changes are always reported, progress is coalesced.
+  const bool state_changed = item->GetState() != last_update_state_ ||
+      item->IsPaused() != last_update_paused_;
+  const base::TimeDelta elapsed =
+      base::TimeTicks::Now() - last_update_time_;
+  const bool enough_bytes = progress_min_bytes_ > 0 &&
+      item->GetReceivedBytes() - last_update_bytes_ >= progress_min_bytes_;
+  if (state_changed || enough_bytes || elapsed >= progress_interval_) {
+    EmitUpdated();
+  } else if (!pending_update_timer_.IsRunning()) {
+    pending_update_timer_.Start(FROM_HERE, progress_interval_ - elapsed,
+        base::Bind(&DownloadItem::EmitUpdated, base::Unretained(this)));
+  }
+}
+
+void DownloadItem::EmitUpdated() {
+  pending_update_timer_.Stop();
+  if (!download_item_ || download_item_->IsDone())
+    return;
+
+  last_update_time_ = base::TimeTicks::Now();
+  last_update_bytes_ = download_item_->GetReceivedBytes();
+  last_update_state_ = download_item_->GetState();
+  last_update_paused_ = download_item_->IsPaused();
+  Emit("updated", download_item_->GetState(),
+       *GetProgressValue(download_item_));
 }
 
 void DownloadItem::OnDownloadRemoved(content::DownloadItem* download) {
@@ -184,6 +239,10 @@ std::string DownloadItem::GetGuid() const {
   return download_item_->GetGuid();
 }
 
+v8::Local<v8::Value> DownloadItem::GetProgress(v8::Isolate* isolate) {
+  return mate::ConvertToV8(isolate, *GetProgressValue(download_item_));
+}
+
 // static
 void DownloadItem::BuildPrototype(v8::Isolate* isolate,
                                   v8::Local<v8::FunctionTemplate> prototype) {
@@ -208,7 +267,8 @@ void DownloadItem::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setSavePath", &DownloadItem::SetSavePath)
       .SetMethod("getSavePath", &DownloadItem::GetSavePath)
       .SetMethod("getGuid", &DownloadItem::GetGuid)
-      .SetMethod("setPrompt", &DownloadItem::SetPrompt);
+      .SetMethod("setPrompt", &DownloadItem::SetPrompt)
+      .SetMethod("getProgress", &DownloadItem::GetProgress);
 }
 
 // static
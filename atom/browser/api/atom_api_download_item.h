@@ -5,14 +5,21 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_DOWNLOAD_ITEM_H_
 #define ATOM_BROWSER_API_ATOM_API_DOWNLOAD_ITEM_H_
 
+#include <memory>
 #include <string>
 
 #include "atom/browser/api/trackable_object.h"
 #include "base/files/file_path.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "content/public/browser/download_item.h"
 #include "native_mate/handle.h"
 #include "url/gurl.h"
 
+namespace base {
+class DictionaryValue;
+}
+
 namespace atom {
 
 namespace api {
@@ -26,6 +33,15 @@ class DownloadItem : public mate::TrackableObject<DownloadItem>,
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
 
+  // Returns the progress of |item| with its speed and estimated time left.
+  static std::unique_ptr<base::DictionaryValue> GetProgressValue(
+      content::DownloadItem* item);
+
+  // "updated" events that only report progress are emitted at most once per
+  // |interval|, unless at least |min_bytes| were received since the last one.
+  // A zero |min_bytes| disables the bytes based trigger.
+  void SetProgressRate(base::TimeDelta interval, int64_t min_bytes);
+
   void Pause();
   bool IsPaused() const;
   void Resume();
@@ -46,6 +62,7 @@ class DownloadItem : public mate::TrackableObject<DownloadItem>,
   std::string GetGuid() const;
   void SetPrompt(bool prompt);
   bool ShouldPrompt();
+  v8::Local<v8::Value> GetProgress(v8::Isolate* isolate);
 
  protected:
   DownloadItem(v8::Isolate* isolate, content::DownloadItem* download_item);
@@ -57,10 +74,22 @@ class DownloadItem : public mate::TrackableObject<DownloadItem>,
   void OnDownloadDestroyed(content::DownloadItem* download) override;
 
  private:
+  void EmitUpdated();
+
   base::FilePath save_path_;
   content::DownloadItem* download_item_;
   bool prompt_;
 
+  base::TimeDelta progress_interval_;
+  int64_t progress_min_bytes_;
+  // What the last "updated" event reported.
+  base::TimeTicks last_update_time_;
+  int64_t last_update_bytes_;
+  content::DownloadItem::DownloadState last_update_state_;
+  bool last_update_paused_;
+  // Emits the progress held back by the rate limit.
+  base::OneShotTimer pending_update_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(DownloadItem);
 };
 
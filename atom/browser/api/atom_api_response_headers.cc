@@ -0,0 +1,72 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/atom_api_response_headers.h"
+
+#include <utility>
+#include <vector>
+
+#include "atom/common/native_mate_converters/net_converter.h"
+#include "native_mate/object_template_builder.h"
+#include "net/http/http_response_headers.h"
+
+namespace atom {
+
+namespace api {
+
+ResponseHeaders::ResponseHeaders(
+    v8::Isolate* isolate,
+    scoped_refptr<const net::HttpResponseHeaders> headers)
+    : headers_(std::move(headers)) {
+  Init(isolate);
+}
+
+ResponseHeaders::~ResponseHeaders() {
+}
+
+v8::Local<v8::Value> ResponseHeaders::Get(const std::string& name) {
+  if (!headers_)
+    return v8::Undefined(isolate());
+
+  std::vector<std::string> values;
+  size_t iter = 0;
+  std::string value;
+  while (headers_->EnumerateHeader(&iter, name, &value))
+    values.push_back(value);
+  if (values.empty())
+    return v8::Undefined(isolate());
+  return mate::ConvertToV8(isolate(), values);
+}
+
+bool ResponseHeaders::Has(const std::string& name) {
+  return headers_ && headers_->HasHeader(name);
+}
+
+v8::Local<v8::Value> ResponseHeaders::ToObject() {
+  if (object_.IsEmpty())
+    object_.Reset(isolate(), mate::ConvertToV8(isolate(), headers_.get()));
+  return v8::Local<v8::Value>::New(isolate(), object_);
+}
+
+// static
+mate::Handle<ResponseHeaders> ResponseHeaders::Create(
+    v8::Isolate* isolate,
+    scoped_refptr<const net::HttpResponseHeaders> headers) {
+  return mate::CreateHandle(isolate,
+                            new ResponseHeaders(isolate, std::move(headers)));
+}
+
+// static
+void ResponseHeaders::BuildPrototype(
+    v8::Isolate* isolate, v8::Local<v8::FunctionTemplate> prototype) {
+  prototype->SetClassName(mate::StringToV8(isolate, "ResponseHeaders"));
+  mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
+      .SetMethod("get", &ResponseHeaders::Get)
+      .SetMethod("has", &ResponseHeaders::Has)
+      .SetMethod("toObject", &ResponseHeaders::ToObject);
+}
+
+}  // namespace api
+
+}  // namespace atom
@@ -0,0 +1,56 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_ATOM_API_RESPONSE_HEADERS_H_
+#define ATOM_BROWSER_API_ATOM_API_RESPONSE_HEADERS_H_
+
+#include <string>
+
+#include "base/memory/ref_counted.h"
+#include "native_mate/handle.h"
+#include "native_mate/wrappable.h"
+
+namespace net {
+class HttpResponseHeaders;
+}
+
+namespace atom {
+
+namespace api {
+
+// Read-only view of the headers of a response. Nothing is converted to V8
+// until a script asks for it, so emitting one per subresource is cheap.
+class ResponseHeaders : public mate::Wrappable<ResponseHeaders> {
+ public:
+  static mate::Handle<ResponseHeaders> Create(
+      v8::Isolate* isolate,
+      scoped_refptr<const net::HttpResponseHeaders> headers);
+
+  static void BuildPrototype(v8::Isolate* isolate,
+                             v8::Local<v8::FunctionTemplate> prototype);
+
+ protected:
+  ResponseHeaders(v8::Isolate* isolate,
+                  scoped_refptr<const net::HttpResponseHeaders> headers);
+  ~ResponseHeaders() override;
+
+  // Returns all values of the header |name|, or undefined when it is absent.
+  v8::Local<v8::Value> Get(const std::string& name);
+  bool Has(const std::string& name);
+  // Returns every header as a dictionary of lower-cased names to value lists,
+  // which is what the event used to pass. The result is cached.
+  v8::Local<v8::Value> ToObject();
+
+ private:
+  scoped_refptr<const net::HttpResponseHeaders> headers_;
+  v8::Global<v8::Value> object_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResponseHeaders);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_ATOM_API_RESPONSE_HEADERS_H_
@@ -4,6 +4,7 @@
 
 #include "atom/browser/api/atom_api_session.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <set>
@@ -23,6 +24,7 @@
 #include "atom/browser/atom_browser_main_parts.h"
 #include "atom/browser/browser.h"
 #include "atom/browser/net/atom_cert_verifier.h"
+#include "atom/browser/net/http_cache_walker.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/content_converter.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
@@ -35,10 +37,11 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/task/cancelable_task_tracker.h"
-#include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "brave/browser/brave_content_browser_client.h"
 #include "brave/browser/brave_permission_manager.h"
+#include "brave/browser/guest_view/tab_view/spare_renderer_pool.h"
+#include "brave/browser/resource_coordinator/background_tab_policy.h"
 #include "chrome/browser/history/history_service_factory.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/pref_names.h"
@@ -52,6 +55,7 @@
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/base/load_flags.h"
+#include "net/base/net_errors.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/dns/host_cache.h"
 #include "net/http/http_auth_handler_factory.h"
@@ -293,6 +297,37 @@ void DoCacheActionInIO(
     on_get_backend.Run(net::OK);
 }
 
+using CacheWalkDoneCallback =
+    base::Callback<void(const std::string&, const base::DictionaryValue&)>;
+
+// Reads the cache walk options shared by getCacheUsage and clearCacheEntries.
+void GetCacheWalkerOptions(const mate::Dictionary& dict,
+                           HttpCacheWalker::Options* options) {
+  std::vector<std::string> origins;
+  if (dict.Get("origins", &origins)) {
+    for (const auto& origin : origins)
+      options->filter.origins.push_back(GURL(origin).GetOrigin());
+  }
+  dict.Get("urlPrefixes", &options->filter.url_prefixes);
+
+  double time;
+  if (dict.Get("lastUsedBefore", &time))
+    options->filter.last_used_before = base::Time::FromJsTime(time);
+  if (dict.Get("lastUsedAfter", &time))
+    options->filter.last_used_after = base::Time::FromJsTime(time);
+
+  int batch_size;
+  if (dict.Get("batchSize", &batch_size) && batch_size > 0)
+    options->batch_size = batch_size;
+}
+
+void OnCacheWalkDone(const CacheWalkDoneCallback& callback,
+                     int result,
+                     const base::DictionaryValue& totals) {
+  callback.Run(result == net::OK ? std::string() : net::ErrorToString(result),
+               totals);
+}
+
 void SetProxyInIO(scoped_refptr<net::URLRequestContextGetter> getter,
                   const net::ProxyConfig& config,
                   const base::Closure& callback) {
@@ -347,12 +382,22 @@ void OnClearStorageDataDone(const base::Closure& callback) {
 
 void OnClearHistory() {}
 
+// Period of the "download-progress" event when the "updated" events of the
+// items are not throttled.
+const int kDefaultDownloadProgressIntervalMs = 250;
+// Lower bound of the "download-progress" period.
+const int kMinDownloadProgressIntervalMs = 50;
+
 }  // namespace
 
 Session::Session(v8::Isolate* isolate, Profile* profile)
     : devtools_network_emulation_client_id_(base::GenerateGUID()),
       profile_(profile),
-      request_context_getter_(profile->GetRequestContext()) {
+      request_context_getter_(profile->GetRequestContext()),
+      download_progress_min_bytes_(0),
+      aggregate_download_progress_(true),
+      last_download_progress_bytes_(-1),
+      observed_downloads_(this) {
   // Observe DownloadManger to get download notifications.
   content::BrowserContext::GetDownloadManager(profile)->
       AddObserver(this);
@@ -393,14 +438,176 @@ void Session::OnDownloadCreated(content::DownloadManager* manager,
 
   v8::Locker locker(isolate());
   v8::HandleScope handle_scope(isolate());
+  auto download_item = DownloadItem::Create(isolate(), item);
+  download_item->SetProgressRate(download_progress_interval_,
+                                 download_progress_min_bytes_);
   bool prevent_default = Emit(
       "will-download",
-      DownloadItem::Create(isolate(), item),
+      download_item,
       item->GetWebContents());
   if (prevent_default) {
     item->Cancel(true);
     item->Remove();
+    return;
   }
+
+  observed_downloads_.Add(item);
+  if (aggregate_download_progress_ && !download_progress_timer_.IsRunning())
+    StartDownloadProgressTimer();
+}
+
+void Session::OnDownloadUpdated(content::DownloadItem* item) {
+  // The timer stops once nothing is in progress, a resumed download starts
+  // it again.
+  if (aggregate_download_progress_ &&
+      item->GetState() == content::DownloadItem::IN_PROGRESS &&
+      !download_progress_timer_.IsRunning())
+    StartDownloadProgressTimer();
+}
+
+void Session::OnDownloadDestroyed(content::DownloadItem* item) {
+  observed_downloads_.Remove(item);
+}
+
+void Session::SetSpareRendererPoolSize(int size) {
+  brave::SpareRendererPool::FromBrowserContext(profile_)->SetTargetSize(
+      std::max(size, 0));
+}
+
+v8::Local<v8::Value> Session::GetSpareRendererPoolStats() {
+  auto pool = brave::SpareRendererPool::FromBrowserContext(profile_);
+  const auto& stats = pool->stats();
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate());
+  dict.Set("targetSize", static_cast<int>(pool->target_size()));
+  dict.Set("size", static_cast<int>(pool->size()));
+  dict.Set("hits", static_cast<double>(stats.hits));
+  dict.Set("misses", static_cast<double>(stats.misses));
+  dict.Set("launched", static_cast<double>(stats.launched));
+  dict.Set("dropped", static_cast<double>(stats.dropped));
+  return dict.GetHandle();
+}
+
+void Session::SetBackgroundTabPolicy(mate::Arguments* args) {
+  mate::Dictionary dict;
+  if (!args->GetNext(&dict)) {
+    args->ThrowError();
+    return;
+  }
+
+  auto policy = brave::BackgroundTabPolicy::FromBrowserContext(profile_);
+  brave::BackgroundTabPolicy::Options options = policy->options();
+  dict.Get("enabled", &options.enabled);
+  dict.Get("lowerPriority", &options.lower_priority);
+
+  std::string timer_throttling;
+  if (dict.Get("timerThrottling", &timer_throttling) &&
+      !brave::BackgroundTabPolicy::TimerThrottlingFromString(
+          timer_throttling, &options.timer_throttling)) {
+    args->ThrowError("timerThrottling must be none, aligned or budget");
+    return;
+  }
+
+  double freeze_after;
+  if (dict.Get("freezeAfter", &freeze_after)) {
+    options.freeze_after =
+        base::TimeDelta::FromSecondsD(std::max(freeze_after, 0.0));
+  }
+
+  policy->SetOptions(options);
+}
+
+v8::Local<v8::Value> Session::GetBackgroundTabStats() {
+  auto policy = brave::BackgroundTabPolicy::FromBrowserContext(profile_);
+  brave::BackgroundTabPolicy::Stats stats = policy->GetStats();
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate());
+  dict.Set("freezes", static_cast<double>(stats.freezes));
+  dict.Set("thaws", static_cast<double>(stats.thaws));
+  dict.Set("frozenProcesses", static_cast<int>(stats.frozen_processes));
+  dict.Set("frozenTime", stats.frozen_time.InSecondsF());
+  dict.Set("cpuTimeSaved", stats.cpu_time_saved.InSecondsF());
+  return dict.GetHandle();
+}
+
+void Session::SetDownloadProgressOptions(
+    const base::DictionaryValue& options) {
+  int interval;
+  if (options.GetInteger("interval", &interval))
+    download_progress_interval_ =
+        base::TimeDelta::FromMilliseconds(std::max(interval, 0));
+  double min_bytes;
+  if (options.GetDouble("minBytes", &min_bytes))
+    download_progress_min_bytes_ =
+        static_cast<int64_t>(std::max(min_bytes, 0.0));
+  options.GetBoolean("aggregate", &aggregate_download_progress_);
+
+  // Apply the new rate to the downloads already running.
+  download_progress_timer_.Stop();
+  std::vector<content::DownloadItem*> items;
+  content::BrowserContext::GetDownloadManager(profile_)->GetAllDownloads(
+      &items);
+  bool in_progress = false;
+  for (auto item : items) {
+    auto download_item = static_cast<DownloadItem*>(
+        DownloadItem::FromWrappedClass(isolate(), item));
+    if (download_item)
+      download_item->SetProgressRate(download_progress_interval_,
+                                     download_progress_min_bytes_);
+    in_progress |= item->GetState() == content::DownloadItem::IN_PROGRESS;
+  }
+  if (aggregate_download_progress_ && in_progress)
+    StartDownloadProgressTimer();
+}
+
+void Session::StartDownloadProgressTimer() {
+  last_download_progress_bytes_ = -1;
+  base::TimeDelta period = download_progress_interval_.is_zero() ?
+      base::TimeDelta::FromMilliseconds(kDefaultDownloadProgressIntervalMs) :
+      std::max(download_progress_interval_,
+               base::TimeDelta::FromMilliseconds(
+                   kMinDownloadProgressIntervalMs));
+  download_progress_timer_.Start(FROM_HERE, period,
+      base::Bind(&Session::EmitDownloadProgress, base::Unretained(this)));
+}
+
+void Session::EmitDownloadProgress() {
+  std::vector<content::DownloadItem*> items;
+  content::BrowserContext::GetDownloadManager(profile_)->GetAllDownloads(
+      &items);
+
+  base::ListValue downloads;
+  int64_t received_bytes = 0;
+  int64_t total_bytes = 0;
+  int64_t speed = 0;
+  for (auto item : items) {
+    if (item->GetState() != content::DownloadItem::IN_PROGRESS ||
+        item->IsSavePackageDownload())
+      continue;
+    received_bytes += item->GetReceivedBytes();
+    total_bytes += item->GetTotalBytes();
+    if (!item->IsPaused())
+      speed += item->CurrentSpeed();
+    downloads.Append(DownloadItem::GetProgressValue(item));
+  }
+
+  if (downloads.empty()) {
+    download_progress_timer_.Stop();
+    return;
+  }
+  // Nothing moved since the last event.
+  if (received_bytes == last_download_progress_bytes_)
+    return;
+  last_download_progress_bytes_ = received_bytes;
+
+  base::DictionaryValue totals;
+  totals.SetDouble("receivedBytes", received_bytes);
+  totals.SetDouble("totalBytes", total_bytes);
+  totals.SetDouble("speed", speed);
+  totals.SetDouble("eta", speed > 0 && total_bytes >= received_bytes ?
+      static_cast<double>(total_bytes - received_bytes) / speed : -1);
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  Emit("download-progress", downloads, totals);
 }
 
 void Session::ResolveProxy(const GURL& url, ResolveProxyCallback callback) {
@@ -416,6 +623,49 @@ void Session::DoCacheAction(const net::CompletionCallback& callback) {
                  callback));
 }
 
+void Session::GetCacheUsage(mate::Arguments* args) {
+  // _getCacheUsage(options, progress, callback)
+  mate::Dictionary dict;
+  HttpCacheWalker::BatchCallback batch_callback;
+  CacheWalkDoneCallback callback;
+  if (!args->GetNext(&dict) || !args->GetNext(&batch_callback) ||
+      !args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+
+  HttpCacheWalker::Options options;
+  options.mode = HttpCacheWalker::Mode::USAGE;
+  GetCacheWalkerOptions(dict, &options);
+  dict.Get("contentTypes", &options.content_types);
+
+  HttpCacheWalker::Start(request_context_getter_, options, batch_callback,
+                         base::Bind(&OnCacheWalkDone, callback));
+}
+
+void Session::ClearCacheEntries(mate::Arguments* args) {
+  // _clearCacheEntries(filter, progress, callback)
+  mate::Dictionary dict;
+  HttpCacheWalker::BatchCallback batch_callback;
+  CacheWalkDoneCallback callback;
+  if (!args->GetNext(&dict) || !args->GetNext(&batch_callback) ||
+      !args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+
+  HttpCacheWalker::Options options;
+  options.mode = HttpCacheWalker::Mode::DOOM;
+  GetCacheWalkerOptions(dict, &options);
+  if (options.filter.IsEmpty()) {
+    args->ThrowError("The filter must not be empty, use clearCache instead");
+    return;
+  }
+
+  HttpCacheWalker::Start(request_context_getter_, options, batch_callback,
+                         base::Bind(&OnCacheWalkDone, callback));
+}
+
 void Session::ClearStorageData(mate::Arguments* args) {
   // clearStorageData([options, callback])
   ClearStorageDataOptions options;
@@ -619,10 +869,8 @@ mate::Handle<Session> Session::FromPartition(
       brave::BraveBrowserContext::FromPartition(partition, options);
 
   DCHECK(browser_context);
-  // TODO(bridiver) - this is a huge hack to deal with sync call
-  base::ThreadRestrictions::ScopedAllowWait wait_allowed;
-  static_cast<brave::BraveBrowserContext*>(
-      browser_context)->ready()->Wait();
+  if (!static_cast<brave::BraveBrowserContext*>(browser_context)->IsReady())
+    return mate::Handle<Session>();
 
   return CreateFrom(isolate, browser_context);
 }
@@ -633,9 +881,20 @@ void Session::BuildPrototype(v8::Isolate* isolate,
   prototype->SetClassName(mate::StringToV8(isolate, "Session"));
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .MakeDestroyable()
+      .SetMethod("_setListening", &Session::SetListening)
       .SetMethod("resolveProxy", &Session::ResolveProxy)
       .SetMethod("getCacheSize", &Session::DoCacheAction<CacheAction::STATS>)
       .SetMethod("clearCache", &Session::DoCacheAction<CacheAction::CLEAR>)
+      .SetMethod("_getCacheUsage", &Session::GetCacheUsage)
+      .SetMethod("_clearCacheEntries", &Session::ClearCacheEntries)
+      .SetMethod("setDownloadProgressOptions",
+                 &Session::SetDownloadProgressOptions)
+      .SetMethod("setSpareRendererPoolSize",
+                 &Session::SetSpareRendererPoolSize)
+      .SetMethod("getSpareRendererPoolStats",
+                 &Session::GetSpareRendererPoolStats)
+      .SetMethod("setBackgroundTabPolicy", &Session::SetBackgroundTabPolicy)
+      .SetMethod("getBackgroundTabStats", &Session::GetBackgroundTabStats)
       .SetMethod("clearStorageData", &Session::ClearStorageData)
       .SetMethod("clearHistory", &Session::ClearHistory)
       .SetMethod("flushStorageData", &Session::FlushStorageData)
@@ -676,7 +935,49 @@ v8::Local<v8::Value> FromPartition(
   }
   base::DictionaryValue options;
   args->GetNext(&options);
-  return Session::FromPartition(args->isolate(), partition, options).ToV8();
+  auto session = Session::FromPartition(args->isolate(), partition, options);
+  if (session.IsEmpty()) {
+    args->ThrowError("The partition is still loading, use "
+                     "session.fromPartitionAsync");
+    return v8::Null(args->isolate());
+  }
+  return session.ToV8();
+}
+
+void OnPartitionReady(
+    v8::Isolate* isolate,
+    base::WeakPtr<brave::BraveBrowserContext> browser_context,
+    const base::Callback<void(v8::Local<v8::Value>)>& callback) {
+  if (!browser_context)
+    return;
+
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(Session::CreateFrom(isolate, browser_context.get()).ToV8());
+}
+
+// Like FromPartition, but prefs for a new persistent partition are read on
+// the partition's own task runner and |callback| is called once they have
+// loaded, so many partitions can be opened without blocking the UI thread.
+void FromPartitionAsync(
+    const std::string& partition, mate::Arguments* args) {
+  if (!atom::Browser::Get()->is_ready()) {
+    args->ThrowError("Session can only be received when app is ready");
+    return;
+  }
+  base::DictionaryValue options;
+  args->GetNext(&options);
+  base::Callback<void(v8::Local<v8::Value>)> callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError("`callback` must be a function");
+    return;
+  }
+  options.SetBoolean("async", true);
+
+  auto browser_context = static_cast<brave::BraveBrowserContext*>(
+      brave::BraveBrowserContext::FromPartition(partition, options));
+  browser_context->RunWhenReady(base::Bind(&OnPartitionReady,
+      args->isolate(), browser_context->GetWeakPtr(), callback));
 }
 
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
@@ -685,6 +986,7 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   mate::Dictionary dict(isolate, exports);
   dict.Set("Session", Session::GetConstructor(isolate)->GetFunction());
   dict.SetMethod("fromPartition", &FromPartition);
+  dict.SetMethod("fromPartitionAsync", &FromPartitionAsync);
   dict.SetMethod("getAllSessions",
                            &mate::TrackableObject<Session>::GetAll);
 }
@@ -8,8 +8,12 @@
 #include <string>
 
 #include "atom/browser/api/trackable_object.h"
+#include "base/scoped_observer.h"
 #include "base/task/cancelable_task_tracker.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "base/values.h"
+#include "content/public/browser/download_item.h"
 #include "content/public/browser/download_manager.h"
 #include "native_mate/handle.h"
 #include "net/base/completion_callback.h"
@@ -41,7 +45,8 @@ namespace atom {
 namespace api {
 
 class Session: public mate::TrackableObject<Session>,
-               public content::DownloadManager::Observer {
+               public content::DownloadManager::Observer,
+               public content::DownloadItem::Observer {
  public:
   using ResolveProxyCallback = base::Callback<void(std::string)>;
 
@@ -54,7 +59,8 @@ class Session: public mate::TrackableObject<Session>,
   static mate::Handle<Session> CreateFrom(
       v8::Isolate* isolate, content::BrowserContext* browser_context);
 
-  // Gets the Session of |partition|.
+  // Gets the Session of |partition|, or an empty handle when the partition
+  // is still loading after it was opened with fromPartitionAsync.
   static mate::Handle<Session> FromPartition(
       v8::Isolate* isolate, const std::string& partition,
       const base::DictionaryValue& options = base::DictionaryValue());
@@ -69,6 +75,13 @@ class Session: public mate::TrackableObject<Session>,
   void ResolveProxy(const GURL& url, ResolveProxyCallback callback);
   template<CacheAction action>
   void DoCacheAction(const net::CompletionCallback& callback);
+  void GetCacheUsage(mate::Arguments* args);
+  void SetDownloadProgressOptions(const base::DictionaryValue& options);
+  void SetSpareRendererPoolSize(int size);
+  v8::Local<v8::Value> GetSpareRendererPoolStats();
+  void SetBackgroundTabPolicy(mate::Arguments* args);
+  v8::Local<v8::Value> GetBackgroundTabStats();
+  void ClearCacheEntries(mate::Arguments* args);
   void ClearStorageData(mate::Arguments* args);
   void ClearHistory(mate::Arguments* args);
   void FlushStorageData();
@@ -101,8 +114,15 @@ class Session: public mate::TrackableObject<Session>,
   void OnDownloadCreated(content::DownloadManager* manager,
                          content::DownloadItem* item) override;
 
+  // content::DownloadItem::Observer:
+  void OnDownloadUpdated(content::DownloadItem* item) override;
+  void OnDownloadDestroyed(content::DownloadItem* item) override;
+
  private:
   void DefaultDownloadDirectoryChanged();
+  void StartDownloadProgressTimer();
+  // Emits "download-progress" with all the in progress downloads.
+  void EmitDownloadProgress();
 
   // Cached object.
   v8::Global<v8::Value> cookies_;
@@ -123,6 +143,17 @@ class Session: public mate::TrackableObject<Session>,
   Profile* profile_;
   scoped_refptr<net::URLRequestContextGetter> request_context_getter_;
 
+  // Rate of the download progress events.
+  base::TimeDelta download_progress_interval_;
+  int64_t download_progress_min_bytes_;
+  bool aggregate_download_progress_;
+  base::RepeatingTimer download_progress_timer_;
+  // Received bytes reported by the last "download-progress" event.
+  int64_t last_download_progress_bytes_;
+  // Downloads that may go back in progress, which restarts the timer.
+  ScopedObserver<content::DownloadItem, content::DownloadItem::Observer>
+      observed_downloads_;
+
   DISALLOW_COPY_AND_ASSIGN(Session);
 };
 
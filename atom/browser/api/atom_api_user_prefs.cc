@@ -9,9 +9,13 @@
 
 #include "atom/common/native_mate_converters/v8_value_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/memory/ptr_util.h"
+#include "base/strings/string_split.h"
 #include "base/values.h"
 #include "chrome/browser/profiles/profile.h"
 #include "components/pref_registry/pref_registry_syncable.h"
+#include "components/prefs/pref_service.h"
+#include "components/prefs/scoped_user_pref_update.h"
 #include "components/sync_preferences/pref_service_syncable.h"
 #include "content/public/browser/browser_thread.h"
 #include "native_mate/object_template_builder.h"
@@ -46,6 +50,47 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+// Sub paths are split on '.' by base::DictionaryValue, an empty component
+// would address a key nobody can read back.
+bool IsValidSubPath(const std::string& sub_path) {
+  for (const auto& component : base::SplitStringPiece(
+           sub_path, ".", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL)) {
+    if (component.empty())
+      return false;
+  }
+  return true;
+}
+
+// Whether |path| is a registered pref of |type|. The getters and the
+// scoped updates of PrefService expect one and dereference null otherwise.
+bool IsPrefOfType(PrefService* prefs,
+                  const std::string& path,
+                  base::Value::Type type) {
+  const PrefService::Preference* pref = prefs->FindPreference(path);
+  return pref && pref->GetType() == type;
+}
+
+// Setting |sub_path| would replace any value along it that is not a
+// dictionary.
+bool HasDictionariesAlong(const base::DictionaryValue* dict,
+                          const std::string& sub_path) {
+  if (!dict)
+    return true;
+  for (size_t pos = sub_path.find('.'); pos != std::string::npos;
+       pos = sub_path.find('.', pos + 1)) {
+    const base::Value* value = nullptr;
+    if (!dict->Get(sub_path.substr(0, pos), &value))
+      return true;
+    if (!value->is_dict())
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 UserPrefs::UserPrefs(v8::Isolate* isolate,
                  content::BrowserContext* browser_context)
       : browser_context_(browser_context) {
@@ -162,6 +207,129 @@ void UserPrefs::SetDoublePref(const std::string& path,
   profile()->GetPrefs()->SetDouble(path, value);
 }
 
+std::unique_ptr<base::Value> UserPrefs::ValueFromV8(
+    v8::Local<v8::Value> value) {
+  std::unique_ptr<atom::V8ValueConverter>
+      converter(new atom::V8ValueConverter);
+  return std::unique_ptr<base::Value>(
+      converter->FromV8Value(value, isolate()->GetCurrentContext()));
+}
+
+v8::Local<v8::Value> UserPrefs::GetDictionaryPrefPath(
+    const std::string& path, const std::string& sub_path) {
+  if (!IsPrefOfType(profile()->GetPrefs(), path,
+                    base::Value::Type::DICTIONARY))
+    return v8::Null(isolate());
+
+  const base::DictionaryValue* dict =
+      profile()->GetPrefs()->GetDictionary(path);
+  const base::Value* value = nullptr;
+  if (!dict || !dict->Get(sub_path, &value))
+    return v8::Null(isolate());
+
+  std::unique_ptr<atom::V8ValueConverter>
+      converter(new atom::V8ValueConverter);
+  return converter->ToV8Value(value, isolate()->GetCurrentContext());
+}
+
+bool UserPrefs::SetDictionaryPrefPath(const std::string& path,
+    const std::string& sub_path, v8::Local<v8::Value> value) {
+  std::unique_ptr<base::Value> new_value = ValueFromV8(value);
+  if (!new_value || !IsValidSubPath(sub_path) ||
+      !IsPrefOfType(profile()->GetPrefs(), path,
+                    base::Value::Type::DICTIONARY))
+    return false;
+
+  // Don't touch the pref at all when nothing changes so the pref store
+  // doesn't schedule a write and observers aren't notified.
+  const base::DictionaryValue* dict =
+      profile()->GetPrefs()->GetDictionary(path);
+  const base::Value* old_value = nullptr;
+  if (!HasDictionariesAlong(dict, sub_path) ||
+      (dict && dict->Get(sub_path, &old_value) &&
+       old_value->Equals(new_value.get())))
+    return false;
+
+  {
+    DictionaryPrefUpdate update(profile()->GetPrefs(), path);
+    update->Set(sub_path, std::move(new_value));
+  }
+  Emit("pref-changed", path, sub_path);
+  return true;
+}
+
+bool UserPrefs::RemoveDictionaryPrefPath(const std::string& path,
+    const std::string& sub_path) {
+  if (!IsValidSubPath(sub_path) ||
+      !IsPrefOfType(profile()->GetPrefs(), path,
+                    base::Value::Type::DICTIONARY))
+    return false;
+
+  const base::DictionaryValue* dict =
+      profile()->GetPrefs()->GetDictionary(path);
+  const base::Value* old_value = nullptr;
+  if (!dict || !dict->Get(sub_path, &old_value))
+    return false;
+
+  {
+    DictionaryPrefUpdate update(profile()->GetPrefs(), path);
+    update->Remove(sub_path, nullptr);
+  }
+  Emit("pref-changed", path, sub_path);
+  return true;
+}
+
+bool UserPrefs::AppendDictionaryPrefPath(const std::string& path,
+    const std::string& sub_path, v8::Local<v8::Value> value) {
+  std::unique_ptr<base::Value> new_value = ValueFromV8(value);
+  if (!new_value || !IsValidSubPath(sub_path) ||
+      !IsPrefOfType(profile()->GetPrefs(), path,
+                    base::Value::Type::DICTIONARY))
+    return false;
+
+  // Only a missing value is replaced by a new list.
+  const base::DictionaryValue* dict =
+      profile()->GetPrefs()->GetDictionary(path);
+  const base::Value* old_value = nullptr;
+  if (!HasDictionariesAlong(dict, sub_path) ||
+      (dict && dict->Get(sub_path, &old_value) && !old_value->is_list()))
+    return false;
+
+  {
+    DictionaryPrefUpdate update(profile()->GetPrefs(), path);
+    base::ListValue* list = nullptr;
+    if (!update->GetList(sub_path, &list)) {
+      list = new base::ListValue;
+      update->Set(sub_path, base::WrapUnique(list));
+    }
+    list->Append(std::move(new_value));
+  }
+  Emit("pref-changed", path, sub_path);
+  return true;
+}
+
+bool UserPrefs::AppendListPref(const std::string& path,
+    v8::Local<v8::Value> value) {
+  std::unique_ptr<base::Value> new_value = ValueFromV8(value);
+  if (!new_value ||
+      !IsPrefOfType(profile()->GetPrefs(), path, base::Value::Type::LIST))
+    return false;
+
+  {
+    ListPrefUpdate update(profile()->GetPrefs(), path);
+    update->Append(std::move(new_value));
+  }
+  Emit("pref-changed", path);
+  return true;
+}
+
+v8::Local<v8::Value> UserPrefs::GetWriteMetrics() {
+  std::unique_ptr<base::ListValue> metrics =
+      brave::BraveBrowserContext::FromBrowserContext(browser_context_)->
+          GetPrefWriteMetrics();
+  return mate::ConvertToV8(isolate(), *metrics);
+}
+
 double UserPrefs::GetDefaultZoomLevel() {
   return profile()->GetZoomLevelPrefs()->GetDefaultZoomLevelPref();
 }
@@ -208,6 +376,15 @@ void UserPrefs::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setDoublePref", &UserPrefs::SetDoublePref)
       // .SetMethod("setFilePathPref", &UserPrefs::SetFilePathPref)
 
+      .SetMethod("getDictionaryPrefPath", &UserPrefs::GetDictionaryPrefPath)
+      .SetMethod("setDictionaryPrefPath", &UserPrefs::SetDictionaryPrefPath)
+      .SetMethod("removeDictionaryPrefPath",
+                 &UserPrefs::RemoveDictionaryPrefPath)
+      .SetMethod("appendDictionaryPrefPath",
+                 &UserPrefs::AppendDictionaryPrefPath)
+      .SetMethod("appendListPref", &UserPrefs::AppendListPref)
+
+      .SetMethod("getWriteMetrics", &UserPrefs::GetWriteMetrics)
       .SetMethod("getDefaultZoomLevel", &UserPrefs::GetDefaultZoomLevel)
       .SetMethod("setDefaultZoomLevel", &UserPrefs::SetDefaultZoomLevel);
 }
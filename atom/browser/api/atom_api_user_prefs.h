@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_USER_PREFS_H_
 #define ATOM_BROWSER_API_ATOM_API_USER_PREFS_H_
 
+#include <memory>
 #include <string>
 
 #include "atom/browser/api/trackable_object.h"
@@ -15,6 +16,7 @@
 namespace base {
 class DictionaryValue;
 class ListValue;
+class Value;
 }
 
 class Profile;
@@ -64,6 +66,24 @@ class UserPrefs : public mate::TrackableObject<UserPrefs> {
   void SetIntegerPref(const std::string& path, int value);
   void SetDoublePref(const std::string& path, double value);
 
+  // Path based access to dictionary prefs. |sub_path| is a dotted path into
+  // the stored dictionary; the pref is mutated in place so only the changed
+  // key is converted and a single "pref-changed" event is emitted with the
+  // sub path that was touched. Mutations return false for a sub path with an
+  // empty component, and leave values that are not dictionaries along the
+  // path, or not a list for appends, as they are.
+  v8::Local<v8::Value> GetDictionaryPrefPath(const std::string& path,
+                                             const std::string& sub_path);
+  bool SetDictionaryPrefPath(const std::string& path,
+                             const std::string& sub_path,
+                             v8::Local<v8::Value> value);
+  bool RemoveDictionaryPrefPath(const std::string& path,
+                                const std::string& sub_path);
+  bool AppendDictionaryPrefPath(const std::string& path,
+                                const std::string& sub_path,
+                                v8::Local<v8::Value> value);
+  bool AppendListPref(const std::string& path, v8::Local<v8::Value> value);
+
   void SetDefaultStringPref(const std::string& path, const std::string& value);
   void SetDefaultDictionaryPref(const std::string& path,
       const base::DictionaryValue& value);
@@ -73,12 +93,17 @@ class UserPrefs : public mate::TrackableObject<UserPrefs> {
   void SetDefaultIntegerPref(const std::string& path, int value);
   void SetDefaultDoublePref(const std::string& path, double value);
 
+  // Write counters for the pref files backing this session.
+  v8::Local<v8::Value> GetWriteMetrics();
+
   double GetDefaultZoomLevel();
   void SetDefaultZoomLevel(double zoom);
 
   Profile* profile();
 
  private:
+  std::unique_ptr<base::Value> ValueFromV8(v8::Local<v8::Value> value);
+
   content::BrowserContext* browser_context_;  // not owned
 
   DISALLOW_COPY_AND_ASSIGN(UserPrefs);
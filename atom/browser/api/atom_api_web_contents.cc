@@ -2,6 +2,7 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
@@ -11,6 +12,7 @@
 
 #include "atom/browser/api/atom_api_debugger.h"
 #include "atom/browser/api/atom_api_download_item.h"
+#include "atom/browser/api/atom_api_response_headers.h"
 #include "atom/browser/api/atom_api_session.h"
 #include "atom/browser/api/atom_api_web_request.h"
 #include "atom/browser/api/atom_api_window.h"
@@ -23,9 +25,11 @@
 #include "atom/browser/lib/bluetooth_chooser.h"
 #include "atom/browser/native_window.h"
 #include "atom/browser/net/atom_network_delegate.h"
+#include "atom/browser/renderer_channel_subscriptions.h"
 #include "atom/browser/ui/drag_util.h"
 #include "atom/browser/web_contents_permission_helper.h"
 #include "atom/browser/web_contents_preferences.h"
+#include "atom/browser/web_contents_thumbnail_helper.h"
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/event_emitter_caller.h"
 #include "atom/common/color_util.h"
@@ -41,6 +45,8 @@
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/options_switches.h"
+#include "atom/common/startup_timeline.h"
+#include "base/command_line.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/browser/brave_browser_context.h"
@@ -49,6 +55,7 @@
 #include "brave/browser/password_manager/brave_password_manager_client.h"
 #include "brave/browser/plugins/brave_plugin_service_filter.h"
 #include "brave/browser/renderer_preferences_helper.h"
+#include "brave/browser/resource_coordinator/guest_tab_manager.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
 #include "brightray/browser/inspectable_web_contents.h"
 #include "brightray/browser/inspectable_web_contents_view.h"
@@ -374,6 +381,17 @@ struct Converter<content::ServiceWorkerCapability> {
   }
 };
 
+template<>
+struct Converter<scoped_refptr<base::RefCountedBytes>> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate, scoped_refptr<base::RefCountedBytes> val) {
+    if (!val)
+      return v8::Null(isolate);
+    return node::Buffer::Copy(isolate, val->front_as<char>(), val->size())
+        .ToLocalChecked();
+  }
+};
+
 }  // namespace mate
 
 
@@ -485,6 +503,9 @@ WebContents::WebContents(v8::Isolate* isolate, const mate::Dictionary& options)
       guest_delegate_(nullptr),
       weak_ptr_factory_(this) {
   mate::Handle<api::Session> session = SessionFromOptions(isolate, options);
+  // Callers check IsSessionReady() and throw for a partition that is still
+  // loading, there is no browser context to create the WebContents in yet.
+  CHECK(!session.IsEmpty());
 
   content::WebContents::CreateParams create_params(session->browser_context());
   CreateWebContents(isolate, options, create_params);
@@ -534,6 +555,7 @@ void WebContents::CompleteInit(v8::Isolate* isolate,
     content::WebContents *web_contents,
     const mate::Dictionary& options) {
   Observe(web_contents);
+  StartupTimeline::GetInstance()->Mark("FirstWebContentsCreated");
 
   InitWithWebContents(web_contents, GetBrowserContext());
   managed_web_contents()->GetView()->SetDelegate(this);
@@ -1003,12 +1025,12 @@ void WebContents::UpdateTargetURL(content::WebContents* source,
   const gfx::Rect& bounds = web_contents()->GetContainerBounds();
   int x = location.x() - bounds.x();
   int y = location.y() - bounds.y();
-  Emit("update-target-url", url, x, y);
+  EmitCoalesced("update-target-url", url, x, y);
 }
 
 void WebContents::LoadProgressChanged(content::WebContents* source,
                                    double progress) {
-  Emit("load-progress-changed", progress);
+  EmitCoalesced("load-progress-changed", progress);
 }
 
 bool WebContents::IsPopupOrPanel(const content::WebContents* source) const {
@@ -1329,7 +1351,7 @@ void WebContents::DidChangeThemeColor(SkColor theme_color) {
     SkColorGetR(theme_color),
     SkColorGetG(theme_color),
     SkColorGetB(theme_color));
-  Emit("did-change-theme-color", hex_theme_color);
+  EmitCoalesced("did-change-theme-color", hex_theme_color);
 }
 
 void WebContents::RenderViewCreated(content::RenderViewHost* render_view_host) {
@@ -1368,7 +1390,23 @@ void WebContents::DidFailLoad(content::RenderFrameHost* render_frame_host,
 
 void WebContents::DidGetResourceResponseStart(
     const content::ResourceRequestDetails& details) {
-  const net::HttpResponseHeaders* headers = details.headers.get();
+  if (!HasListeners("did-get-response-details"))
+    return;
+
+  const char* resource_type = ResourceTypeToString(details.resource_type);
+  if (!response_details_types_.empty() &&
+      !response_details_types_.count(resource_type))
+    return;
+  if (!response_details_urls_.empty() &&
+      std::none_of(response_details_urls_.begin(),
+                   response_details_urls_.end(),
+                   [&details](const URLPattern& pattern) {
+                     return pattern.MatchesURL(details.url);
+                   }))
+    return;
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
   Emit("did-get-response-details",
        details.socket_address.IsEmpty(),
        details.url,
@@ -1376,8 +1414,8 @@ void WebContents::DidGetResourceResponseStart(
        details.http_response_code,
        details.method,
        details.referrer,
-       headers,
-       ResourceTypeToString(details.resource_type));
+       ResponseHeaders::Create(isolate(), details.headers),
+       resource_type);
 }
 
 void WebContents::DidStartLoading() {
@@ -1385,9 +1423,22 @@ void WebContents::DidStartLoading() {
 }
 
 void WebContents::DidStopLoading() {
+  // Deliver the final progress and title before the load is reported done.
+  event_coalescer_.Flush();
   Emit("did-stop-loading");
 }
 
+void WebContents::DidFirstVisuallyNonEmptyPaint() {
+  if (!StartupTimeline::GetInstance()->Mark("FirstPaint"))
+    return;
+
+  base::FilePath trace_path =
+      base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+          switches::kStartupTraceFile);
+  if (!trace_path.empty())
+    StartupTimeline::GetInstance()->WriteTrace(trace_path);
+}
+
 void WebContents::DidStartNavigation(
     content::NavigationHandle* navigation_handle) {
   Emit("did-start-navigation", navigation_handle);
@@ -1405,6 +1456,7 @@ void WebContents::DidStartNavigation(
 
 void WebContents::DidFinishNavigation(
     content::NavigationHandle* navigation_handle) {
+  event_coalescer_.Flush();
   Emit("did-finish-navigation", navigation_handle);
 
   // deprecated event handling
@@ -1446,10 +1498,11 @@ void WebContents::TitleWasSet(content::NavigationEntry* entry) {
   if (entry) {
     bool title_is_synthesized =
         entry->GetURL().SchemeIsFile() && entry->GetTitle().empty();
-    Emit("page-title-updated", entry->GetTitle(), !title_is_synthesized);
+    EmitCoalesced("page-title-updated", entry->GetTitle(),
+                  !title_is_synthesized);
   } else {
     bool explicit_set = true;
-    Emit("page-title-updated", "", explicit_set);
+    EmitCoalesced("page-title-updated", std::string(), explicit_set);
   }
 }
 
@@ -1590,6 +1643,7 @@ void WebContents::WebContentsDestroyed() {
   CommonWebContentsDelegate::DestroyWebContents();
 
   memory_pressure_listener_.reset();
+  event_coalescer_.Cancel();
 
   // This event is only for internal use, which is emitted when WebContents is
   // being destroyed.
@@ -2331,6 +2385,11 @@ bool WebContents::SendIPCMessage(int render_process_id,
   if (!rfh)
     return false;
 
+  // No script context in the renderer would receive it.
+  if (!RendererChannelSubscriptions::GetInstance()->IsSubscribed(
+          render_process_id, channel))
+    return true;
+
   return rfh->Send(new AtomViewMsg_Message(rfh->GetRoutingID(), channel, args));
 }
 
@@ -2440,6 +2499,128 @@ void WebContents::CapturePage(mate::Arguments* args) {
       kBGRA_8888_SkColorType);
 }
 
+void WebContents::CaptureThumbnail(mate::Arguments* args) {
+  mate::Dictionary options;
+  WebContentsThumbnailHelper::ThumbnailCallback callback;
+  if (!args->GetNext(&options) || !args->GetNext(&callback)) {
+    args->ThrowError("`options` and `callback` are required");
+    return;
+  }
+
+  WebContentsThumbnailHelper::Params params;
+  int width = 0, height = 0;
+  if (!options.Get("width", &width) || !options.Get("height", &height) ||
+      width <= 0 || height <= 0) {
+    args->ThrowError("`width` and `height` must be positive integers");
+    return;
+  }
+  params.size = gfx::Size(width, height);
+  options.Get("format", &params.format);
+  if (params.format != "jpeg" && params.format != "png") {
+    args->ThrowError("`format` must be 'jpeg' or 'png'");
+    return;
+  }
+  if (params.format == "jpeg") {
+    options.Get("quality", &params.quality);
+    params.quality = std::min(std::max(params.quality, 0), 100);
+  } else {
+    params.quality = 0;
+  }
+
+  WebContentsThumbnailHelper::CreateForWebContents(web_contents());
+  WebContentsThumbnailHelper::FromWebContents(web_contents())
+      ->CaptureThumbnail(params, callback);
+}
+
+void WebContents::SetThumbnailCaptureInterval(mate::Arguments* args) {
+  int interval = 0;
+  if (!args->GetNext(&interval) || interval < 0) {
+    args->ThrowError("`interval` must be a non-negative integer");
+    return;
+  }
+
+  WebContentsThumbnailHelper::CreateForWebContents(web_contents());
+  WebContentsThumbnailHelper::FromWebContents(web_contents())
+      ->SetCaptureInterval(base::TimeDelta::FromMilliseconds(interval));
+}
+
+void WebContents::SetResponseDetailsFilter(mate::Arguments* args) {
+  std::set<std::string> types;
+  std::set<URLPattern> patterns;
+  mate::Dictionary filter;
+  if (args->GetNext(&filter)) {
+    std::vector<std::string> values;
+    if (filter.Get("resourceTypes", &values))
+      types.insert(values.begin(), values.end());
+    values.clear();
+    if (filter.Get("urls", &values)) {
+      for (const auto& value : values) {
+        URLPattern pattern(URLPattern::SCHEME_ALL);
+        if (pattern.Parse(value) != URLPattern::PARSE_SUCCESS) {
+          args->ThrowError("Invalid url pattern " + value);
+          return;
+        }
+        patterns.insert(pattern);
+      }
+    }
+  }
+  response_details_types_.swap(types);
+  response_details_urls_.swap(patterns);
+}
+
+void WebContents::SetEventCoalescing(mate::Arguments* args) {
+  mate::Dictionary options;
+  if (!args->GetNext(&options)) {
+    args->ThrowError("`options` must be an object");
+    return;
+  }
+
+  int interval = 0;
+  if (options.Get("interval", &interval)) {
+    if (interval < 0) {
+      args->ThrowError("`interval` must not be negative");
+      return;
+    }
+    event_coalescer_.SetInterval(base::TimeDelta::FromMilliseconds(interval));
+  }
+
+  base::DictionaryValue events;
+  if (options.Get("events", &events)) {
+    for (base::DictionaryValue::Iterator it(events); !it.IsAtEnd();
+         it.Advance()) {
+      bool enabled = false;
+      if (it.value().GetAsBoolean(&enabled))
+        event_coalescer_.SetEnabled(it.key(), enabled);
+    }
+  }
+}
+
+v8::Local<v8::Value> WebContents::GetEventCoalescingStats(
+    v8::Isolate* isolate) {
+  mate::Dictionary events = mate::Dictionary::CreateEmpty(isolate);
+  for (const auto& entry : event_coalescer_.stats()) {
+    mate::Dictionary stats = mate::Dictionary::CreateEmpty(isolate);
+    stats.Set("coalesced", event_coalescer_.IsEnabled(entry.first));
+    stats.Set("emitted", static_cast<double>(entry.second.emitted));
+    stats.Set("dropped", static_cast<double>(entry.second.dropped));
+    events.Set(entry.first, stats);
+  }
+  for (const auto& name : event_coalescer_.enabled()) {
+    if (event_coalescer_.stats().count(name))
+      continue;
+    mate::Dictionary stats = mate::Dictionary::CreateEmpty(isolate);
+    stats.Set("coalesced", true);
+    stats.Set("emitted", 0);
+    stats.Set("dropped", 0);
+    events.Set(name, stats);
+  }
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("interval", event_coalescer_.interval().InMilliseconds());
+  dict.Set("events", events);
+  return dict.GetHandle();
+}
+
 void WebContents::GetPreferredSize(mate::Arguments* args) {
   base::Callback<void(gfx::Size)> callback;
   if (!args->GetNext(&callback)) {
@@ -2454,13 +2635,13 @@ void WebContents::OnCursorChange(const content::WebCursor& cursor) {
   cursor.GetCursorInfo(&info);
 
   if (cursor.IsCustom()) {
-    Emit("cursor-changed", CursorTypeToString(info),
+    EmitCoalesced("cursor-changed", CursorTypeToString(info),
       gfx::Image::CreateFrom1xBitmap(info.custom_image),
       info.image_scale_factor,
       gfx::Size(info.custom_image.width(), info.custom_image.height()),
       info.hotspot);
   } else {
-    Emit("cursor-changed", CursorTypeToString(info));
+    EmitCoalesced("cursor-changed", CursorTypeToString(info));
   }
 }
 
@@ -2679,6 +2860,15 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
                  &WebContents::ShowDefinitionForSelection)
       .SetMethod("copyImageAt", &WebContents::CopyImageAt)
       .SetMethod("capturePage", &WebContents::CapturePage)
+      .SetMethod("captureThumbnail", &WebContents::CaptureThumbnail)
+      .SetMethod("setThumbnailCaptureInterval",
+                 &WebContents::SetThumbnailCaptureInterval)
+      .SetMethod("_setListening", &WebContents::SetListening)
+      .SetMethod("setResponseDetailsFilter",
+                 &WebContents::SetResponseDetailsFilter)
+      .SetMethod("setEventCoalescing", &WebContents::SetEventCoalescing)
+      .SetMethod("getEventCoalescingStats",
+                 &WebContents::GetEventCoalescingStats)
       .SetMethod("getPreferredSize", &WebContents::GetPreferredSize)
       .SetProperty("id", &WebContents::ID)
       .SetProperty("attached", &WebContents::IsAttached)
@@ -2814,8 +3004,14 @@ void WebContents::OnTabCreated(const mate::Dictionary& options,
   int opener_tab_id = TabStripModel::kNoTab;
     options.Get("openerTabId", &opener_tab_id);
 
+  // Lazily loaded tabs start out discarded and are loaded by the restore
+  // loader when their turn comes.
+  bool lazy_load = false;
+  options.Get("lazyLoad", &lazy_load);
+
   bool discarded = false;
-  if (options.Get("discarded", &discarded) && discarded && !active) {
+  options.Get("discarded", &discarded);
+  if ((discarded || lazy_load) && !active) {
     std::string url;
     if (options.Get("url", &url)) {
       std::unique_ptr<content::NavigationEntryImpl> entry =
@@ -2848,11 +3044,13 @@ void WebContents::OnTabCreated(const mate::Dictionary& options,
 
   int window_id = -1;
   ::Browser *browser = nullptr;
+  NativeWindow* window = owner_window();
   if (options.Get("windowId", &window_id) && window_id != -1) {
     auto api_window =
         mate::TrackableObject<Window>::FromWeakMapID(isolate(), window_id);
     if (api_window) {
-      browser = api_window->window()->browser();
+      window = api_window->window();
+      browser = window->browser();
       tab_helper->SetWindowId(window_id);
     }
   }
@@ -2881,10 +3079,28 @@ void WebContents::OnTabCreated(const mate::Dictionary& options,
                     user_gesture,
                     &was_blocked);
 
-  if (was_blocked)
+  if (was_blocked) {
     callback.Run(nullptr);
-  else
-    callback.Run(tab);
+    return;
+  }
+
+  if (lazy_load) {
+    auto tab_manager = static_cast<resource_coordinator::GuestTabManager*>(
+        g_browser_process->GetTabManager());
+    if (tab_manager) {
+      // An active tab is not discarded and is already loading, so it only
+      // holds a load slot.
+      auto priority =
+          resource_coordinator::GuestTabRestoreLoader::Priority::kBackground;
+      if (active ||
+          (window && window->IsVisible() && !window->IsMinimized()))
+        priority = resource_coordinator::GuestTabRestoreLoader::Priority::
+            kVisibleWindow;
+      tab_manager->restore_loader()->AddTab(tab, priority);
+    }
+  }
+
+  callback.Run(tab);
 }
 
 // static
@@ -2975,6 +3191,12 @@ mate::Handle<WebContents> WebContents::Create(
       new WebContents(isolate, options));
 }
 
+// static
+bool WebContents::IsSessionReady(
+    v8::Isolate* isolate, const mate::Dictionary& options) {
+  return !SessionFromOptions(isolate, options).IsEmpty();
+}
+
 // static
 mate::Handle<WebContents> WebContents::CreateWithParams(
     v8::Isolate* isolate,
@@ -2992,17 +3214,90 @@ namespace {
 
 using atom::api::WebContents;
 
+void SetThumbnailCacheLimits(const base::DictionaryValue& limits) {
+  int min_capture_interval;
+  if (limits.GetInteger("minCaptureInterval", &min_capture_interval))
+    atom::WebContentsThumbnailHelper::SetMinCaptureInterval(
+        base::TimeDelta::FromMilliseconds(std::max(min_capture_interval, 0)));
+  double max_size;
+  if (limits.GetDouble("maxSize", &max_size))
+    atom::WebContentsThumbnailHelper::SetMaxCacheSize(
+        static_cast<size_t>(std::max(max_size, 0.0)));
+}
+
+std::unique_ptr<base::DictionaryValue> GetThumbnailCacheStats() {
+  return atom::WebContentsThumbnailHelper::GetStats();
+}
+
+resource_coordinator::GuestTabDiscardPolicy* GetTabDiscardPolicy() {
+  auto tab_manager = g_browser_process->GetTabManager();
+  if (!tab_manager)
+    return nullptr;
+  return static_cast<resource_coordinator::GuestTabManager*>(tab_manager)
+      ->discard_policy();
+}
+
+resource_coordinator::GuestTabRestoreLoader* GetTabRestoreLoader() {
+  auto tab_manager = g_browser_process->GetTabManager();
+  if (!tab_manager)
+    return nullptr;
+  return static_cast<resource_coordinator::GuestTabManager*>(tab_manager)
+      ->restore_loader();
+}
+
+void SetTabRestoreOptions(const base::DictionaryValue& options) {
+  auto loader = GetTabRestoreLoader();
+  if (loader)
+    loader->SetOptions(options);
+}
+
+v8::Local<v8::Value> GetTabRestoreStats(v8::Isolate* isolate) {
+  auto loader = GetTabRestoreLoader();
+  if (!loader)
+    return v8::Null(isolate);
+  return mate::ConvertToV8(isolate, *loader->GetStats());
+}
+
+void SetTabDiscardPolicy(const base::DictionaryValue& options) {
+  auto policy = GetTabDiscardPolicy();
+  if (policy)
+    policy->SetOptions(options);
+}
+
+v8::Local<v8::Value> GetTabDiscardStats(v8::Isolate* isolate) {
+  auto policy = GetTabDiscardPolicy();
+  if (!policy)
+    return v8::Null(isolate);
+  return mate::ConvertToV8(isolate, *policy->GetStats());
+}
+
+v8::Local<v8::Value> Create(const mate::Dictionary& options,
+                            mate::Arguments* args) {
+  if (!WebContents::IsSessionReady(args->isolate(), options)) {
+    args->ThrowError("The partition is still loading, use "
+                     "session.fromPartitionAsync");
+    return v8::Null(args->isolate());
+  }
+  return WebContents::Create(args->isolate(), options).ToV8();
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   v8::Isolate* isolate = context->GetIsolate();
   mate::Dictionary dict(isolate, exports);
   dict.Set("WebContents", WebContents::GetConstructor(isolate)->GetFunction());
-  dict.SetMethod("create", &WebContents::Create);
+  dict.SetMethod("create", &Create);
   dict.SetMethod("createTab", &WebContents::CreateTab);
   dict.SetMethod("fromTabID", &WebContents::FromTabID);
   dict.SetMethod("fromId", &mate::TrackableObject<WebContents>::FromWeakMapID);
   dict.SetMethod("getAllWebContents",
                  &mate::TrackableObject<WebContents>::GetAll);
+  dict.SetMethod("setThumbnailCacheLimits", &SetThumbnailCacheLimits);
+  dict.SetMethod("getThumbnailCacheStats", &GetThumbnailCacheStats);
+  dict.SetMethod("setTabDiscardPolicy", &SetTabDiscardPolicy);
+  dict.SetMethod("getTabDiscardStats", &GetTabDiscardStats);
+  dict.SetMethod("setTabRestoreOptions", &SetTabRestoreOptions);
+  dict.SetMethod("getTabRestoreStats", &GetTabRestoreStats);
 }
 
 }  // namespace
@@ -6,9 +6,11 @@
 #define ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
+#include "atom/browser/api/event_coalescer.h"
 #include "atom/browser/api/save_page_handler.h"
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/common_web_contents_delegate.h"
@@ -22,6 +24,7 @@
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/common/context_menu_params.h"
 #include "content/public/common/favicon_url.h"
+#include "extensions/common/url_pattern.h"
 #include "extensions/features/features.h"
 #include "ipc/ipc_sender.h"
 #include "native_mate/handle.h"
@@ -131,6 +134,11 @@ class WebContents : public mate::TrackableObject<WebContents>,
   static mate::Handle<WebContents> Create(
       v8::Isolate* isolate, const mate::Dictionary& options);
 
+  // Whether the session of |options| has loaded, a WebContents can't be
+  // created in a partition that is still loading.
+  static bool IsSessionReady(
+      v8::Isolate* isolate, const mate::Dictionary& options);
+
   static mate::Handle<WebContents> CreateWithParams(
       v8::Isolate* isolate,
       const mate::Dictionary& options,
@@ -273,6 +281,18 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // done.
   void CapturePage(mate::Arguments* args);
 
+  // Captures a cached, downscaled and encoded snapshot of the page.
+  void CaptureThumbnail(mate::Arguments* args);
+  void SetThumbnailCaptureInterval(mate::Arguments* args);
+
+  // did-get-response-details is only emitted while it has listeners, and only
+  // for responses that match the filter.
+  void SetResponseDetailsFilter(mate::Arguments* args);
+
+  // Configures which state events are coalesced and how often they flush.
+  void SetEventCoalescing(mate::Arguments* args);
+  v8::Local<v8::Value> GetEventCoalescingStats(v8::Isolate* isolate);
+
   void EnablePreferredSizeMode(bool enable);
   void GetPreferredSize(mate::Arguments* args);
 
@@ -478,6 +498,7 @@ class WebContents : public mate::TrackableObject<WebContents>,
       const content::ResourceRequestDetails& details) override;
   void DidStartLoading() override;
   void DidStopLoading() override;
+  void DidFirstVisuallyNonEmptyPaint() override;
   void DidStartNavigation(
       content::NavigationHandle* navigation_handle) override;
   void DidFinishNavigation(
@@ -553,6 +574,23 @@ class WebContents : public mate::TrackableObject<WebContents>,
                                const base::string16& channel,
                                const base::SharedMemoryHandle& shared_memory);
 
+  // Emits |name| through the coalescer, so a later value posted within the
+  // same interval replaces this one when coalescing is enabled for |name|.
+  template<typename... Args>
+  void EmitCoalesced(const std::string& name, const Args&... args) {
+    if (!HasListeners(name))
+      return;
+    event_coalescer_.Post(name,
+                          base::Bind(&WebContents::EmitNow<Args...>,
+                                     weak_ptr_factory_.GetWeakPtr(),
+                                     name, args...));
+  }
+
+  template<typename... Args>
+  void EmitNow(const std::string& name, const Args&... args) {
+    Emit(name, args...);
+  }
+
   v8::Global<v8::Value> session_;
   v8::Global<v8::Value> devtools_web_contents_;
   v8::Global<v8::Value> debugger_;
@@ -573,9 +611,17 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // the context menu params for the current context menu;
   content::ContextMenuParams context_menu_params_;
 
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  // Resource types and URL patterns that did-get-response-details is limited
+  // to, empty means no restriction.
+  std::set<std::string> response_details_types_;
+  std::set<URLPattern> response_details_urls_;
+
+  EventCoalescer event_coalescer_;
+
   base::WeakPtrFactory<WebContents> weak_ptr_factory_;
 
-  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
   DISALLOW_COPY_AND_ASSIGN(WebContents);
 };
 
@@ -318,6 +318,15 @@ mate::WrappableBase* Window::New(mate::Arguments* args) {
     options = mate::Dictionary::CreateEmpty(args->isolate());
   }
 
+  mate::Dictionary web_preferences =
+      mate::Dictionary::CreateEmpty(args->isolate());
+  options.Get(options::kWebPreferences, &web_preferences);
+  if (!WebContents::IsSessionReady(args->isolate(), web_preferences)) {
+    args->ThrowError("The partition is still loading, use "
+                     "session.fromPartitionAsync");
+    return nullptr;
+  }
+
   return new Window(args->isolate(), args->GetThis(), options);
 }
 
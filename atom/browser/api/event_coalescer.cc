@@ -0,0 +1,97 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/event_coalescer.h"
+
+#include "base/bind.h"
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+// One frame at 60Hz.
+const int kDefaultIntervalMs = 16;
+
+}  // namespace
+
+EventCoalescer::EventCoalescer()
+    : interval_(base::TimeDelta::FromMilliseconds(kDefaultIntervalMs)) {
+}
+
+EventCoalescer::~EventCoalescer() {
+}
+
+void EventCoalescer::SetInterval(base::TimeDelta interval) {
+  interval_ = interval;
+  if (interval_.is_zero())
+    Flush();
+}
+
+void EventCoalescer::SetEnabled(const std::string& name, bool enabled) {
+  if (enabled) {
+    enabled_.insert(name);
+    return;
+  }
+
+  enabled_.erase(name);
+  for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+    if (it->name == name) {
+      base::Closure emit = it->emit;
+      pending_.erase(it);
+      stats_[name].emitted++;
+      emit.Run();
+      break;
+    }
+  }
+}
+
+bool EventCoalescer::IsEnabled(const std::string& name) const {
+  return enabled_.count(name) > 0;
+}
+
+void EventCoalescer::Post(const std::string& name,
+                          const base::Closure& emit) {
+  Stats& stats = stats_[name];
+  if (interval_.is_zero() || !IsEnabled(name)) {
+    stats.emitted++;
+    emit.Run();
+    return;
+  }
+
+  for (auto& pending : pending_) {
+    if (pending.name == name) {
+      pending.emit = emit;
+      stats.dropped++;
+      return;
+    }
+  }
+
+  pending_.push_back({name, emit});
+  if (!timer_.IsRunning()) {
+    timer_.Start(FROM_HERE, interval_,
+                 base::Bind(&EventCoalescer::Flush, base::Unretained(this)));
+  }
+}
+
+void EventCoalescer::Flush() {
+  timer_.Stop();
+  // Emitting can post again, so run from a copy.
+  std::vector<PendingEvent> pending;
+  pending.swap(pending_);
+  for (const auto& event : pending) {
+    stats_[event.name].emitted++;
+    event.emit.Run();
+  }
+}
+
+void EventCoalescer::Cancel() {
+  timer_.Stop();
+  pending_.clear();
+}
+
+}  // namespace api
+
+}  // namespace atom
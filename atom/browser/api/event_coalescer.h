@@ -0,0 +1,76 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_EVENT_COALESCER_H_
+#define ATOM_BROWSER_API_EVENT_COALESCER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace atom {
+
+namespace api {
+
+// Collapses state events that supersede each other, e.g. load progress or the
+// hovered link, so that only the last value posted for an event name within a
+// frame interval reaches JS. Events that are not enabled run immediately.
+class EventCoalescer {
+ public:
+  struct Stats {
+    Stats() : emitted(0), dropped(0) {}
+    uint64_t emitted;
+    uint64_t dropped;
+  };
+
+  EventCoalescer();
+  ~EventCoalescer();
+
+  void SetInterval(base::TimeDelta interval);
+  base::TimeDelta interval() const { return interval_; }
+
+  void SetEnabled(const std::string& name, bool enabled);
+  bool IsEnabled(const std::string& name) const;
+  const std::set<std::string>& enabled() const { return enabled_; }
+
+  // Runs |emit| now when |name| is not coalesced, otherwise replaces any
+  // pending emit for |name| and schedules a flush.
+  void Post(const std::string& name, const base::Closure& emit);
+
+  // Runs the pending emits in the order their names were first posted.
+  void Flush();
+
+  // Drops the pending emits without running them.
+  void Cancel();
+
+  const std::map<std::string, Stats>& stats() const { return stats_; }
+
+ private:
+  struct PendingEvent {
+    std::string name;
+    base::Closure emit;
+  };
+
+  base::TimeDelta interval_;
+  std::set<std::string> enabled_;
+  std::vector<PendingEvent> pending_;
+  std::map<std::string, Stats> stats_;
+  base::OneShotTimer timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(EventCoalescer);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_EVENT_COALESCER_H_
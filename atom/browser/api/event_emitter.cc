@@ -4,10 +4,15 @@
 
 #include "atom/browser/api/event_emitter.h"
 
+#include <map>
+#include <string>
+#include <utility>
+
 #include "atom/browser/api/atom_api_web_contents.h"
 #include "atom/browser/api/event.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/lazy_instance.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
@@ -26,6 +31,12 @@ namespace {
 
 v8::Persistent<v8::ObjectTemplate> event_template;
 
+// Bit index of every event name that has had listeners. Only used on the
+// main thread.
+using EventNameIndex = std::map<std::string, size_t, std::less<>>;
+base::LazyInstance<EventNameIndex>::Leaky g_event_name_index =
+    LAZY_INSTANCE_INITIALIZER;
+
 void PreventDefault(mate::Arguments* args) {
   mate::Dictionary self(args->isolate(), args->GetThis());
   self.Set("defaultPrevented", true);
@@ -109,4 +120,48 @@ v8::Local<v8::Object> CreateEventFromFlags(v8::Isolate* isolate, int flags) {
 
 }  // namespace internal
 
+EventListeners::EventListeners() : tracking_(false) {
+}
+
+EventListeners::~EventListeners() {
+}
+
+bool EventListeners::Has(const base::StringPiece& name) const {
+  // Unhandled errors throw in JS, which callers may rely on.
+  if (!tracking_ || name == "error")
+    return true;
+
+  const EventNameIndex& index = g_event_name_index.Get();
+  auto it = index.find(name);
+  if (it == index.end())
+    return false;
+
+  size_t word = it->second / 64;
+  return word < bits_.size() && (bits_[word] >> (it->second % 64)) & 1;
+}
+
+void EventListeners::Set(const std::string& name, bool listening) {
+  tracking_ = true;
+
+  EventNameIndex& index = g_event_name_index.Get();
+  auto it = index.find(name);
+  if (it == index.end()) {
+    if (!listening)
+      return;
+    it = index.insert(std::make_pair(name, index.size())).first;
+  }
+
+  size_t word = it->second / 64;
+  uint64_t bit = static_cast<uint64_t>(1) << (it->second % 64);
+  if (word >= bits_.size()) {
+    if (!listening)
+      return;
+    bits_.resize(word + 1);
+  }
+  if (listening)
+    bits_[word] |= bit;
+  else
+    bits_[word] &= ~bit;
+}
+
 }  // namespace mate
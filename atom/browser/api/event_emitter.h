@@ -5,9 +5,14 @@
 #ifndef ATOM_BROWSER_API_EVENT_EMITTER_H_
 #define ATOM_BROWSER_API_EVENT_EMITTER_H_
 
+#include <stdint.h>
+
+#include <string>
 #include <vector>
 
 #include "atom/common/api/event_emitter_caller.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
 #include "native_mate/wrappable.h"
 
 namespace content {
@@ -34,6 +39,24 @@ v8::Local<v8::Object> CreateEventFromFlags(v8::Isolate* isolate, int flags);
 
 }  // namespace internal
 
+// Which events of an emitter have listeners, as a bitmap indexed by a process
+// wide table of event names. Until the JS side starts reporting listeners,
+// every event is assumed to have some.
+class EventListeners {
+ public:
+  EventListeners();
+  ~EventListeners();
+
+  bool Has(const base::StringPiece& name) const;
+  void Set(const std::string& name, bool listening);
+
+ private:
+  bool tracking_;
+  std::vector<uint64_t> bits_;
+
+  DISALLOW_COPY_AND_ASSIGN(EventListeners);
+};
+
 // Provide helperers to emit event in JavaScript.
 template<typename T>
 class EventEmitter : public Wrappable<T> {
@@ -45,11 +68,24 @@ class EventEmitter : public Wrappable<T> {
   v8::Local<v8::Object> GetWrapper() { return Wrappable<T>::GetWrapper(); }
   v8::Isolate* isolate() const { return Wrappable<T>::isolate(); }
 
+  // Whether |name| may have listeners. Events without listeners are not
+  // emitted, so callers only need this to skip building costly arguments.
+  bool HasListeners(const base::StringPiece& name) const {
+    return listeners_.Has(name);
+  }
+
+  // Called from JS, see lib/browser/listener-tracking.js.
+  void SetListening(const std::string& name, bool listening) {
+    listeners_.Set(name, listening);
+  }
+
   // this.emit(name, event, args...);
   template<typename... Args>
   bool EmitCustomEvent(const base::StringPiece& name,
                        v8::Local<v8::Object> event,
                        const Args&... args) {
+    if (!HasListeners(name))
+      return false;
     return EmitWithEvent(
         name,
         internal::CreateCustomEvent(isolate(), GetWrapper(), event), args...);
@@ -60,6 +96,8 @@ class EventEmitter : public Wrappable<T> {
   bool EmitWithFlags(const base::StringPiece& name,
                      int flags,
                      const Args&... args) {
+    if (!HasListeners(name))
+      return false;
     return EmitCustomEvent(
         name,
         internal::CreateEventFromFlags(isolate(), flags), args...);
@@ -77,6 +115,9 @@ class EventEmitter : public Wrappable<T> {
                       content::RenderFrameHost* sender,
                       IPC::Message* message,
                       const Args&... args) {
+    // A synchronous message is answered through its event.
+    if (!message && !HasListeners(name))
+      return false;
     v8::Locker locker(isolate());
     v8::HandleScope handle_scope(isolate());
     v8::Local<v8::Object> wrapper = GetWrapper();
@@ -103,6 +144,8 @@ class EventEmitter : public Wrappable<T> {
         StringToV8(isolate(), "defaultPrevented"))->BooleanValue();
   }
 
+  EventListeners listeners_;
+
   DISALLOW_COPY_AND_ASSIGN(EventEmitter);
 };
 
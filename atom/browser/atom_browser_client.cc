@@ -14,6 +14,7 @@
 #include "atom/browser/atom_resource_dispatcher_host_delegate.h"
 #include "atom/browser/atom_speech_recognition_manager_delegate.h"
 #include "atom/browser/native_window.h"
+#include "atom/browser/renderer_channel_subscriptions.h"
 #include "atom/browser/web_contents_permission_helper.h"
 #include "atom/browser/web_contents_preferences.h"
 #include "atom/browser/window_list.h"
@@ -252,6 +253,7 @@ void AtomBrowserClient::WebNotificationAllowed(
 void AtomBrowserClient::RenderProcessHostDestroyed(
     content::RenderProcessHost* host) {
   int process_id = host->GetID();
+  RendererChannelSubscriptions::GetInstance()->RemoveProcess(process_id);
   for (const auto& entry : pending_processes_) {
     if (entry.first == process_id || entry.second == process_id) {
       pending_processes_.erase(entry.first);
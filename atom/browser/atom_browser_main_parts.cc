@@ -14,8 +14,13 @@
 #include "atom/browser/browser_context_keyed_service_factories.h"
 #include "atom/browser/javascript_environment.h"
 #include "atom/common/api/atom_bindings.h"
+#include "atom/common/api/native_image_cache.h"
+#include "atom/common/asar/asar_util.h"
+#include "atom/common/code_cache.h"
 #include "atom/common/node_bindings.h"
 #include "atom/common/node_includes.h"
+#include "atom/common/options_switches.h"
+#include "atom/common/startup_timeline.h"
 #include "base/allocator/allocator_extension.h"
 #include "base/base_switches.h"
 #include "base/command_line.h"
@@ -24,6 +29,7 @@
 #include "base/memory/memory_pressure_monitor.h"
 #include "base/path_service.h"
 #include "base/profiler/stack_sampling_profiler.h"
+#include "base/task_scheduler/post_task.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/time/default_tick_clock.h"
 #include "base/trace_event/trace_event.h"
@@ -107,6 +113,21 @@ void InitializeWindowProcExceptions() {
 }
 #endif  // defined (OS_WIN)
 
+void ClearNativeImageCache(MemoryCoordinator::Level level,
+                           const MemoryCoordinator::DoneCallback& done) {
+  done.Run(api::NativeImageCache::GetInstance()->Clear());
+}
+
+void ClearAsarExtractedFiles(MemoryCoordinator::Level level,
+                             const MemoryCoordinator::DoneCallback& done) {
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::Bind(&asar::ClearExtractedFiles),
+      done);
+}
+
 }  // namespace
 
 template<typename T>
@@ -166,6 +187,7 @@ base::Closure AtomBrowserMainParts::RegisterDestructionCallback(
 }
 
 void AtomBrowserMainParts::PreEarlyInitialization() {
+  StartupTimeline::ScopedPhase phase("PreEarlyInitialization");
   brightray::BrowserMainParts::PreEarlyInitialization();
 #if defined(OS_POSIX)
   HandleSIGCHLD();
@@ -174,6 +196,7 @@ void AtomBrowserMainParts::PreEarlyInitialization() {
 
 int AtomBrowserMainParts::PreCreateThreads() {
   TRACE_EVENT0("startup", "AtomBrowserMainParts::PreCreateThreads")
+  StartupTimeline::ScopedPhase phase("PreCreateThreads");
 
   base::FilePath user_data_dir;
   if (!PathService::Get(chrome::DIR_USER_DATA, &user_data_dir))
@@ -224,16 +247,24 @@ void AtomBrowserMainParts::PostEarlyInitialization() {
   brightray::BrowserMainParts::PostEarlyInitialization();
 }
 
-void AtomBrowserMainParts::OnMemoryPressure(
-    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
-  if (atom::Browser::Get()->is_shutting_down())
-    return;
+void AtomBrowserMainParts::ReclaimV8Memory(
+    MemoryCoordinator::Level level,
+    const MemoryCoordinator::DoneCallback& done) {
+  uint64_t bytes_freed = 0;
+  if (!atom::Browser::Get()->is_shutting_down() &&
+      js_env_.get() && js_env_->isolate()) {
+    bytes_freed =
+        MemoryCoordinator::ReclaimIsolateMemory(js_env_->isolate(), level);
+  }
+  done.Run(bytes_freed);
+}
 
+void AtomBrowserMainParts::ReleaseFreeMemory(
+    MemoryCoordinator::Level level,
+    const MemoryCoordinator::DoneCallback& done) {
+  // The allocator does not tell how much it returned.
   base::allocator::ReleaseFreeMemory();
-
-  if (js_env_.get() && js_env_->isolate()) {
-    js_env_->isolate()->LowMemoryNotification();
-  }
+  done.Run(0);
 }
 
 void AtomBrowserMainParts::IdleHandler() {
@@ -251,6 +282,8 @@ void AtomBrowserMainParts::PreMainMessageLoopStart() {
 #endif
 
 void AtomBrowserMainParts::PreMainMessageLoopRun() {
+  StartupTimeline::ScopedPhase phase("PreMainMessageLoopRun");
+
 #if defined(USE_AURA)
   if (content::ServiceManagerConnection::GetForProcess() &&
       service_manager::ServiceManagerIsRemote()) {
@@ -267,20 +300,37 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
   content::WebUIControllerFactory::RegisterFactory(
       ChromeWebUIControllerFactory::GetInstance());
 
-  js_env_.reset(new JavascriptEnvironment);
-  js_env_->isolate()->Enter();
+  // Scripts are compiled from here on, so the code cache has to be ready.
+  base::FilePath user_data_dir;
+  if (PathService::Get(chrome::DIR_USER_DATA, &user_data_dir)) {
+    auto* command_line = base::CommandLine::ForCurrentProcess();
+    std::string version = Browser::Get()->GetVersion();
+    if (command_line->HasSwitch(options::kAppVersion))
+      version = command_line->GetSwitchValueASCII(options::kAppVersion);
+    CodeCache::GetInstance()->Initialize(
+        user_data_dir.Append(FILE_PATH_LITERAL("JS Code Cache")), version);
+  }
+
+  {
+    StartupTimeline::ScopedPhase phase("JavascriptEnvironment");
+    js_env_.reset(new JavascriptEnvironment);
+    js_env_->isolate()->Enter();
+  }
 
-  node_bindings_->Initialize();
+  node::Environment* env;
+  {
+    StartupTimeline::ScopedPhase phase("NodeEnvironment");
+    node_bindings_->Initialize();
 
-  // Create the global environment.
-  node::Environment* env =
-      node_bindings_->CreateEnvironment(js_env_->context());
+    // Create the global environment.
+    env = node_bindings_->CreateEnvironment(js_env_->context());
 
-  // Add atom-shell extended APIs.
-  atom_bindings_->BindTo(js_env_->isolate(), env->process_object());
+    // Add atom-shell extended APIs.
+    atom_bindings_->BindTo(js_env_->isolate(), env->process_object());
 
-  // Load everything.
-  node_bindings_->LoadEnvironment(env);
+    // Load everything.
+    node_bindings_->LoadEnvironment(env);
+  }
 
   // Wrap the uv loop with global env.
   node_bindings_->set_uv_env(env);
@@ -294,9 +344,25 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
       base::Bind(&AtomBrowserMainParts::IdleHandler,
                  base::Unretained(this)));
 
-  memory_pressure_listener_.reset(new base::MemoryPressureListener(
-      base::Bind(&AtomBrowserMainParts::OnMemoryPressure,
-        base::Unretained(this))));
+  MemoryCoordinator* memory_coordinator = MemoryCoordinator::GetInstance();
+  memory_consumer_ids_.push_back(memory_coordinator->RegisterConsumer(
+      "native-image-cache", MemoryCoordinator::PRIORITY_CACHES,
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE,
+      base::Bind(&ClearNativeImageCache)));
+  memory_consumer_ids_.push_back(memory_coordinator->RegisterConsumer(
+      "asar-extracted-files", MemoryCoordinator::PRIORITY_FILES,
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL,
+      base::Bind(&ClearAsarExtractedFiles)));
+  memory_consumer_ids_.push_back(memory_coordinator->RegisterConsumer(
+      "v8", MemoryCoordinator::PRIORITY_ISOLATES,
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE,
+      base::Bind(&AtomBrowserMainParts::ReclaimV8Memory,
+                 base::Unretained(this))));
+  memory_consumer_ids_.push_back(memory_coordinator->RegisterConsumer(
+      "allocator", MemoryCoordinator::PRIORITY_ALLOCATOR,
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE,
+      base::Bind(&AtomBrowserMainParts::ReleaseFreeMemory,
+                 base::Unretained(this))));
 
   // Make sure the userData directory is created.
   base::FilePath user_data;
@@ -386,6 +452,9 @@ void AtomBrowserMainParts::PostMainMessageLoopStart() {
 
 void AtomBrowserMainParts::PostMainMessageLoopRun() {
   browser_context_ = nullptr;
+  for (int id : memory_consumer_ids_)
+    MemoryCoordinator::GetInstance()->UnregisterConsumer(id);
+  memory_consumer_ids_.clear();
   brightray::BrowserMainParts::PostMainMessageLoopRun();
 
   js_env_->OnMessageLoopDestroying();
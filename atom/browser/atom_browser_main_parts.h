@@ -8,10 +8,11 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "atom/browser/memory_coordinator.h"
 #include "base/callback.h"
 #include "base/command_line.h"
-#include "base/memory/memory_pressure_listener.h"
 #include "base/timer/timer.h"
 #include "brightray/browser/browser_main_parts.h"
 #include "build/build_config.h"
@@ -69,8 +70,10 @@ class AtomBrowserMainParts : public brightray::BrowserMainParts {
   void PreMainMessageLoopStart() override;
 #endif
 
-  void OnMemoryPressure(
-      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+  void ReclaimV8Memory(MemoryCoordinator::Level level,
+                       const MemoryCoordinator::DoneCallback& done);
+  void ReleaseFreeMemory(MemoryCoordinator::Level level,
+                         const MemoryCoordinator::DoneCallback& done);
   void IdleHandler();
 
  private:
@@ -105,7 +108,7 @@ class AtomBrowserMainParts : public brightray::BrowserMainParts {
   std::unique_ptr<AtomBindings> atom_bindings_;
 
   base::Timer gc_timer_;
-  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  std::vector<int> memory_consumer_ids_;
 
   // Members needed across shutdown methods.
   bool restart_last_session_ = false;
@@ -4,6 +4,8 @@
 
 #include "atom/browser/browser_context_keyed_service_factories.h"
 
+#include "brave/browser/guest_view/tab_view/spare_renderer_pool_factory.h"
+#include "brave/browser/resource_coordinator/background_tab_policy_factory.h"
 #include "chrome/browser/content_settings/cookie_settings_factory.h"
 #include "chrome/browser/content_settings/host_content_settings_map_factory.h"
 #include "chrome/browser/custom_handlers/protocol_handler_registry_factory.h"
@@ -90,6 +92,8 @@ void EnsureBrowserContextKeyedServiceFactoriesBuilt() {
   SpellcheckServiceFactory::GetInstance();
 #endif
   DownloadServiceFactory::GetInstance();
+  brave::SpareRendererPoolFactory::GetInstance();
+  brave::BackgroundTabPolicyFactory::GetInstance();
 }
 
 }  // namespace atom
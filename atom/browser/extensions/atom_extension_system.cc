@@ -12,6 +12,7 @@
 #include "atom/browser/extensions/atom_extension_system_factory.h"
 #include "atom/browser/extensions/atom_extensions_browser_client.h"
 #include "atom/browser/extensions/shared_user_script_master.h"
+#include "atom/common/startup_timeline.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/memory/weak_ptr.h"
@@ -77,6 +78,7 @@ void AtomExtensionSystem::Shared::Init(bool extensions_enabled) {
                  content::NotificationService::AllBrowserContextsAndSources());
 
   if (extensions_enabled) {
+    atom::StartupTimeline::GetInstance()->Mark("ExtensionSystemReady");
     ready_.Signal();
     content::NotificationService::current()->Notify(
         extensions::NOTIFICATION_EXTENSIONS_READY_DEPRECATED,
@@ -5,6 +5,7 @@
 #include "atom/browser/extensions/atom_extensions_network_delegate.h"
 
 #include "base/stl_util.h"
+#include "brave/browser/extensions/extension_url_overrides.h"
 #include "chrome/browser/extensions/event_router_forwarder.h"
 #include "chrome/browser/net/chrome_extensions_network_delegate.h"
 #include "chrome/browser/profiles/profile.h"
@@ -16,8 +17,30 @@ namespace extensions {
 
 namespace {
 bool g_accept_all_cookies = true;
+
+// Subresources of extensions follow the declarative URL overrides too. They
+// are applied last, so the webRequest listeners see the original request
+// and a listener that redirects or cancels it wins.
+int ApplyURLOverrides(net::URLRequest* request, GURL* new_url, int result) {
+  if (result != net::OK || !new_url->is_empty())
+    return result;
+
+  GURL override_url = request->url();
+  if (brave::ExtensionURLOverrides::GetInstance()->ResolveExtensionURL(
+          &override_url))
+    *new_url = override_url;
+  return result;
+}
+
+void RunWithURLOverrides(net::URLRequest* request,
+                         GURL* new_url,
+                         const net::CompletionCallback& callback,
+                         int result) {
+  callback.Run(ApplyURLOverrides(request, new_url, result));
 }
 
+}  // namespace
+
 AtomExtensionsNetworkDelegate::AtomExtensionsNetworkDelegate(
       Profile* profile,
       InfoMap* info_map,
@@ -72,7 +95,8 @@ int AtomExtensionsNetworkDelegate::OnBeforeURLRequest(
     GURL* new_url) {
   extensions_delegate_->ForwardStartRequestStatus(request);
 
-  callbacks_[request->identifier()] = callback;
+  callbacks_[request->identifier()] =
+      base::Bind(&RunWithURLOverrides, request, new_url, callback);
 
   base::Callback<int(void)> internal_callback = base::Bind(
           &AtomExtensionsNetworkDelegate::OnBeforeURLRequestInternal,
@@ -89,9 +113,9 @@ int AtomExtensionsNetworkDelegate::OnBeforeURLRequest(
       request, wrapped_cb, new_url);
 
   if (result == net::OK)
-    return internal_callback.Run();
+    result = internal_callback.Run();
 
-  return result;
+  return ApplyURLOverrides(request, new_url, result);
 }
 
 int AtomExtensionsNetworkDelegate::OnBeforeStartTransactionInternal(
@@ -4,10 +4,10 @@
 
 #include "atom/browser/extensions/tab_helper.h"
 
-#include <map>
 #include <utility>
 #include "atom/browser/extensions/api/atom_extensions_api_client.h"
 #include "atom/browser/extensions/atom_extension_web_contents_observer.h"
+#include "atom/browser/extensions/tab_registry.h"
 #include "atom/browser/native_window.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
@@ -15,6 +15,7 @@
 #include "base/strings/utf_string_conversions.h"
 #include "brave/browser/brave_browser_context.h"
 #include "brave/browser/guest_view/tab_view/tab_view_guest.h"
+#include "brave/browser/resource_coordinator/background_tab_policy.h"
 #include "brave/browser/resource_coordinator/guest_tab_manager.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/browser_shutdown.h"
@@ -31,7 +32,6 @@
 #include "content/public/browser/navigation_entry.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
-#include "content/public/browser/render_view_host.h"
 #include "content/public/browser/web_contents.h"
 #include "extensions/browser/component_extension_resource_manager.h"
 #include "extensions/browser/extension_api_frame_id_map.h"
@@ -67,8 +67,6 @@ const char kPinnedKey[] = "pinned";
 const char kSelectedKey[] = "selected";
 }  // namespace keys
 
-static std::map<int32_t, std::pair<int, int>> render_view_map_;
-
 namespace extensions {
 
 namespace {
@@ -95,9 +93,9 @@ TabHelper::TabHelper(content::WebContents* contents)
   SessionTabHelper::CreateForWebContents(contents);
   SetWindowId(-1);
 
-  RenderViewCreated(contents->GetRenderViewHost());
+  TabRegistry::GetInstance()->AddTab(session_id(), contents);
   contents->ForEachFrame(
-      base::Bind(&TabHelper::SetTabId, base::Unretained(this)));
+      base::Bind(&TabHelper::AddFrame, base::Unretained(this)));
 
   AtomExtensionWebContentsObserver::CreateForWebContents(contents);
   BrowserList::AddObserver(this);
@@ -382,17 +380,32 @@ void TabHelper::SetActive(bool active) {
 }
 
 void TabHelper::WasShown() {
-  if (discarded_) {
-    // load the tab if it is shown without being activate (tab preview)
-    discarded_ = false;
-    SetAutoDiscardable(true);
-    auto helper = content::RestoreHelper::FromWebContents(web_contents());
-    if (helper) {
-      helper->RemoveRestoreHelper();
-    }
+  brave::BackgroundTabPolicy::FromBrowserContext(
+      web_contents()->GetBrowserContext())->TabWasShown(session_id(),
+                                                        web_contents());
+
+  // load the tab if it is shown without being activate (tab preview)
+  LoadIfDiscarded();
+}
 
-    web_contents()->GetController().Reload(content::ReloadType::NORMAL, true);
+void TabHelper::WasHidden() {
+  brave::BackgroundTabPolicy::FromBrowserContext(
+      web_contents()->GetBrowserContext())->TabWasHidden(session_id());
+}
+
+bool TabHelper::LoadIfDiscarded() {
+  if (!discarded_)
+    return false;
+
+  discarded_ = false;
+  SetAutoDiscardable(true);
+  auto helper = content::RestoreHelper::FromWebContents(web_contents());
+  if (helper) {
+    helper->RemoveRestoreHelper();
   }
+
+  web_contents()->GetController().Reload(content::ReloadType::NORMAL, true);
+  return true;
 }
 
 void TabHelper::UpdateBrowser(Browser* browser) {
@@ -544,25 +557,36 @@ void TabHelper::SetOpener(int opener_tab_id) {
   opener_tab_id_ = opener_tab_id;
 }
 
-void TabHelper::RenderViewCreated(content::RenderViewHost* render_view_host) {
-  render_view_map_[session_id()] = std::make_pair(
-      render_view_host->GetProcess()->GetID(),
-      render_view_host->GetRoutingID());
-}
-
 void TabHelper::RenderFrameCreated(content::RenderFrameHost* host) {
-  SetTabId(host);
+  AddFrame(host);
+  brave::BackgroundTabPolicy::FromBrowserContext(
+      web_contents()->GetBrowserContext())->TabFrameCreated(session_id(),
+                                                            host);
   // Look up the extension API frame ID to force the mapping to be cached.
   // This is needed so that cached information is available for tabId in the
   // filtering callbacks.
   ExtensionApiFrameIdMap::Get()->CacheFrameData(host);
 }
 
+void TabHelper::RenderFrameDeleted(content::RenderFrameHost* host) {
+  TabRegistry::GetInstance()->RemoveFrame(session_id(), host);
+}
+
 void TabHelper::WebContentsDestroyed() {
   if (browser())
     SetBrowser(nullptr);
 
-  render_view_map_.erase(session_id());
+  TabRegistry::GetInstance()->RemoveTab(session_id());
+
+  if (!browser_shutdown::IsTryingToQuit()) {
+    brave::BackgroundTabPolicy::FromBrowserContext(
+        web_contents()->GetBrowserContext())->TabDestroyed(session_id());
+  }
+}
+
+void TabHelper::AddFrame(content::RenderFrameHost* render_frame_host) {
+  SetTabId(render_frame_host);
+  TabRegistry::GetInstance()->AddFrame(session_id(), render_frame_host);
 }
 
 void TabHelper::SetTabId(content::RenderFrameHost* render_frame_host) {
@@ -735,14 +759,7 @@ int TabHelper::get_index() const {
 
 // static
 content::WebContents* TabHelper::GetTabById(int32_t tab_id) {
-  content::RenderViewHost* rvh =
-      content::RenderViewHost::FromID(render_view_map_[tab_id].first,
-                                      render_view_map_[tab_id].second);
-  if (rvh) {
-    return content::WebContents::FromRenderViewHost(rvh);
-  } else {
-    return NULL;
-  }
+  return TabRegistry::GetInstance()->GetTab(tab_id);
 }
 
 // static
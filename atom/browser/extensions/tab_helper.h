@@ -32,7 +32,6 @@ class TabViewGuest;
 namespace content {
 class BrowserContext;
 class RenderFrameHost;
-class RenderViewHost;
 }
 
 namespace mate {
@@ -98,6 +97,10 @@ class TabHelper : public content::WebContentsObserver,
 
   bool IsDiscarded();
 
+  // Reloads a tab discarded before it was attached. Returns false if the tab
+  // was not discarded that way.
+  bool LoadIfDiscarded();
+
   void DidAttach();
 
   void SetTabValues(const base::DictionaryValue& values);
@@ -161,6 +164,9 @@ class TabHelper : public content::WebContentsObserver,
   void OnBrowserSetLastActive(Browser* browser) override;
   void UpdateBrowser(Browser* browser);
 
+  // Tells |render_frame_host| its tab id and registers it with the tab.
+  void AddFrame(content::RenderFrameHost* render_frame_host);
+
   void MaybeAttachOrCreatePinnedTab();
   void MaybeRequestWindowClose();
 
@@ -177,13 +183,14 @@ class TabHelper : public content::WebContentsObserver,
       std::unique_ptr<std::string> code_string);
 
   // content::WebContentsObserver overrides.
-  void RenderViewCreated(content::RenderViewHost* render_view_host) override;
   void RenderFrameCreated(content::RenderFrameHost* host) override;
+  void RenderFrameDeleted(content::RenderFrameHost* host) override;
   void WebContentsDestroyed() override;
   void DidCloneToNewWebContents(
       content::WebContents* old_web_contents,
       content::WebContents* new_web_contents) override;
   void WasShown() override;
+  void WasHidden() override;
 
   // Our content script observers. Declare at top so that it will outlive all
   // other members, since they might add themselves as observers.
@@ -0,0 +1,161 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/extensions/tab_registry.h"
+
+#include "base/bind.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+
+using content::BrowserThread;
+
+namespace extensions {
+
+namespace {
+
+base::LazyInstance<TabRegistry>::Leaky g_tab_registry =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+TabRegistry::Tab::Tab() : contents(nullptr) {
+}
+
+TabRegistry::Tab::~Tab() {
+}
+
+TabRegistry::TabRegistry() {
+}
+
+TabRegistry::~TabRegistry() {
+}
+
+// static
+TabRegistry* TabRegistry::GetInstance() {
+  return g_tab_registry.Pointer();
+}
+
+void TabRegistry::AddTab(int32_t tab_id, content::WebContents* contents) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  tabs_[tab_id].contents = contents;
+}
+
+void TabRegistry::RemoveTab(int32_t tab_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = tabs_.find(tab_id);
+  if (it == tabs_.end())
+    return;
+
+  for (const auto& frame_id : it->second.frames) {
+    BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+        base::Bind(&TabRegistry::RemoveFrameOnIO, base::Unretained(this),
+                   frame_id, -1));
+  }
+  for (const auto& frame_tree_node : it->second.frame_tree_nodes) {
+    BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+        base::Bind(&TabRegistry::RemoveFrameOnIO, base::Unretained(this),
+                   FrameId(-1, -1), frame_tree_node.first));
+  }
+  tabs_.erase(it);
+}
+
+void TabRegistry::AddFrame(int32_t tab_id,
+                           content::RenderFrameHost* render_frame_host) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = tabs_.find(tab_id);
+  if (it == tabs_.end())
+    return;
+
+  FrameId frame_id(render_frame_host->GetProcess()->GetID(),
+                   render_frame_host->GetRoutingID());
+  if (!it->second.frames.insert(frame_id).second)
+    return;
+
+  int frame_tree_node_id = render_frame_host->GetFrameTreeNodeId();
+  it->second.frame_tree_nodes[frame_tree_node_id]++;
+
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&TabRegistry::AddFrameOnIO, base::Unretained(this),
+                 tab_id, frame_id, frame_tree_node_id));
+}
+
+void TabRegistry::RemoveFrame(int32_t tab_id,
+                              content::RenderFrameHost* render_frame_host) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = tabs_.find(tab_id);
+  if (it == tabs_.end())
+    return;
+
+  FrameId frame_id(render_frame_host->GetProcess()->GetID(),
+                   render_frame_host->GetRoutingID());
+  if (!it->second.frames.erase(frame_id))
+    return;
+
+  // Keep the frame tree node while another render frame still hosts it.
+  int frame_tree_node_id = render_frame_host->GetFrameTreeNodeId();
+  auto node = it->second.frame_tree_nodes.find(frame_tree_node_id);
+  if (node != it->second.frame_tree_nodes.end() && --node->second == 0)
+    it->second.frame_tree_nodes.erase(node);
+  else
+    frame_tree_node_id = -1;
+
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&TabRegistry::RemoveFrameOnIO, base::Unretained(this),
+                 frame_id, frame_tree_node_id));
+}
+
+content::WebContents* TabRegistry::GetTab(int32_t tab_id) const {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = tabs_.find(tab_id);
+  return it == tabs_.end() ? nullptr : it->second.contents;
+}
+
+std::vector<int32_t> TabRegistry::GetTabIds() const {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  std::vector<int32_t> tab_ids;
+  for (const auto& tab : tabs_)
+    tab_ids.push_back(tab.first);
+  return tab_ids;
+}
+
+std::set<int> TabRegistry::GetRenderProcessIds(int32_t tab_id) const {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  std::set<int> process_ids;
+  auto it = tabs_.find(tab_id);
+  if (it == tabs_.end())
+    return process_ids;
+  for (const auto& frame_id : it->second.frames)
+    process_ids.insert(frame_id.first);
+  return process_ids;
+}
+
+int32_t TabRegistry::GetTabIdForFrameOnIO(int frame_tree_node_id,
+                                          int render_process_id,
+                                          int render_frame_id) const {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (frame_tree_node_id != -1) {
+    auto it = io_frame_tree_nodes_.find(frame_tree_node_id);
+    if (it != io_frame_tree_nodes_.end())
+      return it->second;
+  }
+
+  auto it = io_frames_.find(FrameId(render_process_id, render_frame_id));
+  return it == io_frames_.end() ? -1 : it->second;
+}
+
+void TabRegistry::AddFrameOnIO(int32_t tab_id,
+                               FrameId frame_id,
+                               int frame_tree_node_id) {
+  io_frames_[frame_id] = tab_id;
+  io_frame_tree_nodes_[frame_tree_node_id] = tab_id;
+}
+
+void TabRegistry::RemoveFrameOnIO(FrameId frame_id, int frame_tree_node_id) {
+  io_frames_.erase(frame_id);
+  if (frame_tree_node_id != -1)
+    io_frame_tree_nodes_.erase(frame_tree_node_id);
+}
+
+}  // namespace extensions
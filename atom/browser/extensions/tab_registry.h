@@ -0,0 +1,87 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_EXTENSIONS_TAB_REGISTRY_H_
+#define ATOM_BROWSER_EXTENSIONS_TAB_REGISTRY_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/lazy_instance.h"
+#include "base/macros.h"
+
+namespace content {
+class RenderFrameHost;
+class WebContents;
+}
+
+namespace extensions {
+
+// Maps tab ids to their WebContents, and the frames of each tab to its tab id.
+// The UI thread owns the registry and forwards frame changes to a copy that
+// lives on the IO thread, where the network delegate and the resource usage
+// sampler resolve the tab of a request without locking. Windows of tabs are
+// kept by SessionTabHelper.
+class TabRegistry {
+ public:
+  static TabRegistry* GetInstance();
+
+  // UI thread.
+  void AddTab(int32_t tab_id, content::WebContents* contents);
+  void RemoveTab(int32_t tab_id);
+  void AddFrame(int32_t tab_id, content::RenderFrameHost* render_frame_host);
+  void RemoveFrame(int32_t tab_id,
+                   content::RenderFrameHost* render_frame_host);
+
+  // Returns nullptr for unknown tabs.
+  content::WebContents* GetTab(int32_t tab_id) const;
+  std::vector<int32_t> GetTabIds() const;
+  // The render processes hosting frames of the tab.
+  std::set<int> GetRenderProcessIds(int32_t tab_id) const;
+
+  // IO thread. Returns -1 when the frame is not part of a known tab.
+  int32_t GetTabIdForFrameOnIO(int frame_tree_node_id,
+                               int render_process_id,
+                               int render_frame_id) const;
+
+ private:
+  friend struct base::LazyInstanceTraitsBase<TabRegistry>;
+
+  using FrameId = std::pair<int, int>;
+
+  struct Tab {
+    Tab();
+    ~Tab();
+
+    content::WebContents* contents;
+    // Render frames of the tab, and how many of them belong to each frame
+    // tree node, which has two during a cross process navigation.
+    std::set<FrameId> frames;
+    std::map<int, int> frame_tree_nodes;
+  };
+
+  TabRegistry();
+  ~TabRegistry();
+
+  void AddFrameOnIO(int32_t tab_id, FrameId frame_id, int frame_tree_node_id);
+  void RemoveFrameOnIO(FrameId frame_id, int frame_tree_node_id);
+
+  // Only accessed on the UI thread.
+  std::unordered_map<int32_t, Tab> tabs_;
+
+  // Only accessed on the IO thread.
+  std::map<FrameId, int32_t> io_frames_;
+  std::unordered_map<int, int32_t> io_frame_tree_nodes_;
+
+  DISALLOW_COPY_AND_ASSIGN(TabRegistry);
+};
+
+}  // namespace extensions
+
+#endif  // ATOM_BROWSER_EXTENSIONS_TAB_REGISTRY_H_
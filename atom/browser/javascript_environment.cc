@@ -9,6 +9,7 @@
 #include <utility>
 #include <vector>
 
+#include "atom/common/v8_profiler.h"
 #include "base/base_paths.h"
 #include "base/command_line.h"
 #include "base/files/file_path.h"
@@ -17,6 +18,7 @@
 #include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "brave/common/extensions/code_cache_bindings.h"
 #include "brave/common/extensions/crash_reporter_bindings.h"
 #include "brave/common/extensions/crypto_bindings.h"
 #include "brave/common/extensions/file_bindings.h"
@@ -153,6 +155,9 @@ JavascriptEnvironment::JavascriptEnvironment()
     script_context_->module_system()->RegisterNativeHandler(
       "path", std::unique_ptr<extensions::NativeHandler>(
           new brave::PathBindings(script_context_.get(), &source_map_)));
+    script_context_->module_system()->RegisterNativeHandler(
+      "code_cache", std::unique_ptr<extensions::NativeHandler>(
+          new brave::CodeCacheBindings(script_context_.get(), &source_map_)));
   }
 
   ModuleRegistry* registry = ModuleRegistry::From(context());
@@ -187,6 +192,7 @@ JavascriptEnvironment::JavascriptEnvironment()
 }
 
 JavascriptEnvironment::~JavascriptEnvironment() {
+  V8Profiler::Dispose(isolate_);
   context()->Exit();
   if (script_context_.get() && script_context_->is_valid()) {
     script_context_->Invalidate();
@@ -0,0 +1,209 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/memory_coordinator.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "content/public/browser/browser_thread.h"
+#include "v8/include/v8.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<MemoryCoordinator>::Leaky g_memory_coordinator =
+    LAZY_INSTANCE_INITIALIZER;
+
+// How long a tier may take before the next one is asked anyway. Consumers
+// that finish later are reported as having freed nothing.
+const int kTierTimeoutSeconds = 5;
+
+}  // namespace
+
+MemoryCoordinator::Report::Report()
+    : level(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE) {
+}
+
+MemoryCoordinator::Report::Report(const Report& other) = default;
+
+MemoryCoordinator::Report::~Report() {
+}
+
+MemoryCoordinator::Consumer::Consumer()
+    : id(0),
+      priority(0),
+      min_level(base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE) {
+}
+
+MemoryCoordinator::Consumer::Consumer(const Consumer& other) = default;
+
+MemoryCoordinator::Consumer::~Consumer() {
+}
+
+// static
+MemoryCoordinator* MemoryCoordinator::GetInstance() {
+  return g_memory_coordinator.Pointer();
+}
+
+// static
+uint64_t MemoryCoordinator::ReclaimIsolateMemory(v8::Isolate* isolate,
+                                                 Level level) {
+  v8::HeapStatistics before;
+  isolate->GetHeapStatistics(&before);
+
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL)
+    isolate->LowMemoryNotification();
+  else
+    isolate->MemoryPressureNotification(v8::MemoryPressureLevel::kModerate);
+
+  v8::HeapStatistics after;
+  isolate->GetHeapStatistics(&after);
+  if (after.used_heap_size() >= before.used_heap_size())
+    return 0;
+  return before.used_heap_size() - after.used_heap_size();
+}
+
+MemoryCoordinator::MemoryCoordinator()
+    : next_consumer_id_(1),
+      round_(0),
+      tier_begin_(0),
+      tier_end_(0),
+      tier_pending_(0) {
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&MemoryCoordinator::OnMemoryPressure,
+                 base::Unretained(this))));
+}
+
+MemoryCoordinator::~MemoryCoordinator() {
+}
+
+int MemoryCoordinator::RegisterConsumer(const std::string& name,
+                                        int priority,
+                                        Level min_level,
+                                        const ReclaimCallback& reclaim) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  Consumer consumer;
+  consumer.id = next_consumer_id_++;
+  consumer.name = name;
+  consumer.priority = priority;
+  consumer.min_level = min_level;
+  consumer.reclaim = reclaim;
+
+  auto it = std::upper_bound(consumers_.begin(), consumers_.end(), consumer,
+      [](const Consumer& a, const Consumer& b) {
+        return a.priority < b.priority;
+      });
+  consumers_.insert(it, consumer);
+  return consumer.id;
+}
+
+void MemoryCoordinator::UnregisterConsumer(int id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  for (auto it = consumers_.begin(); it != consumers_.end(); ++it) {
+    if (it->id == id) {
+      consumers_.erase(it);
+      return;
+    }
+  }
+}
+
+void MemoryCoordinator::AddObserver(Observer* observer) {
+  observers_.AddObserver(observer);
+}
+
+void MemoryCoordinator::RemoveObserver(Observer* observer) {
+  observers_.RemoveObserver(observer);
+}
+
+void MemoryCoordinator::OnMemoryPressure(Level level) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+    return;
+
+  // Consumers may register or unregister while reclaiming.
+  round_consumers_.clear();
+  for (const auto& consumer : consumers_) {
+    if (level >= consumer.min_level)
+      round_consumers_.push_back(consumer);
+  }
+
+  ++round_;
+  report_ = Report();
+  report_.level = level;
+  for (const auto& consumer : round_consumers_)
+    report_.consumers.push_back({consumer.name, 0, base::TimeDelta()});
+  done_.assign(round_consumers_.size(), false);
+  tier_begin_ = tier_end_ = 0;
+  RunNextTier();
+}
+
+void MemoryCoordinator::RunNextTier() {
+  tier_timer_.Stop();
+  if (tier_end_ == round_consumers_.size()) {
+    round_consumers_.clear();
+    for (Observer& observer : observers_)
+      observer.OnMemoryReclaimed(report_);
+    return;
+  }
+
+  tier_begin_ = tier_end_;
+  const int priority = round_consumers_[tier_begin_].priority;
+  while (tier_end_ < round_consumers_.size() &&
+         round_consumers_[tier_end_].priority == priority)
+    ++tier_end_;
+  tier_pending_ = tier_end_ - tier_begin_;
+  tier_start_ = base::TimeTicks::Now();
+  tier_timer_.Start(FROM_HERE,
+                    base::TimeDelta::FromSeconds(kTierTimeoutSeconds),
+                    base::Bind(&MemoryCoordinator::OnTierTimeout,
+                               base::Unretained(this)));
+
+  // A consumer that finishes synchronously may start the next tier, and one
+  // that causes a new pressure event starts a new round.
+  const int round = round_;
+  const size_t begin = tier_begin_;
+  const size_t end = tier_end_;
+  const Level level = report_.level;
+  for (size_t i = begin; i < end && round == round_; ++i) {
+    ReclaimCallback reclaim = round_consumers_[i].reclaim;
+    reclaim.Run(level,
+        base::Bind(&MemoryCoordinator::OnConsumerDone, base::Unretained(this),
+                   round, i, base::TimeTicks::Now()));
+  }
+}
+
+void MemoryCoordinator::OnTierTimeout() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  const base::TimeDelta duration = base::TimeTicks::Now() - tier_start_;
+  for (size_t i = tier_begin_; i < tier_end_; ++i) {
+    if (done_[i])
+      continue;
+    done_[i] = true;
+    report_.consumers[i].duration = duration;
+  }
+  RunNextTier();
+}
+
+void MemoryCoordinator::OnConsumerDone(int round,
+                                       size_t index,
+                                       base::TimeTicks start,
+                                       uint64_t bytes_freed) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (round != round_ || done_[index])
+    return;
+
+  done_[index] = true;
+  report_.consumers[index].bytes_freed = bytes_freed;
+  report_.consumers[index].duration = base::TimeTicks::Now() - start;
+  if (--tier_pending_ > 0)
+    return;
+
+  RunNextTier();
+}
+
+}  // namespace atom
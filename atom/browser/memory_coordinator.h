@@ -0,0 +1,145 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_MEMORY_COORDINATOR_H_
+#define ATOM_BROWSER_MEMORY_COORDINATOR_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/lazy_instance.h"
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/observer_list.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace v8 {
+class Isolate;
+}
+
+namespace atom {
+
+// Asks the large memory consumers of the browser process to give memory back
+// on memory pressure, in order of priority, and reports what each one freed.
+// Consumers register for the lowest pressure level they respond to, so cheap
+// caches can be dropped on moderate pressure while expensive reclaims such as
+// a full GC wait for critical pressure. UI thread only.
+class MemoryCoordinator {
+ public:
+  using Level = base::MemoryPressureListener::MemoryPressureLevel;
+  // Takes the number of bytes freed, 0 when the consumer cannot tell.
+  using DoneCallback = base::Callback<void(uint64_t)>;
+  // Must run |done| once, possibly asynchronously.
+  using ReclaimCallback = base::Callback<void(Level, const DoneCallback&)>;
+
+  // Consumers are asked in ascending order. Consumers of the same priority
+  // run together, and the next priority is only asked once all of them have
+  // finished or timed out. Caches go first and the allocator last, so it can
+  // return to the system what the others freed.
+  enum Priority {
+    PRIORITY_CACHES = 10,
+    PRIORITY_FILES = 20,
+    PRIORITY_TABS = 30,
+    PRIORITY_ISOLATES = 40,
+    PRIORITY_ALLOCATOR = 50,
+  };
+
+  struct ConsumerReport {
+    std::string name;
+    uint64_t bytes_freed;
+    base::TimeDelta duration;
+  };
+
+  struct Report {
+    Report();
+    Report(const Report& other);
+    ~Report();
+
+    Level level;
+    std::vector<ConsumerReport> consumers;
+  };
+
+  class Observer {
+   public:
+    // Called once every consumer asked for a pressure event has finished.
+    virtual void OnMemoryReclaimed(const Report& report) = 0;
+
+   protected:
+    virtual ~Observer() {}
+  };
+
+  static MemoryCoordinator* GetInstance();
+
+  // Returns the number of bytes the garbage collection of |isolate| freed.
+  // Moderate pressure only hints V8, critical pressure forces a full GC.
+  static uint64_t ReclaimIsolateMemory(v8::Isolate* isolate, Level level);
+
+  // Returns an id for UnregisterConsumer. |name| does not need to be unique.
+  int RegisterConsumer(const std::string& name,
+                       int priority,
+                       Level min_level,
+                       const ReclaimCallback& reclaim);
+  void UnregisterConsumer(int id);
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
+ private:
+  friend struct base::LazyInstanceTraitsBase<MemoryCoordinator>;
+
+  struct Consumer {
+    Consumer();
+    Consumer(const Consumer& other);
+    ~Consumer();
+
+    int id;
+    std::string name;
+    int priority;
+    Level min_level;
+    ReclaimCallback reclaim;
+  };
+
+  MemoryCoordinator();
+  ~MemoryCoordinator();
+
+  void OnMemoryPressure(Level level);
+  // Asks the consumers of the next priority of the current round, or notifies
+  // the observers when there are none left.
+  void RunNextTier();
+  void OnTierTimeout();
+  void OnConsumerDone(int round,
+                      size_t index,
+                      base::TimeTicks start,
+                      uint64_t bytes_freed);
+
+  // Sorted by priority.
+  std::vector<Consumer> consumers_;
+  int next_consumer_id_;
+
+  // A new pressure event supersedes a round that is still running.
+  int round_;
+  std::vector<Consumer> round_consumers_;
+  Report report_;
+  std::vector<bool> done_;
+  // The consumers of the running tier are [tier_begin_, tier_end_).
+  size_t tier_begin_;
+  size_t tier_end_;
+  size_t tier_pending_;
+  base::TimeTicks tier_start_;
+  base::OneShotTimer tier_timer_;
+
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  base::ObserverList<Observer> observers_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryCoordinator);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_MEMORY_COORDINATOR_H_
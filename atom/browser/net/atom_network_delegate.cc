@@ -8,6 +8,8 @@
 #include <utility>
 
 #include "atom/browser/extensions/tab_helper.h"
+#include "atom/browser/extensions/tab_registry.h"
+#include "atom/browser/resource_usage_sampler.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
@@ -77,23 +79,36 @@ int GetTabId(int frame_tree_node_id,
   return extensions::TabHelper::IdForTab(web_contents);
 }
 
+// Returns the tab of the frame that made the request, from the IO thread copy
+// of the tab registry, or -1 to look it up on the UI thread.
+int GetTabIdOnIO(int frame_tree_node_id,
+                 int render_frame_id,
+                 int render_process_id) {
+  return extensions::TabRegistry::GetInstance()->GetTabIdForFrameOnIO(
+      frame_tree_node_id, render_process_id, render_frame_id);
+}
+
 void RunSimpleListener(const AtomNetworkDelegate::SimpleListener& listener,
                        std::unique_ptr<base::DictionaryValue> details,
+                       int tab_id,
                        int frame_tree_node_id,
                        int render_frame_id,
                        int render_process_id) {
-  details->SetInteger(extensions::tabs_constants::kTabIdKey,
-      GetTabId(frame_tree_node_id, render_frame_id, render_process_id));
+  if (tab_id == -1)
+    tab_id = GetTabId(frame_tree_node_id, render_frame_id, render_process_id);
+  details->SetInteger(extensions::tabs_constants::kTabIdKey, tab_id);
   return listener.Run(*(details.get()));
 }
 
 void RunResponseListener(
     const AtomNetworkDelegate::ResponseListener& listener,
     std::unique_ptr<base::DictionaryValue> details,
+    int tab_id,
     int frame_tree_node_id, int render_frame_id, int render_process_id,
     const AtomNetworkDelegate::ResponseCallback& callback) {
-  details->SetInteger(extensions::tabs_constants::kTabIdKey,
-      GetTabId(frame_tree_node_id, render_frame_id, render_process_id));
+  if (tab_id == -1)
+    tab_id = GetTabId(frame_tree_node_id, render_frame_id, render_process_id);
+  details->SetInteger(extensions::tabs_constants::kTabIdKey, tab_id);
   return listener.Run(*(details.get()), callback);
 }
 
@@ -391,6 +406,18 @@ void AtomNetworkDelegate::OnResponseStarted(net::URLRequest* request,
                     request->was_cached());
 }
 
+void AtomNetworkDelegate::OnNetworkBytesReceived(net::URLRequest* request,
+                                                 int64_t bytes_received) {
+  ResourceUsageSampler::GetInstance()->RecordNetworkBytesOnIO(
+      request, 0, bytes_received);
+}
+
+void AtomNetworkDelegate::OnNetworkBytesSent(net::URLRequest* request,
+                                             int64_t bytes_sent) {
+  ResourceUsageSampler::GetInstance()->RecordNetworkBytesOnIO(
+      request, bytes_sent, 0);
+}
+
 void AtomNetworkDelegate::OnCompleted(net::URLRequest* request,
                                       bool started,
                                       int net_error) {
@@ -462,6 +489,8 @@ int AtomNetworkDelegate::HandleResponseEvent(
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(RunResponseListener, info.listener, base::Passed(&details),
+                 GetTabIdOnIO(frame_tree_node_id, render_frame_id,
+                              render_process_id),
                  frame_tree_node_id, render_frame_id, render_process_id,
                  response));
   return net::ERR_IO_PENDING;
@@ -487,6 +516,7 @@ void AtomNetworkDelegate::HandleSimpleEvent(
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(RunSimpleListener, info.listener, base::Passed(&details),
+          GetTabIdOnIO(frame_tree_node_id, render_frame_id, render_process_id),
           frame_tree_node_id, render_frame_id, render_process_id));
 }
 
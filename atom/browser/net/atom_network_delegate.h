@@ -89,6 +89,10 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   void OnBeforeRedirect(net::URLRequest* request,
                         const GURL& new_location) override;
   void OnResponseStarted(net::URLRequest* request, int net_error) override;
+  void OnNetworkBytesReceived(net::URLRequest* request,
+                              int64_t bytes_received) override;
+  void OnNetworkBytesSent(net::URLRequest* request,
+                          int64_t bytes_sent) override;
   void OnCompleted(net::URLRequest* request,
                    bool started,
                    int net_error) override;
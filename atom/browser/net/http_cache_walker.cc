@@ -0,0 +1,324 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/http_cache_walker.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/pickle.h"
+#include "base/strings/string_util.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_cache.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_response_info.h"
+#include "net/http/http_transaction_factory.h"
+#include "net/url_request/url_request_context.h"
+#include "net/url_request/url_request_context_getter.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+const size_t kDefaultBatchSize = 256;
+// Synchronous completions recurse once per entry, so bound the batch.
+const size_t kMaxBatchSize = 1024;
+
+// Stream holding the pickled HttpResponseInfo of an HTTP cache entry.
+const int kResponseInfoIndex = 0;
+const int kNumStreams = 3;
+
+// Returns the URL of the HTTP cache entry with |key|. Keys of requests with an
+// upload body are prefixed by the upload identifier and a '/'.
+GURL URLFromCacheKey(const std::string& key) {
+  size_t pos = 0;
+  while (pos < key.size() && base::IsAsciiDigit(key[pos]))
+    ++pos;
+  if (pos > 0 && pos < key.size() && key[pos] == '/')
+    return GURL(key.substr(pos + 1));
+  return GURL(key);
+}
+
+std::string OriginString(const GURL& url) {
+  std::string origin = url.GetOrigin().spec();
+  if (base::EndsWith(origin, "/", base::CompareCase::SENSITIVE))
+    origin.pop_back();
+  return origin;
+}
+
+void RunBatchCallback(const HttpCacheWalker::BatchCallback& callback,
+                      std::unique_ptr<base::DictionaryValue> batch) {
+  callback.Run(*batch);
+}
+
+void RunDoneCallback(const HttpCacheWalker::DoneCallback& callback,
+                     int result,
+                     std::unique_ptr<base::DictionaryValue> totals) {
+  callback.Run(result, *totals);
+}
+
+}  // namespace
+
+HttpCacheWalker::Filter::Filter() {}
+
+HttpCacheWalker::Filter::Filter(const Filter& other) = default;
+
+HttpCacheWalker::Filter::~Filter() {}
+
+bool HttpCacheWalker::Filter::IsEmpty() const {
+  return origins.empty() && url_prefixes.empty() &&
+      last_used_before.is_null() && last_used_after.is_null();
+}
+
+HttpCacheWalker::Options::Options()
+    : mode(Mode::USAGE),
+      batch_size(kDefaultBatchSize),
+      content_types(false) {}
+
+HttpCacheWalker::Options::Options(const Options& other) = default;
+
+HttpCacheWalker::Options::~Options() {}
+
+HttpCacheWalker::Totals::Totals() {}
+
+HttpCacheWalker::Totals::~Totals() {}
+
+void HttpCacheWalker::Totals::Add(const std::string& origin,
+                                  const std::string& content_type,
+                                  int64_t size) {
+  all.entries++;
+  all.size += size;
+  Usage& origin_usage = origins[origin];
+  origin_usage.entries++;
+  origin_usage.size += size;
+  if (!content_type.empty()) {
+    Usage& type_usage = content_types[content_type];
+    type_usage.entries++;
+    type_usage.size += size;
+  }
+}
+
+std::unique_ptr<base::DictionaryValue>
+HttpCacheWalker::Totals::ToValue() const {
+  auto usage_map_to_value = [](const std::map<std::string, Usage>& map) {
+    std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+    for (const auto& item : map) {
+      std::unique_ptr<base::DictionaryValue> usage(new base::DictionaryValue);
+      usage->SetDouble("entries", item.second.entries);
+      usage->SetDouble("size", item.second.size);
+      // Origins contain dots, so avoid the path expanding setters.
+      dict->SetWithoutPathExpansion(item.first, std::move(usage));
+    }
+    return dict;
+  };
+
+  std::unique_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+  value->SetDouble("entries", all.entries);
+  value->SetDouble("size", all.size);
+  value->Set("origins", usage_map_to_value(origins));
+  value->Set("contentTypes", usage_map_to_value(content_types));
+  return value;
+}
+
+// static
+void HttpCacheWalker::Start(scoped_refptr<net::URLRequestContextGetter> getter,
+                            const Options& options,
+                            const BatchCallback& batch_callback,
+                            const DoneCallback& done_callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  HttpCacheWalker* walker =
+      new HttpCacheWalker(options, batch_callback, done_callback);
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&HttpCacheWalker::StartOnIO, base::Unretained(walker),
+                 getter));
+}
+
+HttpCacheWalker::HttpCacheWalker(const Options& options,
+                                 const BatchCallback& batch_callback,
+                                 const DoneCallback& done_callback)
+    : options_(options),
+      batch_callback_(batch_callback),
+      done_callback_(done_callback),
+      backend_(nullptr),
+      entry_(nullptr),
+      batch_count_(0),
+      weak_factory_(this) {
+  options_.batch_size =
+      std::min(std::max(options_.batch_size, size_t(1)), kMaxBatchSize);
+}
+
+HttpCacheWalker::~HttpCacheWalker() {
+  if (entry_)
+    entry_->Close();
+  if (getter_)
+    getter_->RemoveObserver(this);
+}
+
+void HttpCacheWalker::OnContextShuttingDown() {
+  // The backend is destroyed with the context, and the callbacks it still
+  // holds are bound to weak pointers of the walker.
+  Finish(net::ERR_CONTEXT_SHUT_DOWN);
+}
+
+void HttpCacheWalker::StartOnIO(
+    scoped_refptr<net::URLRequestContextGetter> getter) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  // Returns null once the context has shut down.
+  auto request_context = getter->GetURLRequestContext();
+  if (!request_context) {
+    Finish(net::ERR_CONTEXT_SHUT_DOWN);
+    return;
+  }
+  auto http_cache = request_context->http_transaction_factory()->GetCache();
+  if (!http_cache) {
+    Finish(net::ERR_FAILED);
+    return;
+  }
+
+  getter_ = getter;
+  getter_->AddObserver(this);
+
+  net::CompletionCallback callback =
+      base::Bind(&HttpCacheWalker::OnBackendReady, weak_factory_.GetWeakPtr());
+  int rv = http_cache->GetBackend(&backend_, callback);
+  if (rv != net::ERR_IO_PENDING)
+    OnBackendReady(rv);
+}
+
+void HttpCacheWalker::OnBackendReady(int result) {
+  if (result != net::OK || !backend_) {
+    Finish(result != net::OK ? result : net::ERR_FAILED);
+    return;
+  }
+  iterator_ = backend_->CreateIterator();
+  OpenNextEntry();
+}
+
+void HttpCacheWalker::OpenNextEntry() {
+  if (batch_count_ >= options_.batch_size) {
+    // Report the batch and let other IO thread tasks run before continuing.
+    FlushBatch();
+    base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+        base::Bind(&HttpCacheWalker::OpenNextEntry,
+                   weak_factory_.GetWeakPtr()));
+    return;
+  }
+
+  int rv = iterator_->OpenNextEntry(&entry_,
+      base::Bind(&HttpCacheWalker::OnEntryOpened, weak_factory_.GetWeakPtr()));
+  if (rv != net::ERR_IO_PENDING)
+    OnEntryOpened(rv);
+}
+
+void HttpCacheWalker::OnEntryOpened(int result) {
+  // The iterator reports the end of the cache as an error.
+  if (result != net::OK || !entry_) {
+    Finish(net::OK);
+    return;
+  }
+  batch_count_++;
+
+  entry_url_ = URLFromCacheKey(entry_->GetKey());
+  if (!MatchesFilter(entry_url_, entry_->GetLastUsed())) {
+    entry_->Close();
+    entry_ = nullptr;
+    OpenNextEntry();
+    return;
+  }
+
+  const int headers_size = entry_->GetDataSize(kResponseInfoIndex);
+  if (options_.mode == Mode::DOOM || !options_.content_types ||
+      headers_size <= 0) {
+    OnEntryReady(std::string());
+    return;
+  }
+
+  headers_buffer_ = new net::IOBuffer(headers_size);
+  int rv = entry_->ReadData(kResponseInfoIndex, 0, headers_buffer_.get(),
+      headers_size,
+      base::Bind(&HttpCacheWalker::OnHeadersRead, weak_factory_.GetWeakPtr()));
+  if (rv != net::ERR_IO_PENDING)
+    OnHeadersRead(rv);
+}
+
+void HttpCacheWalker::OnHeadersRead(int result) {
+  std::string content_type;
+  if (result > 0) {
+    base::Pickle pickle(headers_buffer_->data(), result);
+    net::HttpResponseInfo response_info;
+    bool truncated = false;
+    if (response_info.InitFromPickle(pickle, &truncated) &&
+        response_info.headers)
+      response_info.headers->GetMimeType(&content_type);
+  }
+  headers_buffer_ = nullptr;
+  OnEntryReady(content_type.empty() ? "unknown" : content_type);
+}
+
+void HttpCacheWalker::OnEntryReady(const std::string& content_type) {
+  int64_t size = 0;
+  for (int i = 0; i < kNumStreams; ++i)
+    size += std::max(entry_->GetDataSize(i), 0);
+
+  const std::string origin = OriginString(entry_url_);
+  batch_.Add(origin, content_type, size);
+  totals_.Add(origin, content_type, size);
+
+  if (options_.mode == Mode::DOOM)
+    entry_->Doom();
+  entry_->Close();
+  entry_ = nullptr;
+  OpenNextEntry();
+}
+
+void HttpCacheWalker::FlushBatch() {
+  if (!batch_callback_.is_null() && batch_.all.entries > 0) {
+    std::unique_ptr<base::DictionaryValue> value = batch_.ToValue();
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+        base::Bind(&RunBatchCallback, batch_callback_, base::Passed(&value)));
+  }
+  batch_ = Totals();
+  batch_count_ = 0;
+}
+
+void HttpCacheWalker::Finish(int result) {
+  FlushBatch();
+  std::unique_ptr<base::DictionaryValue> value = totals_.ToValue();
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&RunDoneCallback, done_callback_, result,
+                 base::Passed(&value)));
+  delete this;
+}
+
+bool HttpCacheWalker::MatchesFilter(const GURL& url,
+                                    base::Time last_used) const {
+  const Filter& filter = options_.filter;
+  if (!filter.last_used_before.is_null() &&
+      last_used >= filter.last_used_before)
+    return false;
+  if (!filter.last_used_after.is_null() &&
+      last_used < filter.last_used_after)
+    return false;
+
+  if (filter.origins.empty() && filter.url_prefixes.empty())
+    return true;
+  const GURL origin = url.GetOrigin();
+  for (const auto& filter_origin : filter.origins) {
+    if (origin == filter_origin)
+      return true;
+  }
+  for (const auto& prefix : filter.url_prefixes) {
+    if (base::StartsWith(url.spec(), prefix, base::CompareCase::SENSITIVE))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace atom
@@ -0,0 +1,148 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_HTTP_CACHE_WALKER_H_
+#define ATOM_BROWSER_NET_HTTP_CACHE_WALKER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "net/disk_cache/disk_cache.h"
+#include "net/url_request/url_request_context_getter_observer.h"
+#include "url/gurl.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace net {
+class IOBuffer;
+class URLRequestContextGetter;
+}
+
+namespace atom {
+
+// Walks the entries of a session's HTTP cache on the IO thread, either to sum
+// their sizes by origin and content type or to doom the entries matching a
+// filter. Entries are visited in batches and the walker yields the IO thread
+// between two batches, reporting the batch to the UI thread. The walker owns
+// itself and is deleted once the done callback has been posted. It observes
+// the request context getter and finishes with net::ERR_CONTEXT_SHUT_DOWN
+// when the context shuts down, before the cache backend goes away.
+class HttpCacheWalker : public net::URLRequestContextGetterObserver {
+ public:
+  enum class Mode {
+    USAGE,
+    DOOM,
+  };
+
+  struct Filter {
+    Filter();
+    Filter(const Filter& other);
+    ~Filter();
+
+    // Entries match if any of |origins| or |url_prefixes| matches, or if both
+    // are empty. Entries must also satisfy the last used bounds.
+    std::vector<GURL> origins;
+    std::vector<std::string> url_prefixes;
+    base::Time last_used_before;
+    base::Time last_used_after;
+
+    bool IsEmpty() const;
+  };
+
+  struct Options {
+    Options();
+    Options(const Options& other);
+    ~Options();
+
+    Mode mode;
+    Filter filter;
+    size_t batch_size;
+    // Reads the stored response headers of each entry to find its type.
+    bool content_types;
+  };
+
+  // Called on the UI thread with the totals of one batch.
+  using BatchCallback = base::Callback<void(const base::DictionaryValue&)>;
+  // Called on the UI thread with a net error code and the overall totals.
+  using DoneCallback =
+      base::Callback<void(int, const base::DictionaryValue&)>;
+
+  // Must be called on the UI thread.
+  static void Start(scoped_refptr<net::URLRequestContextGetter> getter,
+                    const Options& options,
+                    const BatchCallback& batch_callback,
+                    const DoneCallback& done_callback);
+
+ private:
+  struct Usage {
+    int64_t entries = 0;
+    int64_t size = 0;
+  };
+
+  struct Totals {
+    Totals();
+    ~Totals();
+
+    Usage all;
+    std::map<std::string, Usage> origins;
+    std::map<std::string, Usage> content_types;
+
+    void Add(const std::string& origin,
+             const std::string& content_type,
+             int64_t size);
+    std::unique_ptr<base::DictionaryValue> ToValue() const;
+  };
+
+  HttpCacheWalker(const Options& options,
+                  const BatchCallback& batch_callback,
+                  const DoneCallback& done_callback);
+  ~HttpCacheWalker() override;
+
+  // net::URLRequestContextGetterObserver:
+  void OnContextShuttingDown() override;
+
+  void StartOnIO(scoped_refptr<net::URLRequestContextGetter> getter);
+  void OnBackendReady(int result);
+  void OpenNextEntry();
+  void OnEntryOpened(int result);
+  void OnHeadersRead(int result);
+  void OnEntryReady(const std::string& content_type);
+  void FlushBatch();
+  void Finish(int result);
+
+  // Returns whether the entry with |url| passes the filter.
+  bool MatchesFilter(const GURL& url, base::Time last_used) const;
+
+  Options options_;
+  BatchCallback batch_callback_;
+  DoneCallback done_callback_;
+
+  // Set while the walker observes the getter on the IO thread.
+  scoped_refptr<net::URLRequestContextGetter> getter_;
+  disk_cache::Backend* backend_;
+  std::unique_ptr<disk_cache::Backend::Iterator> iterator_;
+  disk_cache::Entry* entry_;
+  GURL entry_url_;
+  scoped_refptr<net::IOBuffer> headers_buffer_;
+  size_t batch_count_;
+
+  Totals batch_;
+  Totals totals_;
+
+  base::WeakPtrFactory<HttpCacheWalker> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpCacheWalker);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_HTTP_CACHE_WALKER_H_
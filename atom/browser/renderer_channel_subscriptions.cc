@@ -0,0 +1,112 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/renderer_channel_subscriptions.h"
+
+#include "atom/common/api/api_messages.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<RendererChannelSubscriptions>::Leaky g_subscriptions =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// static
+RendererChannelSubscriptions* RendererChannelSubscriptions::GetInstance() {
+  return g_subscriptions.Pointer();
+}
+
+RendererChannelSubscriptions::ProcessChannels::ProcessChannels()
+    : reported(false) {
+}
+
+RendererChannelSubscriptions::ProcessChannels::ProcessChannels(
+    const ProcessChannels& other) = default;
+
+RendererChannelSubscriptions::ProcessChannels::~ProcessChannels() {
+}
+
+RendererChannelSubscriptions::RendererChannelSubscriptions() {
+}
+
+RendererChannelSubscriptions::~RendererChannelSubscriptions() {
+}
+
+void RendererChannelSubscriptions::AddProcess(int render_process_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  channels_[render_process_id] = ProcessChannels();
+}
+
+void RendererChannelSubscriptions::RemoveProcess(int render_process_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  channels_.erase(render_process_id);
+}
+
+void RendererChannelSubscriptions::SetSubscribed(
+    int render_process_id,
+    const base::string16& channel,
+    bool subscribed) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = channels_.find(render_process_id);
+  if (it == channels_.end())
+    return;
+
+  it->second.reported = true;
+  if (subscribed)
+    it->second.subscribed.insert(channel);
+  else
+    it->second.subscribed.erase(channel);
+}
+
+bool RendererChannelSubscriptions::IsSubscribed(
+    int render_process_id,
+    const base::string16& channel) const {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = channels_.find(render_process_id);
+  if (it == channels_.end() || !it->second.reported)
+    return true;
+  return it->second.subscribed.count(channel) > 0;
+}
+
+RendererChannelSubscriptionsFilter::RendererChannelSubscriptionsFilter(
+    int render_process_id)
+    : content::BrowserMessageFilter(ShellMsgStart),
+      render_process_id_(render_process_id) {
+}
+
+RendererChannelSubscriptionsFilter::~RendererChannelSubscriptionsFilter() {
+}
+
+void RendererChannelSubscriptionsFilter::OverrideThreadForMessage(
+    const IPC::Message& message,
+    BrowserThread::ID* thread) {
+  if (message.type() == AtomViewHostMsg_SetChannelSubscribed::ID)
+    *thread = BrowserThread::UI;
+}
+
+bool RendererChannelSubscriptionsFilter::OnMessageReceived(
+    const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(RendererChannelSubscriptionsFilter, message)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_SetChannelSubscribed,
+                        OnSetChannelSubscribed)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void RendererChannelSubscriptionsFilter::OnSetChannelSubscribed(
+    const base::string16& channel,
+    bool subscribed) {
+  RendererChannelSubscriptions::GetInstance()->SetSubscribed(
+      render_process_id_, channel, subscribed);
+}
+
+}  // namespace atom
@@ -0,0 +1,80 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_RENDERER_CHANNEL_SUBSCRIPTIONS_H_
+#define ATOM_BROWSER_RENDERER_CHANNEL_SUBSCRIPTIONS_H_
+
+#include <map>
+#include <set>
+
+#include "base/lazy_instance.h"
+#include "base/macros.h"
+#include "base/strings/string16.h"
+#include "content/public/browser/browser_message_filter.h"
+
+namespace atom {
+
+// Tracks which ipc channels have a listener in any script context of each
+// renderer process, so messages nobody listens for are not sent at all.
+// Until a process reports its first subscription it is treated as listening
+// on every channel, so messages sent while it starts up are not dropped.
+class RendererChannelSubscriptions {
+ public:
+  static RendererChannelSubscriptions* GetInstance();
+
+  // Starts tracking |render_process_id|, whose channels are unknown until its
+  // first SetSubscribed.
+  void AddProcess(int render_process_id);
+  void RemoveProcess(int render_process_id);
+
+  void SetSubscribed(int render_process_id,
+                     const base::string16& channel,
+                     bool subscribed);
+  bool IsSubscribed(int render_process_id,
+                    const base::string16& channel) const;
+
+ private:
+  friend struct base::LazyInstanceTraitsBase<RendererChannelSubscriptions>;
+
+  RendererChannelSubscriptions();
+  ~RendererChannelSubscriptions();
+
+  struct ProcessChannels {
+    ProcessChannels();
+    ProcessChannels(const ProcessChannels& other);
+    ~ProcessChannels();
+
+    bool reported;
+    std::set<base::string16> subscribed;
+  };
+
+  std::map<int, ProcessChannels> channels_;
+
+  DISALLOW_COPY_AND_ASSIGN(RendererChannelSubscriptions);
+};
+
+// Receives the subscription changes of one renderer process.
+class RendererChannelSubscriptionsFilter
+    : public content::BrowserMessageFilter {
+ public:
+  explicit RendererChannelSubscriptionsFilter(int render_process_id);
+
+  // content::BrowserMessageFilter:
+  void OverrideThreadForMessage(const IPC::Message& message,
+                                content::BrowserThread::ID* thread) override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  ~RendererChannelSubscriptionsFilter() override;
+
+  void OnSetChannelSubscribed(const base::string16& channel, bool subscribed);
+
+  const int render_process_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(RendererChannelSubscriptionsFilter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_RENDERER_CHANNEL_SUBSCRIPTIONS_H_
@@ -0,0 +1,427 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/resource_usage_sampler.h"
+
+#include <set>
+#include <utility>
+
+#include "atom/browser/v8_profiling_host.h"
+#include "atom/common/api/api_messages.h"
+#include "base/bind.h"
+#include "base/process/process_metrics.h"
+#include "base/task_runner_util.h"
+#include "base/task_scheduler/post_task.h"
+#include "brave/common/workers/v8_worker_thread.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/resource_request_info.h"
+#include "content/renderer/worker_thread_registry.h"
+#include "extensions/features/features.h"
+#include "net/url_request/url_request.h"
+#include "v8/include/v8.h"
+
+#if defined(OS_MACOSX)
+#include "content/public/browser/browser_child_process_host.h"
+#endif
+
+#if BUILDFLAG(ENABLE_EXTENSIONS)
+#include "atom/browser/extensions/tab_registry.h"
+#include "extensions/browser/process_map.h"
+#endif
+
+using content::BrowserThread;
+using content::RenderProcessHost;
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<ResourceUsageSampler>::Leaky g_resource_usage_sampler =
+    LAZY_INSTANCE_INITIALIZER;
+
+ResourceUsageSampler::V8HeapStats GetV8HeapStats(v8::Isolate* isolate) {
+  ResourceUsageSampler::V8HeapStats stats;
+  if (!isolate)
+    return stats;
+
+  v8::HeapStatistics heap;
+  isolate->GetHeapStatistics(&heap);
+  stats.size = heap.total_heap_size();
+  stats.used = heap.used_heap_size();
+  return stats;
+}
+
+void SampleWorkerOnWorkerThread(
+    const base::Callback<void(int, const ResourceUsageSampler::V8HeapStats&)>&
+        reply) {
+  brave::V8WorkerThread* thread = brave::V8WorkerThread::current();
+  if (!thread || !thread->env())
+    return;
+
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(reply, thread->GetThreadId(),
+                 GetV8HeapStats(thread->env()->isolate())));
+}
+
+}  // namespace
+
+// Keeps a base::ProcessMetrics per process, since CPU usage is measured
+// between two calls on the same instance.
+class ResourceUsageSampler::MetricsCollector {
+ public:
+  MetricsCollector() {}
+  ~MetricsCollector() {}
+
+  std::unique_ptr<ProcessUsageMap> Collect(
+      const std::map<int, base::ProcessHandle>& processes) {
+    for (auto it = metrics_.begin(); it != metrics_.end();) {
+      auto process = processes.find(it->first);
+      // A relaunched renderer keeps its id but gets a new handle.
+      if (process == processes.end() || process->second != it->second.first)
+        it = metrics_.erase(it);
+      else
+        ++it;
+    }
+
+    std::unique_ptr<ProcessUsageMap> result(new ProcessUsageMap);
+    for (const auto& process : processes) {
+      auto& entry = metrics_[process.first];
+      if (!entry.second) {
+        entry.first = process.second;
+#if defined(OS_MACOSX)
+        entry.second = base::ProcessMetrics::CreateProcessMetrics(
+            process.second,
+            content::BrowserChildProcessHost::GetPortProvider());
+#else
+        entry.second = base::ProcessMetrics::CreateProcessMetrics(
+            process.second);
+#endif
+      }
+
+      ProcessUsage& usage = (*result)[process.first];
+      usage.cpu_usage = entry.second->GetPlatformIndependentCPUUsage();
+      usage.resident_bytes = entry.second->GetWorkingSetSize();
+      base::WorkingSetKBytes working_set;
+      usage.private_bytes = entry.second->GetWorkingSetKBytes(&working_set) ?
+          static_cast<uint64_t>(working_set.priv) * 1024 : 0;
+    }
+    return result;
+  }
+
+ private:
+  std::map<int,
+           std::pair<base::ProcessHandle,
+                     std::unique_ptr<base::ProcessMetrics>>> metrics_;
+
+  DISALLOW_COPY_AND_ASSIGN(MetricsCollector);
+};
+
+ResourceUsageSampler::ProcessSample::ProcessSample()
+    : id(0),
+      pid(base::kNullProcessId),
+      cpu_usage(0),
+      resident_bytes(0),
+      private_bytes(0) {
+}
+
+ResourceUsageSampler::ProcessSample::ProcessSample(
+    const ProcessSample& other) = default;
+
+ResourceUsageSampler::ProcessSample::~ProcessSample() {
+}
+
+ResourceUsageSampler::TabSample::TabSample() : tab_id(-1) {
+}
+
+ResourceUsageSampler::TabSample::TabSample(const TabSample& other) = default;
+
+ResourceUsageSampler::TabSample::~TabSample() {
+}
+
+ResourceUsageSampler::Sample::Sample() {
+}
+
+ResourceUsageSampler::Sample::Sample(const Sample& other) = default;
+
+ResourceUsageSampler::Sample::~Sample() {
+}
+
+// static
+const int ResourceUsageSampler::kMinIntervalMs;
+
+// static
+ResourceUsageSampler* ResourceUsageSampler::GetInstance() {
+  return g_resource_usage_sampler.Pointer();
+}
+
+ResourceUsageSampler::ResourceUsageSampler()
+    : interval_(base::TimeDelta::FromSeconds(1)),
+      task_runner_(base::CreateSequencedTaskRunnerWithTraits(
+          {base::MayBlock(), base::TaskPriority::BACKGROUND,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      collector_(nullptr, base::OnTaskRunnerDeleter(task_runner_)),
+      network_recording_(false),
+      weak_factory_(this) {
+}
+
+ResourceUsageSampler::~ResourceUsageSampler() {
+}
+
+void ResourceUsageSampler::SetInterval(base::TimeDelta interval) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  DCHECK_GE(interval.InMilliseconds(), kMinIntervalMs);
+  interval_ = interval;
+  if (timer_.IsRunning())
+    timer_.Stop();
+  UpdateTimer();
+}
+
+void ResourceUsageSampler::AddObserver(Observer* observer) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  observers_.AddObserver(observer);
+  UpdateTimer();
+}
+
+void ResourceUsageSampler::RemoveObserver(Observer* observer) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  observers_.RemoveObserver(observer);
+  UpdateTimer();
+}
+
+void ResourceUsageSampler::OnRendererV8HeapStats(int render_process_id,
+                                                 const V8HeapStats& stats) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (timer_.IsRunning())
+    renderer_heaps_[render_process_id] = stats;
+}
+
+void ResourceUsageSampler::RecordNetworkBytesOnIO(net::URLRequest* request,
+                                                  int64_t sent,
+                                                  int64_t received) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (!network_recording_.load(std::memory_order_relaxed))
+    return;
+
+  // Requests made by the browser process itself have no request info.
+  int render_process_id = 0;
+  int32_t tab_id = -1;
+  const content::ResourceRequestInfo* info =
+      content::ResourceRequestInfo::ForRequest(request);
+  if (info) {
+    render_process_id = info->GetChildID();
+#if BUILDFLAG(ENABLE_EXTENSIONS)
+    tab_id = extensions::TabRegistry::GetInstance()->GetTabIdForFrameOnIO(
+        info->GetFrameTreeNodeId(), info->GetChildID(),
+        info->GetRenderFrameID());
+#endif
+  }
+
+  base::AutoLock lock(network_lock_);
+  if (!network_recording_)
+    return;
+
+  NetworkBytes& process = process_network_[render_process_id];
+  process.sent += sent;
+  process.received += received;
+  if (tab_id != -1) {
+    NetworkBytes& tab = tab_network_[tab_id];
+    tab.sent += sent;
+    tab.received += received;
+  }
+}
+
+void ResourceUsageSampler::UpdateTimer() {
+  const bool sampling =
+      observers_.might_have_observers() && !interval_.is_zero();
+  if (sampling == timer_.IsRunning())
+    return;
+
+  SetNetworkRecording(sampling);
+  if (!sampling) {
+    timer_.Stop();
+    collector_.reset();
+    renderer_heaps_.clear();
+    worker_heaps_.clear();
+    weak_factory_.InvalidateWeakPtrs();
+    return;
+  }
+
+  collector_.reset(new MetricsCollector);
+  timer_.Start(FROM_HERE, interval_,
+               base::Bind(&ResourceUsageSampler::TakeSample,
+                          base::Unretained(this)));
+  TakeSample();
+}
+
+void ResourceUsageSampler::SetNetworkRecording(bool recording) {
+  base::AutoLock lock(network_lock_);
+  network_recording_ = recording;
+  process_network_.clear();
+  tab_network_.clear();
+}
+
+void ResourceUsageSampler::TakeSample() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  std::unique_ptr<Sample> sample(new Sample);
+  sample->time = base::Time::Now();
+
+  std::map<int, base::ProcessHandle> processes;
+  processes[0] = base::GetCurrentProcessHandle();
+  ProcessSample browser;
+  browser.id = 0;
+  browser.pid = base::GetCurrentProcId();
+  browser.type = "browser";
+  browser.v8_heap = GetV8HeapStats(v8::Isolate::GetCurrent());
+  sample->processes.push_back(browser);
+
+  std::map<int, V8HeapStats> renderer_heaps;
+  for (RenderProcessHost::iterator it(RenderProcessHost::AllHostsIterator());
+       !it.IsAtEnd(); it.Advance()) {
+    RenderProcessHost* host = it.GetCurrentValue();
+    base::ProcessHandle handle = host->GetHandle();
+    if (!host->HasConnection() || handle == base::kNullProcessHandle)
+      continue;
+
+    ProcessSample process;
+    process.id = host->GetID();
+    process.pid = base::GetProcId(handle);
+    process.type = "renderer";
+#if BUILDFLAG(ENABLE_EXTENSIONS)
+    std::set<std::string> extension_ids =
+        extensions::ProcessMap::Get(host->GetBrowserContext())->
+            GetExtensionsInProcess(process.id);
+    if (!extension_ids.empty()) {
+      process.type = "extension";
+      process.extension_ids.assign(extension_ids.begin(),
+                                   extension_ids.end());
+    }
+#endif
+    // The heap size is the reply to the previous request.
+    auto heap = renderer_heaps_.find(process.id);
+    if (heap != renderer_heaps_.end()) {
+      process.v8_heap = heap->second;
+      renderer_heaps[process.id] = heap->second;
+    }
+    sample->processes.push_back(process);
+    processes[process.id] = handle;
+
+    host->Send(new AtomMsg_RequestV8HeapStats);
+  }
+  // Forget the processes that went away.
+  renderer_heaps_.swap(renderer_heaps);
+
+  // Workers that stopped since the previous request do not reply.
+  for (const auto& worker : worker_heaps_)
+    sample->workers.push_back({worker.first, worker.second});
+  worker_heaps_.clear();
+  content::WorkerThreadRegistry::Instance()->PostTaskToAllThreads(
+      base::Bind(&SampleWorkerOnWorkerThread,
+                 base::Bind(&ResourceUsageSampler::OnWorkerV8HeapStats,
+                            weak_factory_.GetWeakPtr())));
+
+  std::map<int, NetworkBytes> process_network;
+  std::map<int32_t, NetworkBytes> tab_network;
+  {
+    base::AutoLock lock(network_lock_);
+    process_network.swap(process_network_);
+    tab_network.swap(tab_network_);
+  }
+  for (auto& process : sample->processes) {
+    auto network = process_network.find(process.id);
+    if (network != process_network.end())
+      process.network = network->second;
+  }
+
+#if BUILDFLAG(ENABLE_EXTENSIONS)
+  extensions::TabRegistry* tab_registry =
+      extensions::TabRegistry::GetInstance();
+  for (int32_t tab_id : tab_registry->GetTabIds()) {
+    TabSample tab;
+    tab.tab_id = tab_id;
+    for (int process_id : tab_registry->GetRenderProcessIds(tab_id)) {
+      tab.process_ids.push_back(process_id);
+      for (auto& process : sample->processes) {
+        if (process.id == process_id)
+          process.tab_ids.push_back(tab_id);
+      }
+    }
+    auto network = tab_network.find(tab_id);
+    if (network != tab_network.end())
+      tab.network = network->second;
+    sample->tabs.push_back(tab);
+  }
+#endif
+
+  base::PostTaskAndReplyWithResult(
+      task_runner_.get(), FROM_HERE,
+      base::Bind(&MetricsCollector::Collect,
+                 base::Unretained(collector_.get()), processes),
+      base::Bind(&ResourceUsageSampler::OnProcessUsage,
+                 weak_factory_.GetWeakPtr(), base::Passed(&sample)));
+}
+
+void ResourceUsageSampler::OnWorkerV8HeapStats(int worker_id,
+                                               const V8HeapStats& stats) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  worker_heaps_[worker_id] = stats;
+}
+
+void ResourceUsageSampler::OnProcessUsage(
+    std::unique_ptr<Sample> sample,
+    std::unique_ptr<ProcessUsageMap> usage) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  for (auto& process : sample->processes) {
+    auto it = usage->find(process.id);
+    if (it == usage->end())
+      continue;
+    process.cpu_usage = it->second.cpu_usage;
+    process.resident_bytes = it->second.resident_bytes;
+    process.private_bytes = it->second.private_bytes;
+  }
+
+  for (Observer& observer : observers_)
+    observer.OnResourceUsageSampled(*sample);
+}
+
+ResourceUsageFilter::ResourceUsageFilter(int render_process_id)
+    : content::BrowserMessageFilter(ShellMsgStart),
+      render_process_id_(render_process_id) {
+}
+
+ResourceUsageFilter::~ResourceUsageFilter() {
+}
+
+void ResourceUsageFilter::OverrideThreadForMessage(
+    const IPC::Message& message,
+    BrowserThread::ID* thread) {
+  if (message.type() == AtomViewHostMsg_V8HeapStats::ID ||
+      message.type() == AtomViewHostMsg_V8ProfilingDone::ID)
+    *thread = BrowserThread::UI;
+}
+
+bool ResourceUsageFilter::OnMessageReceived(const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(ResourceUsageFilter, message)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_V8HeapStats, OnV8HeapStats)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_V8ProfilingDone, OnV8ProfilingDone)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void ResourceUsageFilter::OnV8HeapStats(uint64_t size, uint64_t used) {
+  ResourceUsageSampler::V8HeapStats stats;
+  stats.size = size;
+  stats.used = used;
+  ResourceUsageSampler::GetInstance()->OnRendererV8HeapStats(
+      render_process_id_, stats);
+}
+
+void ResourceUsageFilter::OnV8ProfilingDone(int request_id, bool success) {
+  V8ProfilingHost::GetInstance()->OnRendererDone(render_process_id_,
+                                                 request_id, success);
+}
+
+}  // namespace atom
@@ -0,0 +1,205 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_RESOURCE_USAGE_SAMPLER_H_
+#define ATOM_BROWSER_RESOURCE_USAGE_SAMPLER_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/lazy_instance.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/observer_list.h"
+#include "base/process/process_handle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "content/public/browser/browser_message_filter.h"
+
+namespace net {
+class URLRequest;
+}
+
+namespace atom {
+
+// Periodically collects the CPU, memory, V8 heap and network usage of the
+// browser and renderer processes, of each tab and of each worker, and hands
+// it to the observers as one sample. Process metrics are read on a
+// background sequence. V8 heap sizes are reported asynchronously, so a sample
+// carries the last reply of each process. UI thread unless noted otherwise.
+class ResourceUsageSampler {
+ public:
+  struct V8HeapStats {
+    V8HeapStats() : size(0), used(0) {}
+
+    uint64_t size;
+    uint64_t used;
+  };
+
+  struct NetworkBytes {
+    NetworkBytes() : sent(0), received(0) {}
+
+    uint64_t sent;
+    uint64_t received;
+  };
+
+  struct ProcessSample {
+    ProcessSample();
+    ProcessSample(const ProcessSample& other);
+    ~ProcessSample();
+
+    // Child process id, 0 for the browser process.
+    int id;
+    base::ProcessId pid;
+    // "browser", "renderer" or "extension".
+    std::string type;
+    std::vector<std::string> extension_ids;
+    std::vector<int32_t> tab_ids;
+    // Percent of one core since the previous sample.
+    double cpu_usage;
+    uint64_t resident_bytes;
+    uint64_t private_bytes;
+    V8HeapStats v8_heap;
+    // Since the previous sample.
+    NetworkBytes network;
+  };
+
+  struct TabSample {
+    TabSample();
+    TabSample(const TabSample& other);
+    ~TabSample();
+
+    int32_t tab_id;
+    std::vector<int> process_ids;
+    // Since the previous sample.
+    NetworkBytes network;
+  };
+
+  struct WorkerSample {
+    int worker_id;
+    V8HeapStats v8_heap;
+  };
+
+  struct Sample {
+    Sample();
+    Sample(const Sample& other);
+    ~Sample();
+
+    base::Time time;
+    std::vector<ProcessSample> processes;
+    std::vector<TabSample> tabs;
+    std::vector<WorkerSample> workers;
+  };
+
+  class Observer {
+   public:
+    virtual void OnResourceUsageSampled(const Sample& sample) = 0;
+
+   protected:
+    virtual ~Observer() {}
+  };
+
+  static ResourceUsageSampler* GetInstance();
+
+  // Each sample messages every renderer and worker isolate, so shorter
+  // intervals are not allowed.
+  static const int kMinIntervalMs = 100;
+
+  // Samples every |interval| while there are observers. The interval is
+  // shared by all observers and must be at least kMinIntervalMs.
+  void SetInterval(base::TimeDelta interval);
+  base::TimeDelta interval() const { return interval_; }
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
+  // Called with the reply to AtomMsg_RequestV8HeapStats.
+  void OnRendererV8HeapStats(int render_process_id,
+                             const V8HeapStats& stats);
+
+  // IO thread.
+  void RecordNetworkBytesOnIO(net::URLRequest* request,
+                              int64_t sent,
+                              int64_t received);
+
+ private:
+  friend struct base::LazyInstanceTraitsBase<ResourceUsageSampler>;
+
+  class MetricsCollector;
+
+  struct ProcessUsage {
+    double cpu_usage;
+    uint64_t resident_bytes;
+    uint64_t private_bytes;
+  };
+  using ProcessUsageMap = std::map<int, ProcessUsage>;
+
+  ResourceUsageSampler();
+  ~ResourceUsageSampler();
+
+  void UpdateTimer();
+  void SetNetworkRecording(bool recording);
+  void TakeSample();
+  void OnWorkerV8HeapStats(int worker_id, const V8HeapStats& stats);
+  void OnProcessUsage(std::unique_ptr<Sample> sample,
+                      std::unique_ptr<ProcessUsageMap> usage);
+
+  base::TimeDelta interval_;
+  base::RepeatingTimer timer_;
+
+  // Last replies, by child process id and by worker id.
+  std::map<int, V8HeapStats> renderer_heaps_;
+  std::map<int, V8HeapStats> worker_heaps_;
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  // Lives on |task_runner_|.
+  std::unique_ptr<MetricsCollector, base::OnTaskRunnerDeleter> collector_;
+
+  // Written on the IO thread and taken on the UI thread. The flag is also
+  // read without the lock so requests skip the tab lookup while sampling is
+  // off, and read again with it.
+  base::Lock network_lock_;
+  std::atomic<bool> network_recording_;
+  std::map<int, NetworkBytes> process_network_;
+  std::map<int32_t, NetworkBytes> tab_network_;
+
+  base::ObserverList<Observer> observers_;
+
+  base::WeakPtrFactory<ResourceUsageSampler> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceUsageSampler);
+};
+
+// Receives the V8 heap sizes and the profiling replies of one renderer
+// process.
+class ResourceUsageFilter : public content::BrowserMessageFilter {
+ public:
+  explicit ResourceUsageFilter(int render_process_id);
+
+  // content::BrowserMessageFilter:
+  void OverrideThreadForMessage(const IPC::Message& message,
+                                content::BrowserThread::ID* thread) override;
+  bool OnMessageReceived(const IPC::Message& message) override;
+
+ private:
+  ~ResourceUsageFilter() override;
+
+  void OnV8HeapStats(uint64_t size, uint64_t used);
+  void OnV8ProfilingDone(int request_id, bool success);
+
+  const int render_process_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceUsageFilter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_RESOURCE_USAGE_SAMPLER_H_
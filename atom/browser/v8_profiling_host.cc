@@ -0,0 +1,232 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/v8_profiling_host.h"
+
+#include <utility>
+#include <vector>
+
+#include "atom/browser/javascript_environment.h"
+#include "atom/common/api/api_messages.h"
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/task_runner.h"
+#include "brave/common/workers/v8_worker_thread.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/renderer/worker_thread_registry.h"
+#include "ipc/ipc_platform_file.h"
+
+using content::BrowserThread;
+using content::RenderProcessHost;
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<V8ProfilingHost>::Leaky g_v8_profiling_host =
+    LAZY_INSTANCE_INITIALIZER;
+
+const int kWorkerProcessId = -1;
+
+// The isolate of the current worker thread, if it has one.
+V8Profiler* GetWorkerProfiler() {
+  brave::V8WorkerThread* thread = brave::V8WorkerThread::current();
+  if (!thread || !thread->env())
+    return nullptr;
+  return V8Profiler::From(thread->env()->isolate());
+}
+
+}  // namespace
+
+V8ProfilingHost::Target::Target()
+    : process_id(0), worker_id(-1) {
+}
+
+// static
+V8ProfilingHost* V8ProfilingHost::GetInstance() {
+  return g_v8_profiling_host.Pointer();
+}
+
+V8ProfilingHost::V8ProfilingHost()
+    : next_request_id_(0),
+      observed_hosts_(this) {
+}
+
+V8ProfilingHost::~V8ProfilingHost() {
+}
+
+bool V8ProfilingHost::Start(const Target& target,
+                            const V8Profiler::Options& options) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (target.worker_id >= 0) {
+    scoped_refptr<base::TaskRunner> task_runner =
+        content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(
+            target.worker_id);
+    return task_runner && task_runner->PostTask(FROM_HERE,
+        base::Bind(&V8ProfilingHost::StartOnWorkerThread, options));
+  }
+
+  if (target.process_id == 0)
+    return V8Profiler::From(v8::Isolate::GetCurrent())->Start(options);
+
+  RenderProcessHost* host = RenderProcessHost::FromID(target.process_id);
+  return host && host->Send(new AtomMsg_StartV8Profiling(
+      options.heap_sampling_interval, options.cpu_sampling_interval));
+}
+
+bool V8ProfilingHost::Stop(const Target& target,
+                           base::File file,
+                           const V8Profiler::DoneCallback& done) {
+  return SendRequest(target, REQUEST_STOP, std::move(file), done);
+}
+
+bool V8ProfilingHost::WriteHeapSnapshot(const Target& target,
+                                        base::File file,
+                                        const V8Profiler::DoneCallback& done) {
+  return SendRequest(target, REQUEST_WRITE_HEAP_SNAPSHOT, std::move(file),
+                     done);
+}
+
+void V8ProfilingHost::OnRendererDone(int render_process_id,
+                                     int request_id,
+                                     bool success) {
+  OnRequestDone(render_process_id, request_id, success);
+}
+
+void V8ProfilingHost::OnWorkerStopped(int worker_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  FailPendingRequests(kWorkerProcessId, worker_id);
+}
+
+void V8ProfilingHost::RenderProcessExited(RenderProcessHost* host,
+                                          base::TerminationStatus status,
+                                          int exit_code) {
+  FailPendingRequests(host->GetID(), -1);
+}
+
+void V8ProfilingHost::RenderProcessHostDestroyed(RenderProcessHost* host) {
+  observed_hosts_.Remove(host);
+  FailPendingRequests(host->GetID(), -1);
+}
+
+bool V8ProfilingHost::SendRequest(const Target& target,
+                                  Request request,
+                                  base::File file,
+                                  const V8Profiler::DoneCallback& done) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (target.worker_id >= 0) {
+    scoped_refptr<base::TaskRunner> task_runner =
+        content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(
+            target.worker_id);
+    if (!task_runner)
+      return false;
+    // The callback stays on this thread, the worker only gets the id.
+    int request_id =
+        AddPendingRequest(kWorkerProcessId, target.worker_id, done);
+    if (!task_runner->PostTask(FROM_HERE,
+            base::Bind(&V8ProfilingHost::RunOnWorkerThread, request,
+                       base::Passed(&file), request_id))) {
+      pending_requests_.erase(request_id);
+      return false;
+    }
+    return true;
+  }
+
+  if (target.process_id == 0) {
+    V8Profiler* profiler = V8Profiler::From(v8::Isolate::GetCurrent());
+    if (request == REQUEST_STOP)
+      profiler->Stop(std::move(file), done);
+    else
+      profiler->WriteHeapSnapshot(std::move(file), done);
+    return true;
+  }
+
+  RenderProcessHost* host = RenderProcessHost::FromID(target.process_id);
+  if (!host)
+    return false;
+  if (!observed_hosts_.IsObserving(host))
+    observed_hosts_.Add(host);
+
+  int request_id = AddPendingRequest(target.process_id, -1, done);
+  IPC::PlatformFileForTransit transit =
+      IPC::TakePlatformFileForTransit(std::move(file));
+  bool sent = request == REQUEST_STOP ?
+      host->Send(new AtomMsg_StopV8Profiling(request_id, transit)) :
+      host->Send(new AtomMsg_WriteV8HeapSnapshot(request_id, transit));
+  if (!sent)
+    pending_requests_.erase(request_id);
+  return sent;
+}
+
+int V8ProfilingHost::AddPendingRequest(int process_id,
+                                       int worker_id,
+                                       const V8Profiler::DoneCallback& done) {
+  int request_id = next_request_id_++;
+  pending_requests_[request_id] = {done, process_id, worker_id};
+  return request_id;
+}
+
+void V8ProfilingHost::OnRequestDone(int process_id,
+                                    int request_id,
+                                    bool success) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = pending_requests_.find(request_id);
+  if (it == pending_requests_.end() || it->second.process_id != process_id)
+    return;
+
+  V8Profiler::DoneCallback done = it->second.done;
+  pending_requests_.erase(it);
+  done.Run(success);
+}
+
+void V8ProfilingHost::FailPendingRequests(int process_id, int worker_id) {
+  std::vector<V8Profiler::DoneCallback> failed;
+  for (auto it = pending_requests_.begin(); it != pending_requests_.end();) {
+    if (it->second.process_id == process_id &&
+        it->second.worker_id == worker_id) {
+      failed.push_back(it->second.done);
+      it = pending_requests_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (const auto& done : failed)
+    done.Run(false);
+}
+
+// static
+void V8ProfilingHost::StartOnWorkerThread(
+    const V8Profiler::Options& options) {
+  V8Profiler* profiler = GetWorkerProfiler();
+  if (profiler)
+    profiler->Start(options);
+}
+
+// static
+void V8ProfilingHost::RunOnWorkerThread(Request request,
+                                        base::File file,
+                                        int request_id) {
+  V8Profiler::DoneCallback reply =
+      base::Bind(&V8ProfilingHost::ReplyFromWorkerThread, request_id);
+  V8Profiler* profiler = GetWorkerProfiler();
+  if (!profiler) {
+    reply.Run(false);
+    return;
+  }
+
+  if (request == REQUEST_STOP)
+    profiler->Stop(std::move(file), reply);
+  else
+    profiler->WriteHeapSnapshot(std::move(file), reply);
+}
+
+// static
+void V8ProfilingHost::ReplyFromWorkerThread(int request_id, bool success) {
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&V8ProfilingHost::OnRequestDone,
+                 base::Unretained(GetInstance()), kWorkerProcessId,
+                 request_id, success));
+}
+
+}  // namespace atom
@@ -0,0 +1,106 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_V8_PROFILING_HOST_H_
+#define ATOM_BROWSER_V8_PROFILING_HOST_H_
+
+#include <map>
+
+#include "atom/common/v8_profiler.h"
+#include "base/files/file.h"
+#include "base/lazy_instance.h"
+#include "base/macros.h"
+#include "base/scoped_observer.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_process_host_observer.h"
+
+namespace atom {
+
+// Profiles the isolates of the browser process, of its worker threads and of
+// the renderers with V8Profiler. Renderers profile the isolate of their main
+// thread, which runs the pages and the extension contexts of the process.
+// Worker threads and renderers are asked to stop and to write snapshots with
+// a request id, and the callback waits here for their reply. UI thread.
+class V8ProfilingHost : public content::RenderProcessHostObserver {
+ public:
+  struct Target {
+    Target();
+
+    // Child process id of a renderer, 0 for the browser process.
+    int process_id;
+    // As passed to the worker-start event, or -1 to target a process.
+    int worker_id;
+  };
+
+  static V8ProfilingHost* GetInstance();
+
+  // Return false when there is no such target. Renderers and workers are
+  // started asynchronously.
+  bool Start(const Target& target, const V8Profiler::Options& options);
+  bool Stop(const Target& target,
+            base::File file,
+            const V8Profiler::DoneCallback& done);
+  bool WriteHeapSnapshot(const Target& target,
+                         base::File file,
+                         const V8Profiler::DoneCallback& done);
+
+  // Called with AtomViewHostMsg_V8ProfilingDone.
+  void OnRendererDone(int render_process_id, int request_id, bool success);
+  // Fails the requests a worker thread has not replied to before it
+  // stopped.
+  void OnWorkerStopped(int worker_id);
+
+  // content::RenderProcessHostObserver:
+  void RenderProcessExited(content::RenderProcessHost* host,
+                           base::TerminationStatus status,
+                           int exit_code) override;
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+
+ private:
+  friend struct base::LazyInstanceTraitsBase<V8ProfilingHost>;
+
+  enum Request {
+    REQUEST_STOP,
+    REQUEST_WRITE_HEAP_SNAPSHOT,
+  };
+
+  struct PendingRequest {
+    V8Profiler::DoneCallback done;
+    // -1 for workers.
+    int process_id;
+    // -1 for renderers.
+    int worker_id;
+  };
+
+  V8ProfilingHost();
+  ~V8ProfilingHost() override;
+
+  bool SendRequest(const Target& target,
+                   Request request,
+                   base::File file,
+                   const V8Profiler::DoneCallback& done);
+  int AddPendingRequest(int process_id,
+                        int worker_id,
+                        const V8Profiler::DoneCallback& done);
+  void OnRequestDone(int process_id, int request_id, bool success);
+  void FailPendingRequests(int process_id, int worker_id);
+
+  static void StartOnWorkerThread(const V8Profiler::Options& options);
+  static void RunOnWorkerThread(Request request,
+                                base::File file,
+                                int request_id);
+  static void ReplyFromWorkerThread(int request_id, bool success);
+
+  int next_request_id_;
+  std::map<int, PendingRequest> pending_requests_;
+
+  ScopedObserver<content::RenderProcessHost,
+                 content::RenderProcessHostObserver> observed_hosts_;
+
+  DISALLOW_COPY_AND_ASSIGN(V8ProfilingHost);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_V8_PROFILING_HOST_H_
@@ -0,0 +1,304 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/web_contents_thumbnail_helper.h"
+
+#include <algorithm>
+#include <list>
+#include <utility>
+
+#include "base/lazy_instance.h"
+#include "base/strings/stringprintf.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/values.h"
+#include "content/public/browser/navigation_handle.h"
+#include "content/public/browser/render_widget_host_view.h"
+#include "content/public/browser/web_contents.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/geometry/rect.h"
+
+DEFINE_WEB_CONTENTS_USER_DATA_KEY(atom::WebContentsThumbnailHelper);
+
+namespace atom {
+
+namespace {
+
+const int kDefaultJpegQuality = 90;
+const size_t kDefaultMaxCacheSize = 16 * 1024 * 1024;
+const int64_t kDefaultMinCaptureIntervalMs = 500;
+
+// State shared by all helpers. Only touched on the UI thread.
+struct ThumbnailCache {
+  ThumbnailCache()
+      : size(0),
+        max_size(kDefaultMaxCacheSize),
+        min_capture_interval(base::TimeDelta::FromMilliseconds(
+            kDefaultMinCaptureIntervalMs)),
+        hits(0),
+        misses(0),
+        captures(0),
+        throttled(0),
+        evictions(0) {}
+
+  // Helpers holding a thumbnail, least recently used first.
+  std::list<WebContentsThumbnailHelper*> lru;
+  size_t size;
+  size_t max_size;
+  base::TimeDelta min_capture_interval;
+
+  int hits;
+  int misses;
+  int captures;
+  int throttled;
+  int evictions;
+};
+
+base::LazyInstance<ThumbnailCache>::Leaky g_cache = LAZY_INSTANCE_INITIALIZER;
+
+scoped_refptr<base::RefCountedBytes> EncodeThumbnail(
+    const SkBitmap& bitmap,
+    const std::string& format,
+    int quality) {
+  std::vector<unsigned char> output;
+  bool success;
+  if (format == "png") {
+    success = gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &output);
+  } else {
+    success = gfx::JPEGCodec::Encode(bitmap, quality, &output);
+  }
+  if (!success)
+    return nullptr;
+  return base::RefCountedBytes::TakeVector(&output);
+}
+
+// Returns the part of |view_size| with the aspect ratio of |target|,
+// anchored to the top left so thumbnails show the start of the page.
+gfx::Rect GetSourceRect(const gfx::Size& view_size, const gfx::Size& target) {
+  int width = view_size.width();
+  int height = view_size.height();
+  if (static_cast<int64_t>(width) * target.height() >
+      static_cast<int64_t>(height) * target.width()) {
+    width = std::max(1, height * target.width() / target.height());
+  } else {
+    height = std::max(1, width * target.height() / target.width());
+  }
+  return gfx::Rect(width, height);
+}
+
+}  // namespace
+
+WebContentsThumbnailHelper::Params::Params()
+    : format("jpeg"),
+      quality(kDefaultJpegQuality) {}
+
+std::string WebContentsThumbnailHelper::Params::ToKey() const {
+  return base::StringPrintf("%dx%d:%s:%d", size.width(), size.height(),
+                            format.c_str(), quality);
+}
+
+WebContentsThumbnailHelper::WebContentsThumbnailHelper(
+    content::WebContents* web_contents)
+    : content::WebContentsObserver(web_contents),
+      stale_(true),
+      weak_factory_(this) {}
+
+WebContentsThumbnailHelper::~WebContentsThumbnailHelper() {
+  ClearCachedThumbnail();
+  // The contents are being torn down, so the callbacks run later.
+  for (const auto& pending : pending_callbacks_) {
+    for (const auto& callback : pending.second) {
+      base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+          base::Bind(callback, scoped_refptr<base::RefCountedBytes>()));
+    }
+  }
+}
+
+// static
+void WebContentsThumbnailHelper::SetMinCaptureInterval(
+    base::TimeDelta interval) {
+  g_cache.Get().min_capture_interval = interval;
+}
+
+void WebContentsThumbnailHelper::SetCaptureInterval(
+    base::TimeDelta interval) {
+  min_capture_interval_ = interval;
+}
+
+// static
+void WebContentsThumbnailHelper::SetMaxCacheSize(size_t max_size) {
+  ThumbnailCache& cache = g_cache.Get();
+  cache.max_size = max_size;
+  while (cache.size > cache.max_size && !cache.lru.empty()) {
+    cache.lru.front()->ClearCachedThumbnail();
+    cache.evictions++;
+  }
+}
+
+// static
+std::unique_ptr<base::DictionaryValue> WebContentsThumbnailHelper::GetStats() {
+  const ThumbnailCache& cache = g_cache.Get();
+  std::unique_ptr<base::DictionaryValue> stats(new base::DictionaryValue);
+  stats->SetInteger("hits", cache.hits);
+  stats->SetInteger("misses", cache.misses);
+  stats->SetInteger("captures", cache.captures);
+  stats->SetInteger("throttled", cache.throttled);
+  stats->SetInteger("evictions", cache.evictions);
+  stats->SetInteger("count", cache.lru.size());
+  stats->SetDouble("size", cache.size);
+  stats->SetDouble("maxSize", cache.max_size);
+  return stats;
+}
+
+void WebContentsThumbnailHelper::CaptureThumbnail(
+    const Params& params,
+    const ThumbnailCallback& callback) {
+  ThumbnailCache& cache = g_cache.Get();
+  const std::string key = params.ToKey();
+
+  if (cached_data_ && cached_key_ == key) {
+    const bool throttled = stale_ &&
+        base::TimeTicks::Now() - last_capture_time_ <
+            min_capture_interval_.value_or(cache.min_capture_interval);
+    if (!stale_ || throttled) {
+      if (throttled)
+        cache.throttled++;
+      else
+        cache.hits++;
+      // Move to the most recently used end.
+      cache.lru.remove(this);
+      cache.lru.push_back(this);
+      callback.Run(cached_data_);
+      return;
+    }
+  }
+  cache.misses++;
+
+  // Join a capture already in flight for the same parameters.
+  auto& callbacks = pending_callbacks_[key];
+  callbacks.push_back(callback);
+  if (callbacks.size() > 1)
+    return;
+
+  content::RenderWidgetHostView* view =
+      web_contents()->GetRenderWidgetHostView();
+  if (!view || !view->IsSurfaceAvailableForCopy() || params.size.IsEmpty()) {
+    RunCallbacks(key, nullptr);
+    return;
+  }
+
+  const gfx::Size view_size = view->GetViewBounds().size();
+  if (view_size.IsEmpty()) {
+    RunCallbacks(key, nullptr);
+    return;
+  }
+
+  cache.captures++;
+  last_capture_time_ = base::TimeTicks::Now();
+  // Let the compositor scale down to the thumbnail size so that only the
+  // small bitmap is read back.
+  view->CopyFromSurface(
+      GetSourceRect(view_size, params.size),
+      params.size,
+      base::Bind(&WebContentsThumbnailHelper::OnCopyFromSurface,
+                 weak_factory_.GetWeakPtr(), params),
+      kN32_SkColorType);
+}
+
+void WebContentsThumbnailHelper::DidFinishNavigation(
+    content::NavigationHandle* navigation_handle) {
+  if (navigation_handle->IsInMainFrame() &&
+      navigation_handle->HasCommitted() &&
+      !navigation_handle->IsSameDocument())
+    stale_ = true;
+}
+
+void WebContentsThumbnailHelper::DidFirstVisuallyNonEmptyPaint() {
+  stale_ = true;
+}
+
+void WebContentsThumbnailHelper::DidStopLoading() {
+  stale_ = true;
+}
+
+void WebContentsThumbnailHelper::DidGetUserInteraction(
+    const blink::WebInputEvent::Type type) {
+  stale_ = true;
+}
+
+void WebContentsThumbnailHelper::OnCopyFromSurface(
+    const Params& params,
+    const SkBitmap& bitmap,
+    content::ReadbackResponse response) {
+  if (response != content::READBACK_SUCCESS || bitmap.drawsNothing()) {
+    RunCallbacks(params.ToKey(), nullptr);
+    return;
+  }
+
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE,
+      {base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::Bind(&EncodeThumbnail, bitmap, params.format, params.quality),
+      base::Bind(&WebContentsThumbnailHelper::OnThumbnailEncoded,
+                 weak_factory_.GetWeakPtr(), params));
+}
+
+void WebContentsThumbnailHelper::OnThumbnailEncoded(
+    const Params& params,
+    scoped_refptr<base::RefCountedBytes> data) {
+  const std::string key = params.ToKey();
+  if (data)
+    SetCachedThumbnail(key, data);
+  RunCallbacks(key, data);
+}
+
+void WebContentsThumbnailHelper::RunCallbacks(
+    const std::string& key,
+    scoped_refptr<base::RefCountedBytes> data) {
+  auto it = pending_callbacks_.find(key);
+  if (it == pending_callbacks_.end())
+    return;
+  std::vector<ThumbnailCallback> callbacks;
+  callbacks.swap(it->second);
+  pending_callbacks_.erase(it);
+  for (const auto& callback : callbacks)
+    callback.Run(data);
+}
+
+void WebContentsThumbnailHelper::SetCachedThumbnail(
+    const std::string& key,
+    scoped_refptr<base::RefCountedBytes> data) {
+  ClearCachedThumbnail();
+
+  ThumbnailCache& cache = g_cache.Get();
+  if (data->size() > cache.max_size)
+    return;
+
+  cached_key_ = key;
+  cached_data_ = data;
+  stale_ = false;
+  cache.size += data->size();
+  cache.lru.push_back(this);
+
+  while (cache.size > cache.max_size && cache.lru.front() != this) {
+    cache.lru.front()->ClearCachedThumbnail();
+    cache.evictions++;
+  }
+}
+
+void WebContentsThumbnailHelper::ClearCachedThumbnail() {
+  if (!cached_data_)
+    return;
+  ThumbnailCache& cache = g_cache.Get();
+  cache.size -= cached_data_->size();
+  cache.lru.remove(this);
+  cached_data_ = nullptr;
+  cached_key_.clear();
+  stale_ = true;
+}
+
+}  // namespace atom
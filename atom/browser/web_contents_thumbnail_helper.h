@@ -0,0 +1,106 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_WEB_CONTENTS_THUMBNAIL_HELPER_H_
+#define ATOM_BROWSER_WEB_CONTENTS_THUMBNAIL_HELPER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/weak_ptr.h"
+#include "base/optional.h"
+#include "base/time/time.h"
+#include "content/public/browser/readback_types.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+#include "ui/gfx/geometry/size.h"
+
+class SkBitmap;
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace atom {
+
+// Captures thumbnails of a WebContents. The compositor scales the page
+// straight to the thumbnail size, the result is encoded on the task scheduler
+// and kept until the page navigates, first paints, stops loading or gets user
+// input. Changes a page makes on its own are not noticed. Captures are rate
+// limited per tab and the encoded thumbnails of all tabs share a memory
+// budget.
+class WebContentsThumbnailHelper
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<WebContentsThumbnailHelper> {
+ public:
+  struct Params {
+    Params();
+
+    gfx::Size size;
+    std::string format;
+    int quality;
+
+    std::string ToKey() const;
+  };
+
+  // |data| is null when the page could not be captured.
+  using ThumbnailCallback =
+      base::Callback<void(scoped_refptr<base::RefCountedBytes> data)>;
+
+  ~WebContentsThumbnailHelper() override;
+
+  // The interval of tabs that did not set their own.
+  static void SetMinCaptureInterval(base::TimeDelta interval);
+  static void SetMaxCacheSize(size_t max_size);
+  static std::unique_ptr<base::DictionaryValue> GetStats();
+
+  void SetCaptureInterval(base::TimeDelta interval);
+
+  void CaptureThumbnail(const Params& params,
+                        const ThumbnailCallback& callback);
+
+ private:
+  explicit WebContentsThumbnailHelper(content::WebContents* web_contents);
+  friend class content::WebContentsUserData<WebContentsThumbnailHelper>;
+
+  // content::WebContentsObserver:
+  void DidFinishNavigation(
+      content::NavigationHandle* navigation_handle) override;
+  void DidFirstVisuallyNonEmptyPaint() override;
+  void DidStopLoading() override;
+  void DidGetUserInteraction(const blink::WebInputEvent::Type type) override;
+
+  void OnCopyFromSurface(const Params& params,
+                         const SkBitmap& bitmap,
+                         content::ReadbackResponse response);
+  void OnThumbnailEncoded(const Params& params,
+                          scoped_refptr<base::RefCountedBytes> data);
+  void RunCallbacks(const std::string& key,
+                    scoped_refptr<base::RefCountedBytes> data);
+  void SetCachedThumbnail(const std::string& key,
+                          scoped_refptr<base::RefCountedBytes> data);
+  void ClearCachedThumbnail();
+
+  // The last thumbnail captured, and whether the page changed since.
+  std::string cached_key_;
+  scoped_refptr<base::RefCountedBytes> cached_data_;
+  bool stale_;
+  base::TimeTicks last_capture_time_;
+  base::Optional<base::TimeDelta> min_capture_interval_;
+
+  // Callbacks waiting for an in-flight capture, by Params::ToKey.
+  std::map<std::string, std::vector<ThumbnailCallback>> pending_callbacks_;
+
+  base::WeakPtrFactory<WebContentsThumbnailHelper> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebContentsThumbnailHelper);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_WEB_CONTENTS_THUMBNAIL_HELPER_H_
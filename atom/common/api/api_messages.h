@@ -9,6 +9,7 @@
 #include "base/values.h"
 #include "content/public/common/common_param_traits.h"
 #include "ipc/ipc_message_macros.h"
+#include "ipc/ipc_platform_file.h"
 #include "ui/gfx/ipc/gfx_param_traits.h"
 
 // The message starter should be declared in ipc/ipc_message_start.h. Since
@@ -29,6 +30,12 @@ IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message_Shared,
                     base::string16 /* channel */,
                     base::SharedMemoryHandle /* arguments */)
 
+// Tells the browser whether any script context of the renderer listens on
+// |channel|, so AtomViewMsg_Message is only sent for channels with a listener.
+IPC_MESSAGE_CONTROL2(AtomViewHostMsg_SetChannelSubscribed,
+                     base::string16 /* channel */,
+                     bool /* subscribed */)
+
 IPC_MESSAGE_ROUTED2(AtomViewMsg_Message,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
@@ -45,3 +52,35 @@ IPC_MESSAGE_CONTROL1(AtomMsg_UpdateContentSettings, base::DictionaryValue)
 
 // Update renderer content settings
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdateWebKitPrefs, content::WebPreferences)
+
+// Asks the renderer for the size of its main thread V8 heap.
+IPC_MESSAGE_CONTROL0(AtomMsg_RequestV8HeapStats)
+
+IPC_MESSAGE_CONTROL2(AtomViewHostMsg_V8HeapStats,
+                     uint64_t /* heap size */,
+                     uint64_t /* used heap size */)
+
+// Suspends or resumes the timers of all the pages of the renderer.
+IPC_MESSAGE_CONTROL1(AtomMsg_SetTimersSuspended, bool /* suspended */)
+
+// Starts profiling the main thread isolate of the renderer. An interval of 0
+// leaves that profiler off.
+IPC_MESSAGE_CONTROL2(AtomMsg_StartV8Profiling,
+                     uint64_t /* heap sampling interval */,
+                     int /* cpu sampling interval */)
+
+// Stops profiling and writes the profiles to the file.
+IPC_MESSAGE_CONTROL2(AtomMsg_StopV8Profiling,
+                     int /* request id */,
+                     IPC::PlatformFileForTransit /* file */)
+
+// Writes a heap snapshot of the main thread isolate to the file.
+IPC_MESSAGE_CONTROL2(AtomMsg_WriteV8HeapSnapshot,
+                     int /* request id */,
+                     IPC::PlatformFileForTransit /* file */)
+
+// Replies to AtomMsg_StopV8Profiling and AtomMsg_WriteV8HeapSnapshot once the
+// file is written.
+IPC_MESSAGE_CONTROL2(AtomViewHostMsg_V8ProfilingDone,
+                     int /* request id */,
+                     bool /* success */)
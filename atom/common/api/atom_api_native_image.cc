@@ -2,6 +2,8 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -9,27 +11,38 @@
 
 #include "atom/common/api/atom_api_native_image.h"
 
+#include "atom/common/api/native_image_cache.h"
+#include "atom/common/asar/archive.h"
 #include "atom/common/asar/asar_util.h"
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
+#include "atom/common/native_mate_converters/value_converter.h"
 #include "base/base64.h"
 #include "base/files/file_util.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/values.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/base/data_url.h"
+#include "skia/ext/image_operations.h"
+#include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/skia/include/encode/SkWebpEncoder.h"
 #include "ui/base/layout.h"
 #include "ui/gfx/codec/jpeg_codec.h"
 #include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/size.h"
 #include "ui/gfx/image/image_skia.h"
 #include "ui/gfx/image/image_util.h"
 
 #if defined(OS_WIN)
-#include "atom/common/asar/archive.h"
 #include "base/win/scoped_gdi_object.h"
 #include "ui/gfx/icon_util.h"
 #endif
@@ -78,10 +91,10 @@ float GetScaleFactorFromPath(const base::FilePath& path) {
   return 1.0f;
 }
 
-bool AddImageSkiaRep(gfx::ImageSkia* image,
-                     const unsigned char* data,
-                     size_t size,
-                     double scale_factor) {
+bool DecodeImageSkiaRep(const unsigned char* data,
+                        size_t size,
+                        double scale_factor,
+                        gfx::ImageSkiaRep* rep) {
   std::unique_ptr<SkBitmap> decoded(new SkBitmap());
 
   // Try PNG first.
@@ -92,41 +105,132 @@ bool AddImageSkiaRep(gfx::ImageSkia* image,
   if (!decoded)
     return false;
 
-  image->AddRepresentation(gfx::ImageSkiaRep(*decoded, scale_factor));
+  *rep = gfx::ImageSkiaRep(*decoded, scale_factor);
   return true;
 }
 
 bool AddImageSkiaRep(gfx::ImageSkia* image,
-                     const base::FilePath& path,
+                     const unsigned char* data,
+                     size_t size,
                      double scale_factor) {
+  gfx::ImageSkiaRep rep;
+  if (!DecodeImageSkiaRep(data, size, scale_factor, &rep))
+    return false;
+
+  image->AddRepresentation(rep);
+  return true;
+}
+
+// The still encoded contents of one scale factor of an image file.
+struct EncodedImageRep {
+  base::FilePath path;
+  base::Time last_modified;
+  std::string data;
+  float scale;
+};
+
+// Images inside an asar archive use the modification time of the archive.
+bool GetImageLastModified(const base::FilePath& path,
+                          base::Time* last_modified) {
+  base::File::Info info;
+  base::FilePath asar_path, relative_path;
+  if (asar::GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    std::shared_ptr<asar::Archive> archive =
+        asar::GetOrCreateAsarArchive(asar_path);
+    asar::Archive::FileInfo file_info;
+    if (!archive || !archive->GetFileInfo(relative_path, &file_info) ||
+        !base::GetFileInfo(asar_path, &info))
+      return false;
+  } else if (!base::GetFileInfo(path, &info) || info.is_directory) {
+    return false;
+  }
+
+  *last_modified = info.last_modified;
+  return true;
+}
+
+// Adds the decoded rep to |cached_reps| when it is in the NativeImageCache,
+// otherwise reads the file into |encoded_reps|.
+bool ReadEncodedImageRep(const base::FilePath& path,
+                         float scale_factor,
+                         std::vector<gfx::ImageSkiaRep>* cached_reps,
+                         std::vector<EncodedImageRep>* encoded_reps) {
   base::ThreadRestrictions::SetIOAllowed(true);   // TODO(bridiver) ugh electron
-  std::string file_contents;
-  if (!asar::ReadFileToString(path, &file_contents))
+  base::Time last_modified;
+  if (!GetImageLastModified(path, &last_modified))
     return false;
 
-  const unsigned char* data =
-      reinterpret_cast<const unsigned char*>(file_contents.data());
-  size_t size = file_contents.size();
-  return AddImageSkiaRep(image, data, size, scale_factor);
+  gfx::ImageSkiaRep cached_rep;
+  if (NativeImageCache::GetInstance()->Get(
+          path, last_modified, scale_factor, &cached_rep)) {
+    cached_reps->push_back(cached_rep);
+    return true;
+  }
+
+  EncodedImageRep rep;
+  if (!asar::ReadFileToString(path, &rep.data))
+    return false;
+
+  rep.path = path;
+  rep.last_modified = last_modified;
+  rep.scale = scale_factor;
+  encoded_reps->push_back(std::move(rep));
+  return true;
 }
 
-bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
-                                   const base::FilePath& path) {
+// Looks up |path| and all of its @Nx variants in the cache and reads the
+// ones that aren't cached without decoding them.
+bool ReadEncodedImageRepsFromPath(const base::FilePath& path,
+                                  std::vector<gfx::ImageSkiaRep>* cached_reps,
+                                  std::vector<EncodedImageRep>* encoded_reps) {
   bool succeed = false;
   std::string filename(path.BaseName().RemoveExtension().AsUTF8Unsafe());
   if (base::MatchPattern(filename, "*@*x"))
     // Don't search for other representations if the DPI has been specified.
-    return AddImageSkiaRep(image, path, GetScaleFactorFromPath(path));
+    return ReadEncodedImageRep(path, GetScaleFactorFromPath(path),
+                               cached_reps, encoded_reps);
   else
-    succeed |= AddImageSkiaRep(image, path, 1.0f);
+    succeed |= ReadEncodedImageRep(path, 1.0f, cached_reps, encoded_reps);
 
   for (const ScaleFactorPair& pair : kScaleFactorPairs)
-    succeed |= AddImageSkiaRep(image,
-                               path.InsertBeforeExtensionASCII(pair.name),
-                               pair.scale);
+    succeed |= ReadEncodedImageRep(path.InsertBeforeExtensionASCII(pair.name),
+                                   pair.scale,
+                                   cached_reps,
+                                   encoded_reps);
   return succeed;
 }
 
+// Decodes |encoded_reps| into |reps| and adds them to the NativeImageCache.
+void DecodeImageSkiaReps(const std::vector<EncodedImageRep>& encoded_reps,
+                         std::vector<gfx::ImageSkiaRep>* reps) {
+  for (const auto& encoded_rep : encoded_reps) {
+    gfx::ImageSkiaRep rep;
+    if (!DecodeImageSkiaRep(
+        reinterpret_cast<const unsigned char*>(encoded_rep.data.data()),
+        encoded_rep.data.size(),
+        encoded_rep.scale,
+        &rep))
+      continue;
+
+    NativeImageCache::GetInstance()->Put(
+        encoded_rep.path, encoded_rep.last_modified, encoded_rep.scale, rep);
+    reps->push_back(rep);
+  }
+}
+
+bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
+                                   const base::FilePath& path) {
+  std::vector<gfx::ImageSkiaRep> reps;
+  std::vector<EncodedImageRep> encoded_reps;
+  if (!ReadEncodedImageRepsFromPath(path, &reps, &encoded_reps))
+    return false;
+
+  DecodeImageSkiaReps(encoded_reps, &reps);
+  for (const auto& rep : reps)
+    image->AddRepresentation(rep);
+  return !reps.empty();
+}
+
 base::FilePath NormalizePath(const base::FilePath& path) {
   if (!path.ReferencesParent()) {
     return path;
@@ -158,7 +262,7 @@ base::win::ScopedHICON ReadICOFromPath(int size, const base::FilePath& path) {
     std::shared_ptr<asar::Archive> archive =
         asar::GetOrCreateAsarArchive(asar_path);
     if (archive)
-      archive->CopyFileOut(relative_path, &image_path);
+      archive->CopyFileOutForRead(relative_path, &image_path);
   }
 
   // Load the icon from file.
@@ -181,8 +285,246 @@ bool ReadImageSkiaFromICO(gfx::ImageSkia* image, HICON icon) {
 void Noop(char*, void*) {
 }
 
+// A crop, resize or encode step of NativeImage::ProcessAsync.
+struct ImageOperation {
+  enum Type { CROP, RESIZE, ENCODE };
+
+  Type type;
+  gfx::Rect rect;
+  gfx::Size size;
+  skia::ImageOperations::ResizeMethod resize_method;
+  std::string format;
+  int quality;
+};
+
+// The result of a background decode or process operation. It is converted
+// into a NativeImage, or a Buffer for encoded data, on the thread that
+// started the operation.
+struct AsyncImageResult {
+  AsyncImageResult() : encoded(false) {}
+
+  std::string error;
+  std::vector<gfx::ImageSkiaRep> reps;
+  bool encoded;
+  std::vector<unsigned char> data;
+};
+
+// Passed to the callbacks as null when |message| is empty.
+struct AsyncImageError {
+  std::string message;
+};
+
+using AsyncImageCallback =
+    base::Callback<void(const AsyncImageError&, const AsyncImageResult&)>;
+
+bool ParseImageOperation(mate::Dictionary dict,
+                         ImageOperation* operation,
+                         std::string* error) {
+  std::string type;
+  dict.Get("type", &type);
+  if (type == "crop") {
+    int x = 0, y = 0, width = 0, height = 0;
+    dict.Get("x", &x);
+    dict.Get("y", &y);
+    if (!dict.Get("width", &width) || !dict.Get("height", &height) ||
+        width <= 0 || height <= 0) {
+      *error = "crop requires a positive width and height";
+      return false;
+    }
+    operation->type = ImageOperation::CROP;
+    operation->rect = gfx::Rect(x, y, width, height);
+  } else if (type == "resize") {
+    int width = 0, height = 0;
+    if (!dict.Get("width", &width) || !dict.Get("height", &height) ||
+        width <= 0 || height <= 0) {
+      *error = "resize requires a positive width and height";
+      return false;
+    }
+    std::string quality = "good";
+    dict.Get("quality", &quality);
+    operation->type = ImageOperation::RESIZE;
+    operation->size = gfx::Size(width, height);
+    if (quality == "best")
+      operation->resize_method = skia::ImageOperations::RESIZE_BEST;
+    else if (quality == "better")
+      operation->resize_method = skia::ImageOperations::RESIZE_BETTER;
+    else
+      operation->resize_method = skia::ImageOperations::RESIZE_GOOD;
+  } else if (type == "encode") {
+    operation->type = ImageOperation::ENCODE;
+    operation->format = "png";
+    operation->quality = 90;
+    dict.Get("format", &operation->format);
+    dict.Get("quality", &operation->quality);
+    if (operation->format != "png" && operation->format != "jpeg" &&
+        operation->format != "webp") {
+      *error = "Unsupported encode format " + operation->format;
+      return false;
+    }
+    if (operation->quality < 0 || operation->quality > 100) {
+      *error = "encode quality must be between 0 and 100";
+      return false;
+    }
+  } else {
+    *error = "Unknown image operation " + type;
+    return false;
+  }
+  return true;
+}
+
+bool EncodeBitmap(const SkBitmap& bitmap,
+                  const std::string& format,
+                  int quality,
+                  std::vector<unsigned char>* output) {
+  if (format == "png")
+    return gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, output);
+
+  if (format == "jpeg")
+    return gfx::JPEGCodec::Encode(bitmap, quality, output);
+
+  SkPixmap pixmap;
+  if (!bitmap.peekPixels(&pixmap))
+    return false;
+
+  SkDynamicMemoryWStream stream;
+  SkWebpEncoder::Options options;
+  options.fQuality = quality;
+  if (!SkWebpEncoder::Encode(&stream, pixmap, options))
+    return false;
+
+  sk_sp<SkData> data = stream.detachAsData();
+  output->assign(data->bytes(), data->bytes() + data->size());
+  return true;
+}
+
+// Runs on the task scheduler. Crops share pixels with their source and each
+// resize produces the input of the next step, so no intermediate gfx::Image
+// or ImageSkia is ever created. Rects and sizes are in DIPs and |bitmap| has
+// |scale| pixels per DIP.
+std::unique_ptr<AsyncImageResult> ProcessBitmap(
+    SkBitmap bitmap,
+    float scale,
+    const std::vector<ImageOperation>& operations) {
+  std::unique_ptr<AsyncImageResult> result(new AsyncImageResult);
+  for (const auto& operation : operations) {
+    switch (operation.type) {
+      case ImageOperation::CROP: {
+        gfx::Rect pixels = gfx::ScaleToEnclosingRect(operation.rect, scale);
+        SkIRect rect = SkIRect::MakeXYWH(pixels.x(), pixels.y(),
+                                         pixels.width(), pixels.height());
+        // extractSubset() clips the rect to the bitmap instead of failing.
+        SkBitmap subset;
+        if (!SkIRect::MakeWH(bitmap.width(), bitmap.height()).contains(rect) ||
+            !bitmap.extractSubset(&subset, rect)) {
+          result->error = "Crop rect is outside of the image";
+          return result;
+        }
+        bitmap = subset;
+        break;
+      }
+      case ImageOperation::RESIZE: {
+        gfx::Size pixels = gfx::ScaleToRoundedSize(operation.size, scale);
+        bitmap = skia::ImageOperations::Resize(bitmap,
+                                               operation.resize_method,
+                                               pixels.width(),
+                                               pixels.height());
+        break;
+      }
+      case ImageOperation::ENCODE:
+        if (!EncodeBitmap(bitmap, operation.format, operation.quality,
+                          &result->data)) {
+          result->error = "Failed to encode image";
+          return result;
+        }
+        result->encoded = true;
+        return result;
+    }
+  }
+
+  result->reps.push_back(gfx::ImageSkiaRep(bitmap, scale));
+  return result;
+}
+
+std::unique_ptr<AsyncImageResult> DecodeEncodedImageReps(
+    std::unique_ptr<std::vector<gfx::ImageSkiaRep>> cached_reps,
+    std::unique_ptr<std::vector<EncodedImageRep>> encoded_reps) {
+  std::unique_ptr<AsyncImageResult> result(new AsyncImageResult);
+  result->reps.swap(*cached_reps);
+  DecodeImageSkiaReps(*encoded_reps, &result->reps);
+  if (result->reps.empty())
+    result->error = "Failed to decode image";
+  return result;
+}
+
+std::unique_ptr<AsyncImageResult> ReadAndDecodeImage(
+    const base::FilePath& path) {
+  std::unique_ptr<std::vector<gfx::ImageSkiaRep>> cached_reps(
+      new std::vector<gfx::ImageSkiaRep>);
+  std::unique_ptr<std::vector<EncodedImageRep>> encoded_reps(
+      new std::vector<EncodedImageRep>);
+  ReadEncodedImageRepsFromPath(path, cached_reps.get(), encoded_reps.get());
+  return DecodeEncodedImageReps(std::move(cached_reps),
+                                std::move(encoded_reps));
+}
+
+void RunAsyncImageCallback(const AsyncImageCallback& callback,
+                           std::unique_ptr<AsyncImageResult> result) {
+  callback.Run({result->error}, *result);
+}
+
+void PostAsyncImageError(const AsyncImageCallback& callback,
+                         const std::string& error) {
+  std::unique_ptr<AsyncImageResult> result(new AsyncImageResult);
+  result->error = error;
+  base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+      base::Bind(&RunAsyncImageCallback, callback, base::Passed(&result)));
+}
+
 }  // namespace
 
+}  // namespace api
+
+}  // namespace atom
+
+namespace mate {
+
+template<>
+struct Converter<atom::api::AsyncImageError> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   const atom::api::AsyncImageError& val) {
+    if (val.message.empty())
+      return v8::Null(isolate);
+    return StringToV8(isolate, val.message);
+  }
+};
+
+template<>
+struct Converter<atom::api::AsyncImageResult> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   const atom::api::AsyncImageResult& val) {
+    if (!val.error.empty())
+      return v8::Null(isolate);
+
+    if (val.encoded) {
+      return node::Buffer::Copy(isolate,
+                                reinterpret_cast<const char*>(val.data.data()),
+                                val.data.size()).ToLocalChecked();
+    }
+
+    gfx::ImageSkia image_skia;
+    for (const auto& rep : val.reps)
+      image_skia.AddRepresentation(rep);
+    return atom::api::NativeImage::Create(
+        isolate, gfx::Image(image_skia)).ToV8();
+  }
+};
+
+}  // namespace mate
+
+namespace atom {
+
+namespace api {
+
 NativeImage::NativeImage(v8::Isolate* isolate, const gfx::Image& image)
     : image_(image) {
   Init(isolate);
@@ -278,6 +620,49 @@ v8::Local<v8::Value> NativeImage::GetNativeHandle(v8::Isolate* isolate,
 #endif
 }
 
+void NativeImage::ProcessAsync(mate::Arguments* args) {
+  std::vector<mate::Dictionary> dicts;
+  AsyncImageCallback callback;
+  if (!args->GetNext(&dicts) || !args->GetNext(&callback)) {
+    args->ThrowError("Expected an array of operations and a callback");
+    return;
+  }
+
+  std::vector<ImageOperation> operations;
+  for (const auto& dict : dicts) {
+    if (!operations.empty() &&
+        operations.back().type == ImageOperation::ENCODE) {
+      args->ThrowError("encode must be the last operation");
+      return;
+    }
+    ImageOperation operation;
+    std::string error;
+    if (!ParseImageOperation(dict, &operation, &error)) {
+      args->ThrowError(error);
+      return;
+    }
+    operations.push_back(operation);
+  }
+
+  if (image_.IsEmpty()) {
+    PostAsyncImageError(callback, "Image is empty");
+    return;
+  }
+
+  // Only the SkBitmap, which shares its pixels with |image_|, crosses
+  // threads. gfx::Image and ImageSkia must stay on this thread.
+  float scale = 1.0f;
+  for (const auto& rep : image_.AsImageSkia().image_reps()) {
+    if (rep.scale() > scale)
+      scale = rep.scale();
+  }
+  const gfx::ImageSkiaRep& rep = image_.AsImageSkia().GetRepresentation(scale);
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+      base::Bind(&ProcessBitmap, rep.sk_bitmap(), rep.scale(), operations),
+      base::Bind(&RunAsyncImageCallback, callback));
+}
+
 bool NativeImage::IsEmpty() {
   return image_.IsEmpty();
 }
@@ -343,6 +728,40 @@ mate::Handle<NativeImage> NativeImage::CreateFromPath(
   return handle;
 }
 
+// static
+void NativeImage::CreateFromPathAsync(mate::Arguments* args) {
+  base::FilePath path;
+  AsyncImageCallback callback;
+  if (!args->GetNext(&path) || !args->GetNext(&callback)) {
+    args->ThrowError("Expected a path and a callback");
+    return;
+  }
+
+  base::FilePath image_path = NormalizePath(path);
+  base::FilePath asar_path, relative_path;
+  if (!asar::GetAsarArchivePath(image_path, &asar_path, &relative_path)) {
+    base::PostTaskWithTraitsAndReplyWithResult(
+        FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+        base::Bind(&ReadAndDecodeImage, image_path),
+        base::Bind(&RunAsyncImageCallback, callback));
+    return;
+  }
+
+  // The asar archive map isn't thread safe, but reading from an archive is
+  // only a copy out of memory so just the decode is done in the background.
+  std::unique_ptr<std::vector<gfx::ImageSkiaRep>> cached_reps(
+      new std::vector<gfx::ImageSkiaRep>);
+  std::unique_ptr<std::vector<EncodedImageRep>> encoded_reps(
+      new std::vector<EncodedImageRep>);
+  ReadEncodedImageRepsFromPath(image_path, cached_reps.get(),
+                               encoded_reps.get());
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+      base::Bind(&DecodeEncodedImageReps, base::Passed(&cached_reps),
+                 base::Passed(&encoded_reps)),
+      base::Bind(&RunAsyncImageCallback, callback));
+}
+
 // static
 mate::Handle<NativeImage> NativeImage::CreateFromBuffer(
     mate::Arguments* args, v8::Local<v8::Value> buffer) {
@@ -386,6 +805,7 @@ void NativeImage::BuildPrototype(
       .SetMethod("getSize", &NativeImage::GetSize)
       .SetMethod("setTemplateImage", &NativeImage::SetTemplateImage)
       .SetMethod("isTemplateImage", &NativeImage::IsTemplateImage)
+      .SetMethod("processAsync", &NativeImage::ProcessAsync)
       // TODO(kevinsawicki): Remove in 2.0, deprecate before then with warnings
       .SetMethod("toPng", &NativeImage::ToPNG)
       .SetMethod("toJpeg", &NativeImage::ToJPEG);
@@ -427,14 +847,42 @@ bool Converter<mate::Handle<atom::api::NativeImage>>::FromV8(
 
 namespace {
 
+v8::Local<v8::Value> GetCacheStats(v8::Isolate* isolate) {
+  std::unique_ptr<base::DictionaryValue> stats =
+      atom::api::NativeImageCache::GetInstance()->GetStats();
+  return mate::ConvertToV8(isolate, *stats);
+}
+
+void SetCacheSize(mate::Arguments* args) {
+  double max_size;
+  if (!args->GetNext(&max_size) || !std::isfinite(max_size) || max_size < 0) {
+    args->ThrowError("`maxSize` must be a non-negative number");
+    return;
+  }
+  // Sizes past the address space just mean no limit.
+  const double kMaxSize = std::numeric_limits<size_t>::max();
+  atom::api::NativeImageCache::GetInstance()->SetMaxSize(
+      max_size >= kMaxSize ? std::numeric_limits<size_t>::max()
+                           : static_cast<size_t>(max_size));
+}
+
+void ClearCache() {
+  atom::api::NativeImageCache::GetInstance()->Clear();
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("createEmpty", &atom::api::NativeImage::CreateEmpty);
   dict.SetMethod("createFromPath", &atom::api::NativeImage::CreateFromPath);
+  dict.SetMethod("createFromPathAsync",
+                 &atom::api::NativeImage::CreateFromPathAsync);
   dict.SetMethod("createFromBuffer", &atom::api::NativeImage::CreateFromBuffer);
   dict.SetMethod("createFromDataURL",
                  &atom::api::NativeImage::CreateFromDataURL);
+  dict.SetMethod("getCacheStats", &GetCacheStats);
+  dict.SetMethod("setCacheSize", &SetCacheSize);
+  dict.SetMethod("clearCache", &ClearCache);
 }
 
 }  // namespace
@@ -46,6 +46,8 @@ class NativeImage : public mate::Wrappable<NativeImage> {
       v8::Isolate* isolate, const char* buffer, size_t length);
   static mate::Handle<NativeImage> CreateFromPath(
       v8::Isolate* isolate, const base::FilePath& path);
+  // Reads and decodes the image on the task scheduler.
+  static void CreateFromPathAsync(mate::Arguments* args);
   static mate::Handle<NativeImage> CreateFromBuffer(
       mate::Arguments* args, v8::Local<v8::Value> buffer);
   static mate::Handle<NativeImage> CreateFromDataURL(
@@ -76,6 +78,8 @@ class NativeImage : public mate::Wrappable<NativeImage> {
     v8::Isolate* isolate,
     mate::Arguments* args);
   std::string ToDataURL();
+  // Runs a list of crop/resize/encode operations on the task scheduler.
+  void ProcessAsync(mate::Arguments* args);
   bool IsEmpty();
   gfx::Size GetSize();
 
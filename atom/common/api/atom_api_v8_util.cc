@@ -8,8 +8,13 @@
 #include "atom/common/api/atom_api_key_weak_map.h"
 #include "atom/common/api/remote_callback_freer.h"
 #include "atom/common/api/remote_object_freer.h"
+#include "atom/common/code_cache.h"
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/content_converter.h"
+#include "atom/common/native_mate_converters/file_path_converter.h"
+#include "atom/common/native_mate_converters/v8_profiler_converter.h"
 #include "atom/common/node_includes.h"
+#include "atom/common/v8_profiler.h"
 #include "base/hash.h"
 #include "native_mate/dictionary.h"
 #include "v8/include/v8-profiler.h"
@@ -92,6 +97,65 @@ void TakeHeapSnapshot(v8::Isolate* isolate) {
   isolate->GetHeapProfiler()->TakeHeapSnapshot();
 }
 
+v8::Local<v8::Value> GetCodeCache(v8::Isolate* isolate,
+                                  const std::string& path,
+                                  const std::string& source) {
+  std::string data;
+  if (!atom::CodeCache::GetInstance()->Get(path, source, &data))
+    return v8::Undefined(isolate);
+  return node::Buffer::Copy(isolate, data.data(), data.size())
+      .ToLocalChecked();
+}
+
+void SetCodeCache(const std::string& path,
+                  const std::string& source,
+                  v8::Local<v8::Value> buffer) {
+  if (!node::Buffer::HasInstance(buffer))
+    return;
+  atom::CodeCache::GetInstance()->Put(
+      path, source,
+      std::string(node::Buffer::Data(buffer), node::Buffer::Length(buffer)));
+}
+
+void RejectCodeCache(const std::string& path) {
+  atom::CodeCache::GetInstance()->Reject(path);
+}
+
+v8::Local<v8::Value> GetCodeCacheStats(v8::Isolate* isolate) {
+  atom::CodeCache::Stats stats = atom::CodeCache::GetInstance()->stats();
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("enabled", atom::CodeCache::GetInstance()->enabled());
+  dict.Set("directory", atom::CodeCache::GetInstance()->directory());
+  dict.Set("hits", static_cast<double>(stats.hits));
+  dict.Set("misses", static_cast<double>(stats.misses));
+  dict.Set("rejected", static_cast<double>(stats.rejected));
+  dict.Set("stored", static_cast<double>(stats.stored));
+  return dict.GetHandle();
+}
+
+bool StartProfiling(mate::Arguments* args) {
+  atom::V8Profiler::Options options;
+  if (args->Length() > 0 && !args->GetNext(&options)) {
+    args->ThrowError("Invalid profiling options");
+    return false;
+  }
+  return atom::V8Profiler::From(args->isolate())->Start(options);
+}
+
+void StopProfiling(v8::Isolate* isolate,
+                   int fd,
+                   const atom::V8Profiler::DoneCallback& callback) {
+  atom::V8Profiler::From(isolate)->Stop(atom::DuplicateFileDescriptor(fd),
+                                        callback);
+}
+
+void WriteHeapSnapshot(v8::Isolate* isolate,
+                       int fd,
+                       const atom::V8Profiler::DoneCallback& callback) {
+  atom::V8Profiler::From(isolate)->WriteHeapSnapshot(
+      atom::DuplicateFileDescriptor(fd), callback);
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
@@ -100,6 +164,13 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("deleteHiddenValue", &DeleteHiddenValue);
   dict.SetMethod("getObjectHash", &GetObjectHash);
   dict.SetMethod("takeHeapSnapshot", &TakeHeapSnapshot);
+  dict.SetMethod("startProfiling", &StartProfiling);
+  dict.SetMethod("stopProfiling", &StopProfiling);
+  dict.SetMethod("writeHeapSnapshot", &WriteHeapSnapshot);
+  dict.SetMethod("getCodeCache", &GetCodeCache);
+  dict.SetMethod("setCodeCache", &SetCodeCache);
+  dict.SetMethod("rejectCodeCache", &RejectCodeCache);
+  dict.SetMethod("getCodeCacheStats", &GetCodeCacheStats);
   dict.SetMethod("setRemoteCallbackFreer", &atom::RemoteCallbackFreer::BindTo);
   dict.SetMethod("setRemoteObjectFreer", &atom::RemoteObjectFreer::BindTo);
   dict.SetMethod("createIDWeakMap", &atom::api::KeyWeakMap<int32_t>::Create);
@@ -0,0 +1,126 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/api/native_image_cache.h"
+
+#include <tuple>
+
+#include "base/memory/singleton.h"
+#include "base/values.h"
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+const size_t kDefaultMaxSize = 32 * 1024 * 1024;
+
+size_t GetRepSize(const gfx::ImageSkiaRep& rep) {
+  return rep.sk_bitmap().computeByteSize();
+}
+
+}  // namespace
+
+bool NativeImageCache::Key::operator<(const Key& other) const {
+  return std::tie(path, last_modified, scale) <
+      std::tie(other.path, other.last_modified, other.scale);
+}
+
+// static
+NativeImageCache* NativeImageCache::GetInstance() {
+  return base::Singleton<NativeImageCache>::get();
+}
+
+NativeImageCache::NativeImageCache()
+    : cache_(base::MRUCache<Key, gfx::ImageSkiaRep>::NO_AUTO_EVICT),
+      size_(0),
+      max_size_(kDefaultMaxSize),
+      hits_(0),
+      misses_(0),
+      evictions_(0) {
+}
+
+NativeImageCache::~NativeImageCache() {
+}
+
+bool NativeImageCache::Get(const base::FilePath& path,
+                           const base::Time& last_modified,
+                           float scale,
+                           gfx::ImageSkiaRep* rep) {
+  base::AutoLock auto_lock(lock_);
+  auto it = cache_.Get(Key{path, last_modified, scale});
+  if (it == cache_.end()) {
+    misses_++;
+    return false;
+  }
+
+  hits_++;
+  *rep = it->second;
+  return true;
+}
+
+void NativeImageCache::Put(const base::FilePath& path,
+                           const base::Time& last_modified,
+                           float scale,
+                           const gfx::ImageSkiaRep& rep) {
+  size_t rep_size = GetRepSize(rep);
+  base::AutoLock auto_lock(lock_);
+  if (rep_size > max_size_)
+    return;
+
+  Key key{path, last_modified, scale};
+  auto it = cache_.Peek(key);
+  if (it != cache_.end()) {
+    size_ -= GetRepSize(it->second);
+    cache_.Erase(it);
+  }
+
+  // The pixels are shared with every NativeImage handed out for this entry.
+  SkBitmap bitmap = rep.sk_bitmap();
+  bitmap.setImmutable();
+  cache_.Put(key, gfx::ImageSkiaRep(bitmap, rep.scale()));
+  size_ += rep_size;
+  EvictIfNeeded();
+}
+
+void NativeImageCache::SetMaxSize(size_t max_size) {
+  base::AutoLock auto_lock(lock_);
+  max_size_ = max_size;
+  EvictIfNeeded();
+}
+
+size_t NativeImageCache::Clear() {
+  base::AutoLock auto_lock(lock_);
+  const size_t size = size_;
+  cache_.Clear();
+  size_ = 0;
+  return size;
+}
+
+void NativeImageCache::EvictIfNeeded() {
+  lock_.AssertAcquired();
+  while (size_ > max_size_ && !cache_.empty()) {
+    auto it = cache_.rbegin();
+    size_ -= GetRepSize(it->second);
+    cache_.Erase(it);
+    evictions_++;
+  }
+}
+
+std::unique_ptr<base::DictionaryValue> NativeImageCache::GetStats() {
+  std::unique_ptr<base::DictionaryValue> stats(new base::DictionaryValue);
+  base::AutoLock auto_lock(lock_);
+  stats->SetDouble("hits", static_cast<double>(hits_));
+  stats->SetDouble("misses", static_cast<double>(misses_));
+  stats->SetDouble("evictions", static_cast<double>(evictions_));
+  stats->SetInteger("count", static_cast<int>(cache_.size()));
+  stats->SetDouble("size", static_cast<double>(size_));
+  stats->SetDouble("maxSize", static_cast<double>(max_size_));
+  return stats;
+}
+
+}  // namespace api
+
+}  // namespace atom
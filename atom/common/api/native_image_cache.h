@@ -0,0 +1,81 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_API_NATIVE_IMAGE_CACHE_H_
+#define ATOM_COMMON_API_NATIVE_IMAGE_CACHE_H_
+
+#include <memory>
+
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "ui/gfx/image/image_skia_rep.h"
+
+namespace base {
+class DictionaryValue;
+template <typename T> struct DefaultSingletonTraits;
+}
+
+namespace atom {
+
+namespace api {
+
+// Process wide LRU cache of decoded image files keyed by path, modification
+// time and scale factor. Cached reps share their pixels with every
+// NativeImage created from them. The cache is used from the thread that
+// creates images and from the task scheduler, so all access is locked.
+class NativeImageCache {
+ public:
+  static NativeImageCache* GetInstance();
+
+  bool Get(const base::FilePath& path,
+           const base::Time& last_modified,
+           float scale,
+           gfx::ImageSkiaRep* rep);
+  void Put(const base::FilePath& path,
+           const base::Time& last_modified,
+           float scale,
+           const gfx::ImageSkiaRep& rep);
+
+  void SetMaxSize(size_t max_size);
+  // Returns the number of bytes that were cached.
+  size_t Clear();
+
+  std::unique_ptr<base::DictionaryValue> GetStats();
+
+ private:
+  friend struct base::DefaultSingletonTraits<NativeImageCache>;
+
+  struct Key {
+    base::FilePath path;
+    base::Time last_modified;
+    float scale;
+
+    bool operator<(const Key& other) const;
+  };
+
+  NativeImageCache();
+  ~NativeImageCache();
+
+  // Must be called with |lock_| held.
+  void EvictIfNeeded();
+
+  base::Lock lock_;
+  base::MRUCache<Key, gfx::ImageSkiaRep> cache_;
+  size_t size_;
+  size_t max_size_;
+  uint64_t hits_;
+  uint64_t misses_;
+  uint64_t evictions_;
+
+  DISALLOW_COPY_AND_ASSIGN(NativeImageCache);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_API_NATIVE_IMAGE_CACHE_H_
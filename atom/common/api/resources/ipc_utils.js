@@ -34,6 +34,33 @@ if (!ipcRenderer) {
     }
     return $Function.apply(EventEmitter.prototype.emit, ipcRenderer, arguments)
   }
+
+  // The browser only sends messages for channels that have a listener in
+  // some context of the renderer, so keep it informed as listeners change
+  var updateSubscription = function (channel) {
+    if (typeof channel === 'string') {
+      ipc.setChannelSubscribed(channel, ipcRenderer.listenerCount(channel) > 0)
+    }
+  }
+
+  var subscribingMethods = ['on', 'addListener', 'prependListener', 'once',
+    'prependOnceListener', 'removeListener', 'off']
+  $Array.forEach(subscribingMethods, function (name) {
+    var method = EventEmitter.prototype[name]
+    ipcRenderer[name] = function (channel) {
+      var result = $Function.apply(method, ipcRenderer, arguments)
+      updateSubscription(channel)
+      return result
+    }
+  })
+
+  ipcRenderer.removeAllListeners = function (channel) {
+    var channels = arguments.length === 0 ? ipcRenderer.eventNames() : [channel]
+    var result = $Function.apply(EventEmitter.prototype.removeAllListeners,
+      ipcRenderer, arguments)
+    $Array.forEach(channels, updateSubscription)
+    return result
+  }
   atom.v8.setHiddenValue('ipc', ipcRenderer)
 }
 
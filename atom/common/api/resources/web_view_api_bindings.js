@@ -115,9 +115,55 @@ WebViewImpl.prototype.attachGuest = function (guestInstanceId) {
   }
 }
 
+// The browser only forwards these events while the element has listeners for
+// them. Listeners removed by {once: true} are not seen, the event keeps being
+// forwarded until the tab changes.
+const lazyEvents = [
+  'did-get-response-details'
+]
+
+const setupElementProperties = WebViewImpl.prototype.setupElementProperties
+WebViewImpl.prototype.setupElementProperties = function () {
+  setupElementProperties.apply(this, arguments)
+
+  const element = this.element
+  const addEventListener = element.addEventListener
+  const removeEventListener = element.removeEventListener
+  this.lazyListeners_ = {}
+
+  element.addEventListener = (type, listener, options) => {
+    addEventListener.call(element, type, listener, options)
+    if (!lazyEvents.includes(type) || typeof listener !== 'function')
+      return
+    const listeners = this.lazyListeners_[type] || new Set()
+    this.lazyListeners_[type] = listeners
+    listeners.add(listener)
+    if (listeners.size === 1 && this.tabID)
+      GuestViewInternal.setListening(this.tabID, type, true)
+  }
+
+  element.removeEventListener = (type, listener, options) => {
+    removeEventListener.call(element, type, listener, options)
+    const listeners = this.lazyListeners_[type]
+    if (!listeners || !listeners.delete(listener))
+      return
+    if (listeners.size === 0 && this.tabID)
+      GuestViewInternal.setListening(this.tabID, type, false)
+  }
+}
+
 WebViewImpl.prototype.setTabId = function (tabID) {
+  const oldTabID = this.tabID
   this.tabID = tabID
   GuestViewInternal.registerEvents(this, tabID)
+  lazyEvents.forEach((type) => {
+    const listeners = this.lazyListeners_ && this.lazyListeners_[type]
+    if (!listeners || listeners.size === 0)
+      return
+    if (oldTabID)
+      GuestViewInternal.setListening(oldTabID, type, false)
+    GuestViewInternal.setListening(tabID, type, true)
+  })
 }
 
 WebViewImpl.prototype.getId = function () {
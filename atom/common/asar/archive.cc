@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "atom/common/asar/scoped_temporary_file.h"
+#include "atom/common/startup_timeline.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
@@ -151,6 +152,8 @@ bool Archive::Init() {
     return false;
   }
 
+  atom::StartupTimeline::GetInstance()->Mark("FirstAsarRead");
+
   std::vector<char> buf;
   int len;
 
@@ -273,8 +276,23 @@ bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
+  return ExtractFile(path, out, false);
+}
+
+bool Archive::CopyFileOutForRead(const base::FilePath& path,
+                                 base::FilePath* out) {
+  return ExtractFile(path, out, true);
+}
+
+bool Archive::ExtractFile(const base::FilePath& path,
+                          base::FilePath* out,
+                          bool for_read) {
+  base::AutoLock lock(external_files_lock_);
   auto it = external_files_.find(path.value());
   if (it != external_files_.end()) {
+    // A file that was read may now be loaded or spawned.
+    if (!for_read)
+      read_only_files_.erase(path.value());
     *out = it->second->path();
     return true;
   }
@@ -302,9 +320,25 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
 
   *out = temp_file->path();
   external_files_[path.value()] = std::move(temp_file);
+  if (for_read)
+    read_only_files_.insert(path.value());
   return true;
 }
 
+uint64_t Archive::ClearExtractedFiles() {
+  base::AutoLock lock(external_files_lock_);
+  uint64_t size = 0;
+  for (const auto& key : read_only_files_) {
+    auto it = external_files_.find(key);
+    int64_t file_size;
+    if (base::GetFileSize(it->second->path(), &file_size))
+      size += file_size;
+    external_files_.erase(it);
+  }
+  read_only_files_.clear();
+  return size;
+}
+
 int Archive::GetFD() const {
   return fd_;
 }
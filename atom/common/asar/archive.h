@@ -5,12 +5,16 @@
 #ifndef ATOM_COMMON_ASAR_ARCHIVE_H_
 #define ATOM_COMMON_ASAR_ARCHIVE_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
 
 namespace base {
 class DictionaryValue;
@@ -61,6 +65,16 @@ class Archive {
   // For unpacked file, this method will return its real path.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
 
+  // Like CopyFileOut, for callers that read the file right away and don't
+  // keep it open, so ClearExtractedFiles can delete it.
+  bool CopyFileOutForRead(const base::FilePath& path, base::FilePath* out);
+
+  // Deletes the temporary files created by CopyFileOutForRead and returns
+  // their total size. They are extracted again when needed. Files created by
+  // CopyFileOut may be loaded native modules, spawned executables or open
+  // files and are kept.
+  uint64_t ClearExtractedFiles();
+
   // Returns the file's fd.
   int GetFD() const;
 
@@ -68,6 +82,10 @@ class Archive {
   base::DictionaryValue* header() const { return header_.get(); }
 
  private:
+  bool ExtractFile(const base::FilePath& path,
+                   base::FilePath* out,
+                   bool for_read);
+
   base::FilePath path_;
   base::File file_;
   int fd_;
@@ -75,9 +93,12 @@ class Archive {
   std::unique_ptr<base::DictionaryValue> header_;
 
   // Cached external temporary files.
+  base::Lock external_files_lock_;
   std::unordered_map
     <base::FilePath::StringType, std::unique_ptr<ScopedTemporaryFile>>
       external_files_;
+  // Keys of |external_files_| that are only read by their callers.
+  std::unordered_set<base::FilePath::StringType> read_only_files_;
 
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
@@ -6,12 +6,14 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "atom/common/asar/archive.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/lazy_instance.h"
 #include "base/stl_util.h"
+#include "base/synchronization/lock.h"
 
 namespace asar {
 
@@ -21,12 +23,17 @@ namespace {
 typedef std::map<base::FilePath, std::shared_ptr<Archive>> ArchiveMap;
 static base::LazyInstance<ArchiveMap>::DestructorAtExit g_archive_map =
     LAZY_INSTANCE_INITIALIZER;
+// Archives are looked up from the IO thread, the UI thread and the blocking
+// pool.
+static base::LazyInstance<base::Lock>::Leaky g_archive_map_lock =
+    LAZY_INSTANCE_INITIALIZER;
 
 const base::FilePath::CharType kAsarExtension[] = FILE_PATH_LITERAL(".asar");
 
 }  // namespace
 
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
+  base::AutoLock lock(g_archive_map_lock.Get());
   ArchiveMap& archive_map = *g_archive_map.Pointer();
   if (!ContainsKey(archive_map, path)) {
     std::shared_ptr<Archive> archive(new Archive(path));
@@ -37,6 +44,20 @@ std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
   return archive_map[path];
 }
 
+uint64_t ClearExtractedFiles() {
+  std::vector<std::shared_ptr<Archive>> archives;
+  {
+    base::AutoLock lock(g_archive_map_lock.Get());
+    for (const auto& entry : *g_archive_map.Pointer())
+      archives.push_back(entry.second);
+  }
+
+  uint64_t size = 0;
+  for (const auto& archive : archives)
+    size += archive->ClearExtractedFiles();
+  return size;
+}
+
 bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
                         base::FilePath* relative_path) {
@@ -5,6 +5,8 @@
 #ifndef ATOM_COMMON_ASAR_ASAR_UTIL_H_
 #define ATOM_COMMON_ASAR_ASAR_UTIL_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 
@@ -24,6 +26,11 @@ bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
                         base::FilePath* relative_path);
 
+// Deletes the files extracted from the cached archives that are known to be
+// unused and returns their total size. Temporary files can live in memory,
+// e.g. on tmpfs.
+uint64_t ClearExtractedFiles();
+
 // Same with base::ReadFileToString but supports asar Archive.
 bool ReadFileToString(const base::FilePath& path, std::string* contents);
 
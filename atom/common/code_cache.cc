@@ -0,0 +1,248 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/code_cache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+#include "crypto/sha2.h"
+#include "gin/converter.h"
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<CodeCache>::Leaky g_code_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Version strings end up in a directory name.
+std::string SanitizeVersion(const std::string& version) {
+  std::string sanitized(version);
+  for (char& c : sanitized) {
+    if (!base::IsAsciiAlpha(c) && !base::IsAsciiDigit(c) && c != '.' &&
+        c != '-' && c != '_')
+      c = '_';
+  }
+  return sanitized;
+}
+
+// Entries are trimmed to three quarters of this size when the cache is
+// initialized, the entries used least recently first.
+const int64_t kMaxCacheSize = 32 * 1024 * 1024;
+
+void TrimDirectory(const base::FilePath& dir) {
+  std::vector<base::FileEnumerator::FileInfo> entries;
+  int64_t total_size = 0;
+  base::FileEnumerator enumerator(dir, false, base::FileEnumerator::FILES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    entries.push_back(enumerator.GetInfo());
+    total_size += entries.back().GetSize();
+  }
+  if (total_size <= kMaxCacheSize)
+    return;
+
+  std::sort(entries.begin(), entries.end(),
+            [](const base::FileEnumerator::FileInfo& a,
+               const base::FileEnumerator::FileInfo& b) {
+              return a.GetLastModifiedTime() < b.GetLastModifiedTime();
+            });
+  for (const auto& entry : entries) {
+    if (total_size <= kMaxCacheSize / 4 * 3)
+      break;
+    if (base::DeleteFile(dir.Append(entry.GetName()), false))
+      total_size -= entry.GetSize();
+  }
+}
+
+void PrepareDirectory(const base::FilePath& dir) {
+  base::FileEnumerator versions(dir.DirName(), false,
+                                base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath version = versions.Next(); !version.empty();
+       version = versions.Next()) {
+    if (version != dir)
+      base::DeleteFile(version, true);
+  }
+  if (!base::CreateDirectory(dir)) {
+    LOG(ERROR) << "Failed to create code cache directory " << dir.value();
+    return;
+  }
+  TrimDirectory(dir);
+}
+
+// The modification time of an entry is the last time it was used.
+void TouchEntry(const base::FilePath& path) {
+  base::Time now = base::Time::Now();
+  base::TouchFile(path, now, now);
+}
+
+void WriteEntry(const base::FilePath& path, const std::string& contents) {
+  if (!base::ImportantFileWriter::WriteFileAtomically(path, contents))
+    LOG(ERROR) << "Failed to write code cache entry " << path.value();
+}
+
+void DeleteEntry(const base::FilePath& path) {
+  base::DeleteFile(path, false);
+}
+
+}  // namespace
+
+CodeCache::Stats::Stats()
+    : hits(0), misses(0), rejected(0), stored(0) {
+}
+
+// static
+CodeCache* CodeCache::GetInstance() {
+  return g_code_cache.Pointer();
+}
+
+CodeCache::CodeCache() {
+}
+
+CodeCache::~CodeCache() {
+}
+
+void CodeCache::Initialize(const base::FilePath& dir,
+                           const std::string& version) {
+  base::AutoLock lock(lock_);
+  DCHECK(dir_.empty());
+  dir_ = dir.AppendASCII(SanitizeVersion(version + "-" +
+                                         v8::V8::GetVersion()));
+  task_runner_ = base::CreateSequencedTaskRunnerWithTraits(
+      {base::MayBlock(), base::TaskPriority::BACKGROUND,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+  // Runs before any write, which is posted to the same sequence, so entries
+  // written by this run are never trimmed.
+  task_runner_->PostTask(FROM_HERE, base::Bind(&PrepareDirectory, dir_));
+}
+
+bool CodeCache::enabled() const {
+  base::AutoLock lock(lock_);
+  return !dir_.empty();
+}
+
+base::FilePath CodeCache::directory() const {
+  base::AutoLock lock(lock_);
+  return dir_;
+}
+
+bool CodeCache::Get(const std::string& path,
+                    const std::string& source,
+                    std::string* data) {
+  base::FilePath entry_path;
+  {
+    base::AutoLock lock(lock_);
+    if (dir_.empty())
+      return false;
+    entry_path = GetEntryPath(path);
+  }
+
+  // Reading the entry is cheaper than compiling the script it replaces.
+  std::string contents;
+  bool found;
+  {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    found = base::ReadFileToString(entry_path, &contents);
+  }
+
+  // An entry starts with the hash of the source it was produced from.
+  std::string hash = crypto::SHA256HashString(source);
+  bool hit = found && contents.size() > hash.size() &&
+      contents.compare(0, hash.size(), hash) == 0;
+  if (hit)
+    data->assign(contents, hash.size(), std::string::npos);
+
+  base::AutoLock lock(lock_);
+  if (hit) {
+    task_runner_->PostTask(FROM_HERE, base::Bind(&TouchEntry, entry_path));
+    stats_.hits++;
+  } else {
+    stats_.misses++;
+  }
+  return hit;
+}
+
+void CodeCache::Put(const std::string& path,
+                    const std::string& source,
+                    const std::string& data) {
+  if (data.empty())
+    return;
+
+  base::AutoLock lock(lock_);
+  if (dir_.empty())
+    return;
+  task_runner_->PostTask(FROM_HERE,
+      base::Bind(&WriteEntry, GetEntryPath(path),
+                 crypto::SHA256HashString(source) + data));
+  stats_.stored++;
+}
+
+void CodeCache::Reject(const std::string& path) {
+  base::AutoLock lock(lock_);
+  if (dir_.empty())
+    return;
+  task_runner_->PostTask(FROM_HERE,
+                         base::Bind(&DeleteEntry, GetEntryPath(path)));
+  stats_.hits--;
+  stats_.rejected++;
+}
+
+v8::MaybeLocal<v8::Script> CodeCache::Compile(v8::Local<v8::Context> context,
+                                              v8::Local<v8::String> source,
+                                              const std::string& path) {
+  v8::Isolate* isolate = context->GetIsolate();
+  v8::ScriptOrigin origin(gin::StringToV8(isolate, path));
+  if (!enabled())
+    return v8::Script::Compile(context, source, &origin);
+
+  std::string source_utf8 = gin::V8ToString(source);
+  std::string data;
+  if (Get(path, source_utf8, &data)) {
+    v8::ScriptCompiler::Source script_source(source, origin,
+        new v8::ScriptCompiler::CachedData(
+            reinterpret_cast<const uint8_t*>(data.data()), data.size()));
+    v8::MaybeLocal<v8::Script> script = v8::ScriptCompiler::Compile(
+        context, &script_source, v8::ScriptCompiler::kConsumeCodeCache);
+    // A rejected cache still compiles the script, so it is only dropped
+    // rather than compiled a second time to produce a new one.
+    if (script_source.GetCachedData()->rejected)
+      Reject(path);
+    return script;
+  }
+
+  v8::ScriptCompiler::Source script_source(source, origin);
+  v8::MaybeLocal<v8::Script> script = v8::ScriptCompiler::Compile(
+      context, &script_source, v8::ScriptCompiler::kProduceCodeCache);
+  const v8::ScriptCompiler::CachedData* cached_data =
+      script_source.GetCachedData();
+  if (!script.IsEmpty() && cached_data && cached_data->length > 0) {
+    Put(path, source_utf8,
+        std::string(reinterpret_cast<const char*>(cached_data->data),
+                    cached_data->length));
+  }
+  return script;
+}
+
+CodeCache::Stats CodeCache::stats() const {
+  base::AutoLock lock(lock_);
+  return stats_;
+}
+
+base::FilePath CodeCache::GetEntryPath(const std::string& path) const {
+  lock_.AssertAcquired();
+  return dir_.AppendASCII(
+      base::HexEncode(crypto::SHA256HashString(path).data(), 16));
+}
+
+}  // namespace atom
@@ -0,0 +1,87 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_CODE_CACHE_H_
+#define ATOM_COMMON_CODE_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/lazy_instance.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/sequenced_task_runner.h"
+#include "base/synchronization/lock.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// Keeps the V8 code cache of the scripts of the browser process on disk, so
+// scripts that have not changed since the last run are deserialized instead
+// of compiled. Entries are keyed by the path of the script and only used
+// when the hash of the source they were produced from matches. Each app and
+// V8 version gets a directory of its own, and the others are deleted when the
+// cache is initialized. The entries used least recently are then deleted
+// when the directory grows past a size cap. Reads are synchronous, writes
+// happen on a background sequence. Safe to use on any thread.
+class CodeCache {
+ public:
+  struct Stats {
+    Stats();
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t rejected;
+    uint64_t stored;
+  };
+
+  static CodeCache* GetInstance();
+
+  // Stores the cache in a subdirectory of |dir| for |version|. The cache is
+  // disabled until then.
+  void Initialize(const base::FilePath& dir, const std::string& version);
+  bool enabled() const;
+  // The directory of the current version, empty when disabled.
+  base::FilePath directory() const;
+
+  // Returns the cached data of |path| if it was produced from |source|.
+  bool Get(const std::string& path,
+           const std::string& source,
+           std::string* data);
+  void Put(const std::string& path,
+           const std::string& source,
+           const std::string& data);
+  // Called when V8 rejected the data returned by Get(), so it is produced
+  // again by the next run.
+  void Reject(const std::string& path);
+
+  // Compiles |source| for the current context with |path| as its origin,
+  // consuming the cached data of |path| or producing it.
+  v8::MaybeLocal<v8::Script> Compile(v8::Local<v8::Context> context,
+                                     v8::Local<v8::String> source,
+                                     const std::string& path);
+
+  Stats stats() const;
+
+ private:
+  friend struct base::LazyInstanceTraitsBase<CodeCache>;
+
+  CodeCache();
+  ~CodeCache();
+
+  base::FilePath GetEntryPath(const std::string& path) const;
+
+  mutable base::Lock lock_;
+  base::FilePath dir_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodeCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_CODE_CACHE_H_
@@ -4,18 +4,24 @@
 
 #include "atom/common/javascript_bindings.h"
 
+#include <map>
 #include <vector>
+
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/atom_api_key_weak_map.h"
 #include "atom/common/api/remote_object_freer.h"
 #include "atom/common/native_mate_converters/content_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/lazy_instance.h"
 #include "base/memory/shared_memory.h"
 #include "base/memory/shared_memory_handle.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
 #include "content/public/renderer/render_frame.h"
+#include "content/public/renderer/render_frame_observer_tracker.h"
+#include "content/public/renderer/render_thread.h"
 #include "extensions/renderer/console.h"
+#include "ipc/ipc_message_utils.h"
 #include "native_mate/dictionary.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
 #include "third_party/WebKit/public/web/WebView.h"
@@ -34,6 +40,138 @@ std::vector<v8::Local<v8::Value>> ListValueToVector(v8::Isolate* isolate,
   return result;
 }
 
+// Counts the script contexts of this process that listen on each channel and
+// tells the browser when a channel gains its first or loses its last one.
+class ChannelSubscriptions {
+ public:
+  void Add(const base::string16& channel) {
+    if (++counts_[channel] == 1)
+      Send(channel, true);
+  }
+
+  void Remove(const base::string16& channel) {
+    auto it = counts_.find(channel);
+    if (it == counts_.end())
+      return;
+    if (--it->second == 0) {
+      counts_.erase(it);
+      Send(channel, false);
+    }
+  }
+
+ private:
+  void Send(const base::string16& channel, bool subscribed) {
+    content::RenderThread* thread = content::RenderThread::Get();
+    if (thread)
+      thread->Send(new AtomViewHostMsg_SetChannelSubscribed(channel,
+                                                            subscribed));
+  }
+
+  std::map<base::string16, int> counts_;
+};
+
+base::LazyInstance<ChannelSubscriptions>::Leaky g_channel_subscriptions =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Dispatches the browser messages of a frame to the bindings of its script
+// contexts that listen on the message channel. The channel is read before the
+// arguments, so messages without a listener are never deserialized, and the
+// arguments are deserialized once however many contexts receive them.
+class FrameMessageRouter
+    : public content::RenderFrameObserver,
+      public content::RenderFrameObserverTracker<FrameMessageRouter> {
+ public:
+  static FrameMessageRouter* GetOrCreate(content::RenderFrame* render_frame) {
+    FrameMessageRouter* router = Get(render_frame);
+    if (!router)
+      router = new FrameMessageRouter(render_frame);
+    return router;
+  }
+
+  void AddBindings(JavascriptBindings* bindings) {
+    bindings_.push_back(bindings);
+  }
+
+  void RemoveBindings(JavascriptBindings* bindings) {
+    for (auto it = bindings_.begin(); it != bindings_.end(); ++it) {
+      if (*it == bindings) {
+        bindings_.erase(it);
+        return;
+      }
+    }
+  }
+
+  // content::RenderFrameObserver:
+  bool OnMessageReceived(const IPC::Message& message) override {
+    if (message.type() != AtomViewMsg_Message::ID &&
+        message.type() != AtomViewMsg_Message_Shared::ID)
+      return false;
+
+    base::PickleIterator iter(message);
+    base::string16 channel;
+    if (!IPC::ReadParam(&message, &iter, &channel))
+      return false;
+
+    std::vector<JavascriptBindings*> receivers;
+    for (auto* bindings : bindings_) {
+      if (bindings->IsSubscribed(channel))
+        receivers.push_back(bindings);
+    }
+    if (receivers.empty())
+      return true;
+
+    if (message.type() == AtomViewMsg_Message_Shared::ID) {
+      // Shared memory ipc messages should only be sent to a single context
+      // to avoid getting an invalid handle on windows. webui and blessed
+      // extension contexts are mutually exclusive.
+      AtomViewMsg_Message_Shared::Param params;
+      if (!AtomViewMsg_Message_Shared::Read(&message, &params))
+        return true;
+      for (auto* bindings : receivers) {
+        if (bindings->CanReceiveSharedMessages()) {
+          bindings->OnSharedBrowserMessage(channel, std::get<1>(params));
+          break;
+        }
+      }
+      return true;
+    }
+
+    AtomViewMsg_Message::Param params;
+    if (!AtomViewMsg_Message::Read(&message, &params))
+      return true;
+    for (auto* bindings : receivers) {
+      // A listener can tear down other contexts of the frame.
+      if (IsAttached(bindings) && bindings->IsSubscribed(channel))
+        bindings->OnBrowserMessage(channel, std::get<1>(params));
+    }
+    return true;
+  }
+
+  void OnDestruct() override {
+    delete this;
+  }
+
+ private:
+  explicit FrameMessageRouter(content::RenderFrame* render_frame)
+      : content::RenderFrameObserver(render_frame),
+        content::RenderFrameObserverTracker<FrameMessageRouter>(
+            render_frame) {
+  }
+  ~FrameMessageRouter() override {}
+
+  bool IsAttached(JavascriptBindings* bindings) const {
+    for (auto* attached : bindings_) {
+      if (attached == bindings)
+        return true;
+    }
+    return false;
+  }
+
+  std::vector<JavascriptBindings*> bindings_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameMessageRouter);
+};
+
 }  // namespace
 
 JavascriptBindings::JavascriptBindings(content::RenderFrame* render_frame,
@@ -43,9 +181,20 @@ JavascriptBindings::JavascriptBindings(content::RenderFrame* render_frame,
   RouteFunction(
       "GetBinding",
       base::Bind(&JavascriptBindings::GetBinding, base::Unretained(this)));
+  if (render_frame)
+    FrameMessageRouter::GetOrCreate(render_frame)->AddBindings(this);
 }
 
-JavascriptBindings::~JavascriptBindings() {}
+JavascriptBindings::~JavascriptBindings() {
+  for (const auto& channel : subscribed_channels_)
+    g_channel_subscriptions.Get().Remove(channel);
+
+  if (render_frame()) {
+    FrameMessageRouter* router = FrameMessageRouter::Get(render_frame());
+    if (router)
+      router->RemoveBindings(this);
+  }
+}
 
 void JavascriptBindings::OnDestruct() {
   // don't self delete on render frame destruction
@@ -139,6 +288,37 @@ void JavascriptBindings::IPCSend(mate::Arguments* args,
     args->ThrowError("Unable to send AtomViewHostMsg_Message");
 }
 
+void JavascriptBindings::SetChannelSubscribed(const base::string16& channel,
+                                              bool subscribed) {
+  if (subscribed) {
+    if (subscribed_channels_.insert(channel).second)
+      g_channel_subscriptions.Get().Add(channel);
+  } else {
+    if (subscribed_channels_.erase(channel))
+      g_channel_subscriptions.Get().Remove(channel);
+  }
+}
+
+bool JavascriptBindings::IsSubscribed(const base::string16& channel) const {
+  if (!is_valid())
+    return false;
+
+  // never handle ipc messages in a web page context
+  if (context()->effective_context_type() == Feature::WEB_PAGE_CONTEXT)
+    return false;
+
+  return subscribed_channels_.count(channel) > 0;
+}
+
+bool JavascriptBindings::CanReceiveSharedMessages() const {
+  if (!is_valid())
+    return false;
+
+  auto context_type = context()->effective_context_type();
+  return context_type == Feature::WEBUI_CONTEXT ||
+         context_type == Feature::BLESSED_EXTENSION_CONTEXT;
+}
+
 void JavascriptBindings::IPCSendShared(mate::Arguments* args,
             const base::string16& channel,
             base::SharedMemory* shared_memory) {
@@ -194,6 +374,9 @@ void JavascriptBindings::GetBinding(
       base::Unretained(this)));
   ipc.SetMethod("sendShared", base::Bind(&JavascriptBindings::IPCSendShared,
       base::Unretained(this)));
+  ipc.SetMethod("setChannelSubscribed",
+      base::Bind(&JavascriptBindings::SetChannelSubscribed,
+      base::Unretained(this)));
   binding.Set("ipc", ipc.GetHandle());
 
   mate::Dictionary v8(isolate, v8::Object::New(isolate));
@@ -218,38 +401,6 @@ void JavascriptBindings::GetBinding(
   args.GetReturnValue().Set(binding.GetHandle());
 }
 
-bool JavascriptBindings::OnMessageReceived(const IPC::Message& message) {
-  if (!is_valid())
-    return false;
-
-  auto context_type = context()->effective_context_type();
-
-  // never handle ipc messages in a web page context
-  if (context_type == Feature::WEB_PAGE_CONTEXT)
-    return false;
-
-  bool handled = false;
-
-  // Shared memory ipc messages should only be sent to a single context
-  // to avoid getting an invalid handle on windows. webui and blessed extension
-  // contexts are mutually exclusive
-  if (context_type == Feature::WEBUI_CONTEXT ||
-      context_type == Feature::BLESSED_EXTENSION_CONTEXT) {
-    IPC_BEGIN_MESSAGE_MAP(JavascriptBindings, message)
-      IPC_MESSAGE_HANDLER(AtomViewMsg_Message_Shared, OnSharedBrowserMessage)
-      IPC_MESSAGE_UNHANDLED(handled = false)
-    IPC_END_MESSAGE_MAP()
-  }
-
-
-  IPC_BEGIN_MESSAGE_MAP(JavascriptBindings, message)
-    IPC_MESSAGE_HANDLER(AtomViewMsg_Message, OnBrowserMessage)
-    IPC_MESSAGE_UNHANDLED(handled = false)
-  IPC_END_MESSAGE_MAP()
-
-  return handled;
-}
-
 void JavascriptBindings::OnSharedBrowserMessage(const base::string16& channel,
                                       const base::SharedMemoryHandle& handle) {
   if (!base::SharedMemory::IsHandleValid(handle)) {
@@ -5,6 +5,9 @@
 #ifndef ATOM_COMMON_JAVASCRIPT_BINDINGS_H_
 #define ATOM_COMMON_JAVASCRIPT_BINDINGS_H_
 
+#include <set>
+
+#include "base/strings/string16.h"
 #include "content/public/renderer/render_frame_observer.h"
 #include "extensions/renderer/object_backed_native_handler.h"
 #include "extensions/renderer/script_context.h"
@@ -30,7 +33,19 @@ class JavascriptBindings : public content::RenderFrameObserver,
 
   void GetBinding(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+  // Whether a listener in this context is registered for |channel|.
+  bool IsSubscribed(const base::string16& channel) const;
+  // Shared memory messages go to a single context, see
+  // FrameMessageRouter::OnMessageReceived.
+  bool CanReceiveSharedMessages() const;
+
+  void OnBrowserMessage(const base::string16& channel,
+                        const base::ListValue& args);
+  void OnSharedBrowserMessage(const base::string16& channel,
+                              const base::SharedMemoryHandle& handle);
+
  private:
+  void SetChannelSubscribed(const base::string16& channel, bool subscribed);
   void IPCSendShared(mate::Arguments* args,
             const base::string16& channel,
             base::SharedMemory* shared_memory);
@@ -61,11 +76,8 @@ class JavascriptBindings : public content::RenderFrameObserver,
 
   // content::RenderFrameObserver:
   void OnDestruct() override;
-  bool OnMessageReceived(const IPC::Message& message) override;
-  void OnBrowserMessage(const base::string16& channel,
-                        const base::ListValue& args);
-  void OnSharedBrowserMessage(const base::string16& channel,
-                              const base::SharedMemoryHandle& handle);
+
+  std::set<base::string16> subscribed_channels_;
 
   DISALLOW_COPY_AND_ASSIGN(JavascriptBindings);
 };
@@ -0,0 +1,41 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_NATIVE_MATE_CONVERTERS_V8_PROFILER_CONVERTER_H_
+#define ATOM_COMMON_NATIVE_MATE_CONVERTERS_V8_PROFILER_CONVERTER_H_
+
+#include "atom/common/v8_profiler.h"
+#include "native_mate/dictionary.h"
+
+namespace mate {
+
+template<>
+struct Converter<atom::V8Profiler::Options> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     atom::V8Profiler::Options* out) {
+    mate::Dictionary dict;
+    if (!ConvertFromV8(isolate, val, &dict))
+      return false;
+
+    double heap_sampling_interval;
+    if (dict.Get("heapSamplingInterval", &heap_sampling_interval)) {
+      if (heap_sampling_interval < 0)
+        return false;
+      out->heap_sampling_interval =
+          static_cast<uint64_t>(heap_sampling_interval);
+    }
+    int cpu_sampling_interval;
+    if (dict.Get("cpuSamplingInterval", &cpu_sampling_interval)) {
+      if (cpu_sampling_interval < 0)
+        return false;
+      out->cpu_sampling_interval = cpu_sampling_interval;
+    }
+    return true;
+  }
+};
+
+}  // namespace mate
+
+#endif  // ATOM_COMMON_NATIVE_MATE_CONVERTERS_V8_PROFILER_CONVERTER_H_
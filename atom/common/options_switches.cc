@@ -128,6 +128,17 @@ const char kCipherSuiteBlacklist[] = "cipher-suite-blacklist";
 // The browser process app model ID
 const char kAppUserModelId[] = "app-user-model-id";
 
+// Writes the startup timeline in the chrome://tracing format to the given file
+// once the first page has painted.
+const char kStartupTraceFile[] = "startup-trace-file";
+
+// How the renderer throttles the timers of hidden pages: "none", "aligned"
+// (run them at most once a second) or "budget" (also limit their CPU time).
+const char kBackgroundTimerThrottling[] = "background-timer-throttling";
+
+// Exposes the methods the specs use to drive native code directly.
+const char kEnableTestHooks[] = "enable-test-hooks";
+
 // The command line switch versions of the options.
 const char kBackgroundColor[] = "background-color";
 const char kZoomFactor[]      = "zoom-factor";
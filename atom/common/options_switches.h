@@ -73,6 +73,9 @@ extern const char kRegisterServiceWorkerSchemes[];
 extern const char kSSLVersionFallbackMin[];
 extern const char kCipherSuiteBlacklist[];
 extern const char kAppUserModelId[];
+extern const char kStartupTraceFile[];
+extern const char kBackgroundTimerThrottling[];
+extern const char kEnableTestHooks[];
 
 extern const char kBackgroundColor[];
 extern const char kZoomFactor[];
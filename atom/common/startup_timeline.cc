@@ -0,0 +1,120 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/startup_timeline.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/json/json_writer.h"
+#include "base/process/process_handle.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/values.h"
+
+namespace atom {
+
+namespace {
+
+base::LazyInstance<StartupTimeline>::Leaky g_startup_timeline =
+    LAZY_INSTANCE_INITIALIZER;
+
+void WriteTraceFile(const base::FilePath& path, const std::string& contents) {
+  if (!base::ImportantFileWriter::WriteFileAtomically(path, contents))
+    LOG(ERROR) << "Failed to write startup trace to " << path.value();
+}
+
+}  // namespace
+
+StartupTimeline::ScopedPhase::ScopedPhase(const char* name)
+    : name_(name),
+      start_(base::TimeTicks::Now()) {
+}
+
+StartupTimeline::ScopedPhase::~ScopedPhase() {
+  StartupTimeline::GetInstance()->AddPhase(name_, start_,
+                                           base::TimeTicks::Now());
+}
+
+// static
+StartupTimeline* StartupTimeline::GetInstance() {
+  return g_startup_timeline.Pointer();
+}
+
+StartupTimeline::StartupTimeline()
+    : origin_(base::TimeTicks::Now()) {
+}
+
+StartupTimeline::~StartupTimeline() {
+}
+
+void StartupTimeline::SetOrigin(base::TimeTicks origin) {
+  base::AutoLock lock(lock_);
+  origin_ = origin;
+}
+
+bool StartupTimeline::Mark(const std::string& name) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  return AddPhase(name, now, now);
+}
+
+bool StartupTimeline::AddPhase(const std::string& name,
+                               base::TimeTicks start,
+                               base::TimeTicks end) {
+  base::AutoLock lock(lock_);
+  for (const auto& record : records_) {
+    if (record.name == name)
+      return false;
+  }
+  records_.push_back({name, start, end});
+  return true;
+}
+
+std::vector<StartupTimeline::Event> StartupTimeline::GetEvents() const {
+  base::AutoLock lock(lock_);
+  std::vector<Event> events;
+  for (const auto& record : records_)
+    events.push_back(
+        {record.name, record.start - origin_, record.end - record.start});
+  return events;
+}
+
+void StartupTimeline::WriteTrace(const base::FilePath& path) const {
+  const int pid = static_cast<int>(base::GetCurrentProcId());
+  auto trace_events = std::make_unique<base::ListValue>();
+  for (const auto& event : GetEvents()) {
+    auto trace_event = std::make_unique<base::DictionaryValue>();
+    trace_event->SetString("name", event.name);
+    trace_event->SetString("cat", "startup");
+    trace_event->SetInteger("pid", pid);
+    trace_event->SetInteger("tid", 0);
+    trace_event->SetDouble("ts", event.start.InMicroseconds());
+    if (event.duration.is_zero()) {
+      trace_event->SetString("ph", "i");
+      trace_event->SetString("s", "g");
+    } else {
+      trace_event->SetString("ph", "X");
+      trace_event->SetDouble("dur", event.duration.InMicroseconds());
+    }
+    trace_events->Append(std::move(trace_event));
+  }
+
+  base::DictionaryValue trace;
+  trace.Set("traceEvents", std::move(trace_events));
+  trace.SetString("displayTimeUnit", "ms");
+
+  std::string contents;
+  if (!base::JSONWriter::Write(trace, &contents))
+    return;
+
+  base::PostTaskWithTraits(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::BACKGROUND,
+       base::TaskShutdownBehavior::BLOCK_SHUTDOWN},
+      base::Bind(&WriteTraceFile, path, contents));
+}
+
+}  // namespace atom
@@ -0,0 +1,87 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_STARTUP_TIMELINE_H_
+#define ATOM_COMMON_STARTUP_TIMELINE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/lazy_instance.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace atom {
+
+// Records when the startup phases of the process begin and end, and when
+// one-off milestones such as the first paint happen, relative to the entry
+// point of the executable. Only the first occurrence of each name is kept.
+// Safe to use on any thread.
+class StartupTimeline {
+ public:
+  struct Event {
+    std::string name;
+    base::TimeDelta start;
+    // Zero for milestones.
+    base::TimeDelta duration;
+  };
+
+  // Measures the lifetime of the scope as phase |name|.
+  class ScopedPhase {
+   public:
+    explicit ScopedPhase(const char* name);
+    ~ScopedPhase();
+
+   private:
+    const char* name_;
+    base::TimeTicks start_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedPhase);
+  };
+
+  static StartupTimeline* GetInstance();
+
+  // Sets the time the others are relative to. Defaults to when the timeline
+  // is first used.
+  void SetOrigin(base::TimeTicks origin);
+
+  // Returns false when |name| was already recorded.
+  bool Mark(const std::string& name);
+  bool AddPhase(const std::string& name,
+                base::TimeTicks start,
+                base::TimeTicks end);
+
+  std::vector<Event> GetEvents() const;
+
+  // Writes the events in the chrome://tracing JSON format. The file is
+  // written on the blocking pool.
+  void WriteTrace(const base::FilePath& path) const;
+
+ private:
+  friend struct base::LazyInstanceTraitsBase<StartupTimeline>;
+
+  StartupTimeline();
+  ~StartupTimeline();
+
+  struct Record {
+    std::string name;
+    base::TimeTicks start;
+    base::TimeTicks end;
+  };
+
+  mutable base::Lock lock_;
+  base::TimeTicks origin_;
+  std::vector<Record> records_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTimeline);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_STARTUP_TIMELINE_H_
@@ -0,0 +1,472 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/v8_profiler.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/json/string_escape.h"
+#include "base/lazy_instance.h"
+#include "base/memory/ref_counted.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner_util.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "v8/include/v8-profiler.h"
+
+#if defined(OS_WIN)
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace atom {
+
+namespace {
+
+const size_t kChunkSize = 64 * 1024;
+// Serializing is much faster than writing, so the bytes that are waiting to
+// be written are bounded to keep the memory of large snapshots in check. The
+// thread of the isolate never waits for the disk, output past this is
+// dropped and the request fails.
+const size_t kMaxQueuedBytes = 256 * 1024 * 1024;
+const char kCpuProfileTitle[] = "muon";
+
+struct Registry {
+  base::Lock lock;
+  std::map<v8::Isolate*, std::unique_ptr<V8Profiler>> profilers;
+};
+
+base::LazyInstance<Registry>::Leaky g_registry = LAZY_INSTANCE_INITIALIZER;
+
+// Counts the bytes that were handed to the background sequence and are not
+// written yet.
+class ChunkQueue : public base::RefCountedThreadSafe<ChunkQueue> {
+ public:
+  ChunkQueue() : queued_(0) {}
+
+  // Returns false without queueing |size| when the queue is full.
+  bool Add(size_t size) {
+    base::AutoLock auto_lock(lock_);
+    if (queued_ + size > kMaxQueuedBytes)
+      return false;
+    queued_ += size;
+    return true;
+  }
+
+  void Remove(size_t size) {
+    base::AutoLock auto_lock(lock_);
+    queued_ -= size;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<ChunkQueue>;
+  ~ChunkQueue() {}
+
+  base::Lock lock_;
+  size_t queued_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkQueue);
+};
+
+// A chunk that leaves its ChunkQueue when it is destroyed, after it was
+// written or when the write task could not be posted.
+class QueuedChunk {
+ public:
+  QueuedChunk(std::string data, scoped_refptr<ChunkQueue> queue)
+      : data_(std::move(data)), queue_(std::move(queue)) {}
+  ~QueuedChunk() { queue_->Remove(data_.size()); }
+
+  const std::string& data() const { return data_; }
+
+ private:
+  std::string data_;
+  scoped_refptr<ChunkQueue> queue_;
+
+  DISALLOW_COPY_AND_ASSIGN(QueuedChunk);
+};
+
+// Writes chunks to a file in order on a background sequence. Once a chunk
+// does not fit in the queue the output is incomplete, later chunks are
+// dropped and Finish() reports a failure.
+class ChunkWriter {
+ public:
+  // Nothing waits for the writes, so they don't hold up shutdown.
+  explicit ChunkWriter(base::File file)
+      : task_runner_(base::CreateSequencedTaskRunnerWithTraits(
+            {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+             base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+        queue_(new ChunkQueue),
+        aborted_(false),
+        output_(new Output(std::move(file)),
+                base::OnTaskRunnerDeleter(task_runner_)) {
+  }
+
+  // Returns false when the chunk was dropped.
+  bool Write(std::string chunk) {
+    if (aborted_ || !queue_->Add(chunk.size())) {
+      aborted_ = true;
+      return false;
+    }
+    auto queued_chunk = std::make_unique<QueuedChunk>(std::move(chunk), queue_);
+    task_runner_->PostTask(FROM_HERE,
+        base::Bind(&Output::WriteChunk, base::Unretained(output_.get()),
+                   base::Passed(&queued_chunk)));
+    return true;
+  }
+
+  bool aborted() const { return aborted_; }
+
+  // Runs |done| on the current sequence once all the chunks are written.
+  void Finish(const V8Profiler::DoneCallback& done) {
+    base::PostTaskAndReplyWithResult(task_runner_.get(), FROM_HERE,
+        base::Bind(&Output::Close, base::Unretained(output_.get())),
+        base::Bind(&ChunkWriter::RunDone, aborted_, done));
+  }
+
+ private:
+  struct Output {
+    explicit Output(base::File file)
+        : file(std::move(file)), failed(!this->file.IsValid()) {}
+
+    void WriteChunk(std::unique_ptr<QueuedChunk> chunk) {
+      if (failed)
+        return;
+      const std::string& data = chunk->data();
+      failed = file.WriteAtCurrentPos(data.data(), data.size()) !=
+          static_cast<int>(data.size());
+    }
+
+    bool Close() {
+      file.Close();
+      return !failed;
+    }
+
+    base::File file;
+    bool failed;
+  };
+
+  static void RunDone(bool aborted,
+                      const V8Profiler::DoneCallback& done,
+                      bool success) {
+    done.Run(success && !aborted);
+  }
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  scoped_refptr<ChunkQueue> queue_;
+  bool aborted_;
+  std::unique_ptr<Output, base::OnTaskRunnerDeleter> output_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkWriter);
+};
+
+// Buffers JSON and passes it on to a ChunkWriter in chunks.
+class JsonStream {
+ public:
+  explicit JsonStream(ChunkWriter* writer) : writer_(writer) {}
+  ~JsonStream() { Flush(); }
+
+  void Append(base::StringPiece json) {
+    json.AppendToString(&buffer_);
+    MaybeFlush();
+  }
+
+  void AppendString(v8::Local<v8::String> string) {
+    std::string utf8;
+    if (!string.IsEmpty())
+      utf8 = *v8::String::Utf8Value(string);
+    base::EscapeJSONString(utf8, true, &buffer_);
+    MaybeFlush();
+  }
+
+  void AppendNumber(int64_t number) {
+    Append(base::Int64ToString(number));
+  }
+
+ private:
+  void MaybeFlush() {
+    if (buffer_.size() >= kChunkSize)
+      Flush();
+  }
+
+  // The rest of the output is dropped once the writer gave up.
+  void Flush() {
+    if (!buffer_.empty() && !writer_->aborted())
+      writer_->Write(std::move(buffer_));
+    buffer_.clear();
+  }
+
+  ChunkWriter* writer_;
+  std::string buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(JsonStream);
+};
+
+// Passes the chunks of a heap snapshot on to a ChunkWriter.
+class SnapshotStream : public v8::OutputStream {
+ public:
+  explicit SnapshotStream(ChunkWriter* writer) : writer_(writer) {}
+
+  // v8::OutputStream:
+  int GetChunkSize() override { return kChunkSize; }
+  WriteResult WriteAsciiChunk(char* data, int size) override {
+    return writer_->Write(std::string(data, size)) ? kContinue : kAbort;
+  }
+  void EndOfStream() override {}
+
+ private:
+  ChunkWriter* writer_;
+
+  DISALLOW_COPY_AND_ASSIGN(SnapshotStream);
+};
+
+// V8 counts lines and columns from 1, the DevTools from 0.
+void SerializeCallFrame(v8::Local<v8::String> function_name,
+                        int script_id,
+                        v8::Local<v8::String> url,
+                        int line_number,
+                        int column_number,
+                        JsonStream* out) {
+  out->Append("{\"functionName\":");
+  out->AppendString(function_name);
+  out->Append(",\"scriptId\":\"");
+  out->AppendNumber(script_id);
+  out->Append("\",\"url\":");
+  out->AppendString(url);
+  out->Append(",\"lineNumber\":");
+  out->AppendNumber(line_number - 1);
+  out->Append(",\"columnNumber\":");
+  out->AppendNumber(column_number - 1);
+  out->Append("}");
+}
+
+void SerializeHeapNode(const v8::AllocationProfile::Node* node,
+                       JsonStream* out) {
+  int64_t self_size = 0;
+  for (const auto& allocation : node->allocations)
+    self_size += static_cast<int64_t>(allocation.size) * allocation.count;
+
+  out->Append("{\"callFrame\":");
+  SerializeCallFrame(node->name, node->script_id, node->script_name,
+                     node->line_number, node->column_number, out);
+  out->Append(",\"selfSize\":");
+  out->AppendNumber(self_size);
+  out->Append(",\"children\":[");
+  for (size_t i = 0; i < node->children.size(); ++i) {
+    if (i > 0)
+      out->Append(",");
+    SerializeHeapNode(node->children[i], out);
+  }
+  out->Append("]}");
+}
+
+void SerializeCpuNodes(const v8::CpuProfileNode* node, JsonStream* out) {
+  out->Append("{\"id\":");
+  out->AppendNumber(node->GetNodeId());
+  out->Append(",\"callFrame\":");
+  SerializeCallFrame(node->GetFunctionName(), node->GetScriptId(),
+                     node->GetScriptResourceName(), node->GetLineNumber(),
+                     node->GetColumnNumber(), out);
+  out->Append(",\"hitCount\":");
+  out->AppendNumber(node->GetHitCount());
+  out->Append(",\"children\":[");
+  for (int i = 0; i < node->GetChildrenCount(); ++i) {
+    if (i > 0)
+      out->Append(",");
+    out->AppendNumber(node->GetChild(i)->GetNodeId());
+  }
+  out->Append("]}");
+
+  for (int i = 0; i < node->GetChildrenCount(); ++i) {
+    out->Append(",");
+    SerializeCpuNodes(node->GetChild(i), out);
+  }
+}
+
+void SerializeCpuProfile(const v8::CpuProfile* profile, JsonStream* out) {
+  out->Append("{\"nodes\":[");
+  SerializeCpuNodes(profile->GetTopDownRoot(), out);
+  out->Append("],\"startTime\":");
+  out->AppendNumber(profile->GetStartTime());
+  out->Append(",\"endTime\":");
+  out->AppendNumber(profile->GetEndTime());
+  out->Append(",\"samples\":[");
+  for (int i = 0; i < profile->GetSamplesCount(); ++i) {
+    if (i > 0)
+      out->Append(",");
+    out->AppendNumber(profile->GetSample(i)->GetNodeId());
+  }
+  out->Append("],\"timeDeltas\":[");
+  int64_t last_time = profile->GetStartTime();
+  for (int i = 0; i < profile->GetSamplesCount(); ++i) {
+    if (i > 0)
+      out->Append(",");
+    int64_t time = profile->GetSampleTimestamp(i);
+    out->AppendNumber(time - last_time);
+    last_time = time;
+  }
+  out->Append("]}");
+}
+
+}  // namespace
+
+V8Profiler::Options::Options()
+    : heap_sampling_interval(512 * 1024),
+      cpu_sampling_interval(1000) {
+}
+
+// static
+V8Profiler* V8Profiler::From(v8::Isolate* isolate) {
+  Registry* registry = g_registry.Pointer();
+  base::AutoLock lock(registry->lock);
+  std::unique_ptr<V8Profiler>& profiler = registry->profilers[isolate];
+  if (!profiler)
+    profiler.reset(new V8Profiler(isolate));
+  return profiler.get();
+}
+
+// static
+void V8Profiler::Dispose(v8::Isolate* isolate) {
+  std::unique_ptr<V8Profiler> profiler;
+  {
+    Registry* registry = g_registry.Pointer();
+    base::AutoLock lock(registry->lock);
+    auto it = registry->profilers.find(isolate);
+    if (it == registry->profilers.end())
+      return;
+    profiler = std::move(it->second);
+    registry->profilers.erase(it);
+  }
+}
+
+V8Profiler::V8Profiler(v8::Isolate* isolate)
+    : isolate_(isolate),
+      profiling_(false),
+      sampling_heap_(false),
+      cpu_profiler_(nullptr) {
+}
+
+V8Profiler::~V8Profiler() {
+  if (!profiling_)
+    return;
+
+  v8::HandleScope handle_scope(isolate_);
+  if (sampling_heap_)
+    isolate_->GetHeapProfiler()->StopSamplingHeapProfiler();
+  if (cpu_profiler_) {
+    v8::CpuProfile* profile = cpu_profiler_->StopProfiling(
+        v8::String::NewFromUtf8(isolate_, kCpuProfileTitle));
+    if (profile)
+      profile->Delete();
+    cpu_profiler_->Dispose();
+  }
+}
+
+bool V8Profiler::Start(const Options& options) {
+  if (profiling_)
+    return false;
+
+  v8::HandleScope handle_scope(isolate_);
+  if (options.heap_sampling_interval > 0) {
+    sampling_heap_ = isolate_->GetHeapProfiler()->StartSamplingHeapProfiler(
+        options.heap_sampling_interval);
+  }
+  if (options.cpu_sampling_interval > 0) {
+    cpu_profiler_ = v8::CpuProfiler::New(isolate_);
+    cpu_profiler_->SetSamplingInterval(options.cpu_sampling_interval);
+    cpu_profiler_->StartProfiling(
+        v8::String::NewFromUtf8(isolate_, kCpuProfileTitle), true);
+  }
+  profiling_ = sampling_heap_ || cpu_profiler_ != nullptr;
+  return profiling_;
+}
+
+void V8Profiler::Stop(base::File file, const DoneCallback& done) {
+  if (!profiling_) {
+    base::ThreadTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+                                                  base::Bind(done, false));
+    return;
+  }
+  profiling_ = false;
+
+  v8::HandleScope handle_scope(isolate_);
+  std::unique_ptr<v8::AllocationProfile> heap_profile;
+  if (sampling_heap_) {
+    v8::HeapProfiler* heap_profiler = isolate_->GetHeapProfiler();
+    heap_profile.reset(heap_profiler->GetAllocationProfile());
+    heap_profiler->StopSamplingHeapProfiler();
+    sampling_heap_ = false;
+  }
+  v8::CpuProfile* cpu_profile = nullptr;
+  if (cpu_profiler_) {
+    cpu_profile = cpu_profiler_->StopProfiling(
+        v8::String::NewFromUtf8(isolate_, kCpuProfileTitle));
+  }
+
+  ChunkWriter writer(std::move(file));
+  {
+    JsonStream out(&writer);
+    out.Append("{");
+    if (cpu_profile) {
+      out.Append("\"cpuProfile\":");
+      SerializeCpuProfile(cpu_profile, &out);
+    }
+    if (heap_profile) {
+      if (cpu_profile)
+        out.Append(",");
+      out.Append("\"heapProfile\":{\"head\":");
+      SerializeHeapNode(heap_profile->GetRootNode(), &out);
+      out.Append("}");
+    }
+    out.Append("}");
+  }
+  writer.Finish(done);
+
+  if (cpu_profile)
+    cpu_profile->Delete();
+  if (cpu_profiler_) {
+    cpu_profiler_->Dispose();
+    cpu_profiler_ = nullptr;
+  }
+}
+
+void V8Profiler::WriteHeapSnapshot(base::File file, const DoneCallback& done) {
+  v8::HandleScope handle_scope(isolate_);
+  const v8::HeapSnapshot* snapshot =
+      isolate_->GetHeapProfiler()->TakeHeapSnapshot();
+
+  ChunkWriter writer(std::move(file));
+  SnapshotStream stream(&writer);
+  snapshot->Serialize(&stream, v8::HeapSnapshot::kJSON);
+  const_cast<v8::HeapSnapshot*>(snapshot)->Delete();
+  writer.Finish(done);
+}
+
+base::File DuplicateFileDescriptor(int fd) {
+#if defined(OS_WIN)
+  HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  HANDLE duplicate;
+  if (handle == INVALID_HANDLE_VALUE ||
+      !::DuplicateHandle(::GetCurrentProcess(), handle,
+                         ::GetCurrentProcess(), &duplicate, 0, FALSE,
+                         DUPLICATE_SAME_ACCESS))
+    return base::File();
+  return base::File(duplicate);
+#else
+  int duplicate = dup(fd);
+  if (duplicate < 0)
+    return base::File();
+  return base::File(duplicate);
+#endif
+}
+
+}  // namespace atom
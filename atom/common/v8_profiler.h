@@ -0,0 +1,78 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_V8_PROFILER_H_
+#define ATOM_COMMON_V8_PROFILER_H_
+
+#include <stdint.h>
+
+#include "base/callback.h"
+#include "base/files/file.h"
+#include "base/macros.h"
+#include "v8/include/v8.h"
+
+namespace v8 {
+class CpuProfiler;
+}
+
+namespace atom {
+
+// Runs V8's sampling heap profiler and CPU profiler on one isolate, and
+// writes the profiles and heap snapshots of the isolate to a file. Output is
+// handed over in chunks to a background sequence as it is serialized, and the
+// thread of the isolate never waits on the disk. A write fails when too much
+// output is queued. Used on the thread of the isolate only.
+class V8Profiler {
+ public:
+  struct Options {
+    Options();
+
+    // Average bytes allocated between heap samples, 0 to not sample the
+    // heap.
+    uint64_t heap_sampling_interval;
+    // Microseconds between CPU samples, 0 to not profile the CPU.
+    int cpu_sampling_interval;
+  };
+
+  using DoneCallback = base::Callback<void(bool success)>;
+
+  // Returns the profiler of |isolate|, created on first use.
+  static V8Profiler* From(v8::Isolate* isolate);
+  // Stops profiling |isolate| before it is disposed.
+  static void Dispose(v8::Isolate* isolate);
+
+  ~V8Profiler();
+
+  // Returns false if the isolate is already being profiled.
+  bool Start(const Options& options);
+  bool is_profiling() const { return profiling_; }
+
+  // Stops profiling and writes {"cpuProfile": ..., "heapProfile": ...} to
+  // |file|, each in the format of .cpuprofile and .heapprofile files of the
+  // DevTools. A profiler that was not started is left out. |done| runs on
+  // this thread once everything is written.
+  void Stop(base::File file, const DoneCallback& done);
+
+  // Takes a heap snapshot and writes it to |file| in the format of
+  // .heapsnapshot files.
+  void WriteHeapSnapshot(base::File file, const DoneCallback& done);
+
+ private:
+  explicit V8Profiler(v8::Isolate* isolate);
+
+  v8::Isolate* isolate_;
+  bool profiling_;
+  bool sampling_heap_;
+  v8::CpuProfiler* cpu_profiler_;
+
+  DISALLOW_COPY_AND_ASSIGN(V8Profiler);
+};
+
+// Returns a duplicate of the C runtime file descriptor |fd|, so it can be
+// closed by the caller right away.
+base::File DuplicateFileDescriptor(int fd);
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_V8_PROFILER_H_
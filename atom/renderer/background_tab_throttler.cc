@@ -0,0 +1,71 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/background_tab_throttler.h"
+
+#include <string>
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/options_switches.h"
+#include "base/command_line.h"
+#include "third_party/WebKit/public/platform/Platform.h"
+#include "third_party/WebKit/public/platform/WebRuntimeFeatures.h"
+#include "third_party/WebKit/public/platform/WebScheduler.h"
+#include "third_party/WebKit/public/platform/WebThread.h"
+
+namespace atom {
+
+namespace {
+
+blink::WebScheduler* GetMainThreadScheduler() {
+  blink::WebThread* thread = blink::Platform::Current()->CurrentThread();
+  return thread ? thread->Scheduler() : nullptr;
+}
+
+}  // namespace
+
+BackgroundTabThrottler::BackgroundTabThrottler()
+    : timers_suspended_(false) {
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switches::kBackgroundTimerThrottling))
+    return;
+
+  std::string throttling = command_line.GetSwitchValueASCII(
+      switches::kBackgroundTimerThrottling);
+  blink::WebRuntimeFeatures::EnableTimerThrottlingForBackgroundTabs(
+      throttling != "none");
+  blink::WebRuntimeFeatures::EnableExpensiveBackgroundTimerThrottling(
+      throttling == "budget");
+}
+
+BackgroundTabThrottler::~BackgroundTabThrottler() {
+}
+
+bool BackgroundTabThrottler::OnControlMessageReceived(
+    const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(BackgroundTabThrottler, message)
+    IPC_MESSAGE_HANDLER(AtomMsg_SetTimersSuspended, OnSetTimersSuspended)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void BackgroundTabThrottler::OnSetTimersSuspended(bool suspended) {
+  if (suspended == timers_suspended_)
+    return;
+
+  blink::WebScheduler* scheduler = GetMainThreadScheduler();
+  if (!scheduler)
+    return;
+
+  timers_suspended_ = suspended;
+  if (suspended)
+    scheduler->SuspendTimerQueue();
+  else
+    scheduler->ResumeTimerQueue();
+}
+
+}  // namespace atom
@@ -0,0 +1,35 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_BACKGROUND_TAB_THROTTLER_H_
+#define ATOM_RENDERER_BACKGROUND_TAB_THROTTLER_H_
+
+#include "base/macros.h"
+#include "content/public/renderer/render_thread_observer.h"
+
+namespace atom {
+
+// Applies the background tab policy of the browser context to the renderer:
+// the timer throttling of hidden pages is set from the command line when the
+// thread starts, and the browser suspends the timers of the whole process
+// once all of its tabs have been hidden long enough.
+class BackgroundTabThrottler : public content::RenderThreadObserver {
+ public:
+  BackgroundTabThrottler();
+  ~BackgroundTabThrottler() override;
+
+ private:
+  // content::RenderThreadObserver:
+  bool OnControlMessageReceived(const IPC::Message& message) override;
+
+  void OnSetTimersSuspended(bool suspended);
+
+  bool timers_suspended_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundTabThrottler);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_BACKGROUND_TAB_THROTTLER_H_
@@ -0,0 +1,95 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/resource_usage_reporter.h"
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/v8_profiler.h"
+#include "base/bind.h"
+#include "content/public/renderer/render_thread.h"
+#include "third_party/WebKit/public/web/WebKit.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+ResourceUsageReporter::ResourceUsageReporter()
+    : weak_factory_(this) {
+}
+
+ResourceUsageReporter::~ResourceUsageReporter() {
+}
+
+bool ResourceUsageReporter::OnControlMessageReceived(
+    const IPC::Message& message) {
+  bool handled = true;
+  IPC_BEGIN_MESSAGE_MAP(ResourceUsageReporter, message)
+    IPC_MESSAGE_HANDLER(AtomMsg_RequestV8HeapStats, OnRequestV8HeapStats)
+    IPC_MESSAGE_HANDLER(AtomMsg_StartV8Profiling, OnStartV8Profiling)
+    IPC_MESSAGE_HANDLER(AtomMsg_StopV8Profiling, OnStopV8Profiling)
+    IPC_MESSAGE_HANDLER(AtomMsg_WriteV8HeapSnapshot, OnWriteV8HeapSnapshot)
+    IPC_MESSAGE_UNHANDLED(handled = false)
+  IPC_END_MESSAGE_MAP()
+  return handled;
+}
+
+void ResourceUsageReporter::OnRequestV8HeapStats() {
+  v8::Isolate* isolate = blink::MainThreadIsolate();
+  if (!isolate)
+    return;
+
+  v8::HeapStatistics heap;
+  isolate->GetHeapStatistics(&heap);
+  content::RenderThread::Get()->Send(new AtomViewHostMsg_V8HeapStats(
+      heap.total_heap_size(), heap.used_heap_size()));
+}
+
+void ResourceUsageReporter::OnStartV8Profiling(
+    uint64_t heap_sampling_interval,
+    int cpu_sampling_interval) {
+  v8::Isolate* isolate = blink::MainThreadIsolate();
+  if (!isolate)
+    return;
+
+  V8Profiler::Options options;
+  options.heap_sampling_interval = heap_sampling_interval;
+  options.cpu_sampling_interval = cpu_sampling_interval;
+  V8Profiler::From(isolate)->Start(options);
+}
+
+void ResourceUsageReporter::OnStopV8Profiling(
+    int request_id,
+    IPC::PlatformFileForTransit file) {
+  v8::Isolate* isolate = blink::MainThreadIsolate();
+  if (!isolate) {
+    OnV8ProfilingDone(request_id, false);
+    return;
+  }
+
+  V8Profiler::From(isolate)->Stop(
+      IPC::PlatformFileForTransitToFile(file),
+      base::Bind(&ResourceUsageReporter::OnV8ProfilingDone,
+                 weak_factory_.GetWeakPtr(), request_id));
+}
+
+void ResourceUsageReporter::OnWriteV8HeapSnapshot(
+    int request_id,
+    IPC::PlatformFileForTransit file) {
+  v8::Isolate* isolate = blink::MainThreadIsolate();
+  if (!isolate) {
+    OnV8ProfilingDone(request_id, false);
+    return;
+  }
+
+  V8Profiler::From(isolate)->WriteHeapSnapshot(
+      IPC::PlatformFileForTransitToFile(file),
+      base::Bind(&ResourceUsageReporter::OnV8ProfilingDone,
+                 weak_factory_.GetWeakPtr(), request_id));
+}
+
+void ResourceUsageReporter::OnV8ProfilingDone(int request_id, bool success) {
+  content::RenderThread::Get()->Send(
+      new AtomViewHostMsg_V8ProfilingDone(request_id, success));
+}
+
+}  // namespace atom
@@ -0,0 +1,43 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_RESOURCE_USAGE_REPORTER_H_
+#define ATOM_RENDERER_RESOURCE_USAGE_REPORTER_H_
+
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "content/public/renderer/render_thread_observer.h"
+#include "ipc/ipc_platform_file.h"
+
+namespace atom {
+
+// Answers the browser's requests for the size of the main thread V8 heap,
+// and profiles that isolate on request.
+class ResourceUsageReporter : public content::RenderThreadObserver {
+ public:
+  ResourceUsageReporter();
+  ~ResourceUsageReporter() override;
+
+ private:
+  // content::RenderThreadObserver:
+  bool OnControlMessageReceived(const IPC::Message& message) override;
+
+  void OnRequestV8HeapStats();
+  void OnStartV8Profiling(uint64_t heap_sampling_interval,
+                          int cpu_sampling_interval);
+  void OnStopV8Profiling(int request_id, IPC::PlatformFileForTransit file);
+  void OnWriteV8HeapSnapshot(int request_id,
+                             IPC::PlatformFileForTransit file);
+  void OnV8ProfilingDone(int request_id, bool success);
+
+  base::WeakPtrFactory<ResourceUsageReporter> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceUsageReporter);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_RESOURCE_USAGE_REPORTER_H_
@@ -18,6 +18,10 @@
 #include "base/files/file_path.h"
 #include "base/json/json_string_value_serializer.h"
 #include "base/strings/string_util.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/threading/thread_restrictions.h"
+#include "brave/browser/extensions/extension_manifest_cache.h"
+#include "brave/browser/extensions/extension_url_overrides.h"
 #include "brave/common/converters/callback_converter.h"
 #include "brave/common/converters/file_path_converter.h"
 #include "brave/common/converters/gurl_converter.h"
@@ -95,35 +99,112 @@ struct Converter<extensions::Manifest::Location> {
 
 namespace {
 
+const base::FilePath::CharType kManifestCacheDirname[] =
+    FILE_PATH_LITERAL("Extension Manifest Cache");
+
 scoped_refptr<extensions::Extension> LoadExtension(const base::FilePath& path,
     const base::DictionaryValue& manifest,
     const extensions::Manifest::Location& manifest_location,
     int flags,
+    std::vector<extensions::InstallWarning>* warnings,
     std::string* error) {
-  DCHECK_CURRENTLY_ON(content::BrowserThread::FILE);
+  base::AssertBlockingAllowed();
 
   scoped_refptr<extensions::Extension> extension(extensions::Extension::Create(
       path, manifest_location, manifest, flags, error));
   if (!extension.get())
     return NULL;
 
-  std::vector<extensions::InstallWarning> warnings;
-
   int resource_id;
   if (!IsComponentExtension(path, &resource_id)) {
     // Component extensions contained inside the resources pak fail manifest
     // validation so we skip validation.
     if (!extensions::file_util::ValidateExtension(extension.get(),
                                                   error,
-                                                  &warnings)) {
+                                                  warnings)) {
       return NULL;
     }
   }
-  extension->AddInstallWarnings(warnings);
+  extension->AddInstallWarnings(*warnings);
+
+  return extension;
+}
+
+// Extensions are loaded in parallel on the blocking pool. Unchanged unpacked
+// extensions come from |cache| and skip manifest parsing and validation;
+// component extensions are read from the resources pak, which is already
+// fast, and are never cached.
+scoped_refptr<extensions::Extension> LoadExtensionOnBlockingPool(
+    const brave::ExtensionManifestCache& cache,
+    const base::FilePath& path,
+    std::unique_ptr<base::DictionaryValue> manifest,
+    extensions::Manifest::Location manifest_location,
+    int flags,
+    std::string* error) {
+  int resource_id;
+  const bool is_component = IsComponentExtension(path, &resource_id);
+
+  brave::ExtensionManifestCache::Entry cached;
+  if (!is_component &&
+      cache.Get(path, manifest_location, flags, *manifest, &cached)) {
+    scoped_refptr<extensions::Extension> extension(
+        extensions::Extension::Create(
+            path, manifest_location, *cached.manifest, flags, error));
+    if (extension) {
+      extension->AddInstallWarnings(cached.install_warnings);
+      return extension;
+    }
+    error->clear();
+  }
+
+  if (manifest->empty())
+    manifest = brave::api::Extension::LoadManifest(path, error);
+  if (!manifest || !error->empty())
+    return nullptr;
+
+  std::vector<extensions::InstallWarning> warnings;
+  scoped_refptr<extensions::Extension> extension = LoadExtension(path,
+                            *manifest,
+                            manifest_location,
+                            flags,
+                            &warnings,
+                            error);
+  if (!extension || !error->empty())
+    return nullptr;
 
+  if (!is_component)
+    cache.Put(path, manifest_location, flags, *manifest, warnings);
   return extension;
 }
 
+// Reads rules of the form {prefix|host: String, replacement: String}.
+bool GetURLOverrideRules(gin::Arguments* args,
+    std::vector<brave::ExtensionURLOverrides::Rule>* rules) {
+  base::ListValue list;
+  if (!args->GetNext(&list))
+    return false;
+
+  for (const auto& value : list) {
+    const base::DictionaryValue* dict = nullptr;
+    if (!value.GetAsDictionary(&dict))
+      return false;
+
+    brave::ExtensionURLOverrides::Rule rule;
+    if (dict->GetString("prefix", &rule.pattern))
+      rule.type = brave::ExtensionURLOverrides::Rule::PREFIX;
+    else if (dict->GetString("host", &rule.pattern))
+      rule.type = brave::ExtensionURLOverrides::Rule::HOST;
+    else
+      return false;
+
+    if (rule.pattern.empty() ||
+        !dict->GetString("replacement", &rule.replacement))
+      return false;
+    rules->push_back(rule);
+  }
+  return true;
+}
+
 std::map<std::string,
   base::Callback<GURL(const GURL&)>> url_override_callbacks_;
 std::map<std::string,
@@ -155,13 +236,16 @@ gin::ObjectTemplateBuilder Extension::GetObjectTemplateBuilder(
       .SetMethod("enable", &Extension::Enable)
       .SetMethod("disable", &Extension::Disable)
       .SetMethod("setURLHandler", &Extension::SetURLHandler)
-      .SetMethod("setReverseURLHandler", &Extension::SetReverseURLHandler);
+      .SetMethod("setReverseURLHandler", &Extension::SetReverseURLHandler)
+      .SetMethod("setURLOverrides", &Extension::SetURLOverrides)
+      .SetMethod("setReverseURLOverrides", &Extension::SetReverseURLOverrides);
 }
 
 Extension::Extension(v8::Isolate* isolate,
                  BraveBrowserContext* browser_context)
     : isolate_(isolate),
-      browser_context_(browser_context) {
+      browser_context_(browser_context),
+      weak_factory_(this) {
   extensions::ExtensionRegistry::Get(browser_context_)->AddObserver(this);
 }
 
@@ -172,6 +256,7 @@ Extension::~Extension() {
   }
 }
 
+// static
 std::unique_ptr<base::DictionaryValue> Extension::LoadManifest(
     const base::FilePath& extension_root,
     std::string* error) {
@@ -208,41 +293,12 @@ std::unique_ptr<base::DictionaryValue> Extension::LoadManifest(
   }
 }
 
-void Extension::LoadOnFILEThread(const base::FilePath path,
-    std::unique_ptr<base::DictionaryValue> manifest,
-    extensions::Manifest::Location manifest_location,
-    int flags) {
-  DCHECK_CURRENTLY_ON(content::BrowserThread::FILE);
-
-  std::string error;
-  if (manifest->empty()) {
-    manifest = LoadManifest(path, &error);
-  }
-
-  if (!manifest || !error.empty()) {
-    content::BrowserThread::PostTask(
-          content::BrowserThread::UI, FROM_HERE,
-          base::Bind(&Extension::NotifyErrorOnUIThread,
-              base::Unretained(this), error));
-  } else {
-    scoped_refptr<extensions::Extension> extension = LoadExtension(path,
-                              *manifest,
-                              manifest_location,
-                              flags,
-                              &error);
-
-    if (!extension || !error.empty()) {
-      content::BrowserThread::PostTask(
-          content::BrowserThread::UI, FROM_HERE,
-          base::Bind(&Extension::NotifyErrorOnUIThread,
-              base::Unretained(this), error));
-    } else {
-      content::BrowserThread::PostTask(
-          content::BrowserThread::UI, FROM_HERE,
-          base::Bind(&Extension::NotifyLoadOnUIThread,
-              base::Unretained(this), base::Passed(&extension)));
-    }
-  }
+void Extension::OnLoaded(std::string* error,
+                         scoped_refptr<extensions::Extension> extension) {
+  if (!extension)
+    NotifyErrorOnUIThread(*error);
+  else
+    NotifyLoadOnUIThread(std::move(extension));
 }
 
 void Extension::NotifyLoadOnUIThread(
@@ -251,8 +307,7 @@ void Extension::NotifyLoadOnUIThread(
   extensions::ExtensionSystem::Get(browser_context_)->ready().Post(
         FROM_HERE,
         base::Bind(&Extension::AddExtension,
-          // GetWeakPtr()
-          base::Unretained(this), base::Passed(&extension)));
+          weak_factory_.GetWeakPtr(), base::Passed(&extension)));
 }
 
 void Extension::NotifyErrorOnUIThread(const std::string& error) {
@@ -283,11 +338,18 @@ void Extension::Load(gin::Arguments* args) {
   std::unique_ptr<base::DictionaryValue> manifest_copy =
       manifest.CreateDeepCopy();
 
-  content::BrowserThread::PostTask(
-        content::BrowserThread::FILE, FROM_HERE,
-        base::Bind(&Extension::LoadOnFILEThread,
-            base::Unretained(this),
-            path, Passed(&manifest_copy), manifest_location, flags));
+  brave::ExtensionManifestCache cache(
+      browser_context_->GetPath().Append(kManifestCacheDirname));
+  std::string* error = new std::string;
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::USER_BLOCKING,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::Bind(&LoadExtensionOnBlockingPool, cache, path,
+                 base::Passed(&manifest_copy), manifest_location, flags,
+                 base::Unretained(error)),
+      base::Bind(&Extension::OnLoaded, weak_factory_.GetWeakPtr(),
+                 base::Owned(error)));
 }
 
 void Extension::AddExtension(scoped_refptr<extensions::Extension> extension) {
@@ -329,6 +391,10 @@ void Extension::OnExtensionUnloaded(
     content::BrowserContext* browser_context,
     const extensions::Extension* extension,
     extensions::UnloadedExtensionReason reason) {
+  brave::ExtensionURLOverrides::GetInstance()->RemoveRules(extension->id());
+  url_override_callbacks_.erase(extension->id());
+  reverse_url_override_callbacks_.erase(extension->id());
+
   node::Environment* env = node::Environment::GetCurrent(isolate());
   if (!env)
     return;
@@ -454,6 +520,33 @@ void Extension::SetReverseURLHandler(gin::Arguments* args) {
   reverse_url_override_callbacks_[extension_id] = callback;
 }
 
+void Extension::SetURLOverrides(gin::Arguments* args) {
+  SetURLOverrideRules(args, brave::ExtensionURLOverrides::FORWARD);
+}
+
+void Extension::SetReverseURLOverrides(gin::Arguments* args) {
+  SetURLOverrideRules(args, brave::ExtensionURLOverrides::REVERSE);
+}
+
+void Extension::SetURLOverrideRules(gin::Arguments* args,
+    brave::ExtensionURLOverrides::Direction direction) {
+  std::string extension_id;
+  if (!args->GetNext(&extension_id)) {
+    args->ThrowTypeError("`extension_id` must be a string");
+    return;
+  }
+
+  std::vector<brave::ExtensionURLOverrides::Rule> rules;
+  if (!GetURLOverrideRules(args, &rules)) {
+    args->ThrowTypeError(
+        "`rules` must be an array of {prefix|host, replacement} objects");
+    return;
+  }
+
+  brave::ExtensionURLOverrides::GetInstance()->SetRules(
+      extension_id, direction, rules);
+}
+
 // static
 bool Extension::HandleURLOverride(GURL* url,
         content::BrowserContext* browser_context) {
@@ -464,6 +557,11 @@ bool Extension::HandleURLOverride(GURL* url,
   if (!extension)
     return false;
 
+  // Declarative rules don't need to call into script.
+  if (brave::ExtensionURLOverrides::GetInstance()->Rewrite(extension->id(),
+          brave::ExtensionURLOverrides::FORWARD, url))
+    return true;
+
   if (!base::ContainsKey(url_override_callbacks_, extension->id()))
     return false;
 
@@ -485,6 +583,10 @@ bool Extension::HandleURLOverrideReverse(GURL* url,
   if (!extension)
     return false;
 
+  if (brave::ExtensionURLOverrides::GetInstance()->Rewrite(extension->id(),
+          brave::ExtensionURLOverrides::REVERSE, url))
+    return true;
+
   if (!base::ContainsKey(reverse_url_override_callbacks_, extension->id()))
     return false;
 
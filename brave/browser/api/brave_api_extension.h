@@ -8,7 +8,9 @@
 #include <memory>
 #include <string>
 
+#include "base/memory/weak_ptr.h"
 #include "brave/browser/brave_browser_context.h"
+#include "brave/browser/extensions/extension_url_overrides.h"
 #include "extensions/browser/extension_registry_observer.h"
 #include "extensions/common/extension_set.h"
 #include "extensions/common/manifest.h"
@@ -53,6 +55,9 @@ class Extension : public gin::Wrappable<Extension>,
                                       content::BrowserContext* browser_context,
                                       const GURL& target_url);
 
+  static std::unique_ptr<base::DictionaryValue> LoadManifest(
+      const base::FilePath& extension_root,
+      std::string* error);
 
  protected:
   Extension(v8::Isolate* isolate, BraveBrowserContext* browser_context);
@@ -60,10 +65,8 @@ class Extension : public gin::Wrappable<Extension>,
 
   void NotifyLoadOnUIThread(scoped_refptr<extensions::Extension> extension);
   void NotifyErrorOnUIThread(const std::string& error);
-  void LoadOnFILEThread(const base::FilePath path,
-      std::unique_ptr<base::DictionaryValue> manifest,
-      extensions::Manifest::Location manifest_location,
-      int flags);
+  void OnLoaded(std::string* error,
+                scoped_refptr<extensions::Extension> extension);
   void Load(gin::Arguments* args);
   void AddExtension(scoped_refptr<extensions::Extension> extension);
   void OnExtensionReady(content::BrowserContext* browser_context,
@@ -74,6 +77,10 @@ class Extension : public gin::Wrappable<Extension>,
 
   void SetURLHandler(gin::Arguments* args);
   void SetReverseURLHandler(gin::Arguments* args);
+  void SetURLOverrides(gin::Arguments* args);
+  void SetReverseURLOverrides(gin::Arguments* args);
+  void SetURLOverrideRules(gin::Arguments* args,
+                           brave::ExtensionURLOverrides::Direction direction);
   void Disable(const std::string& extension_id);
   void Enable(const std::string& extension_id);
   v8::Isolate* isolate() { return isolate_; }
@@ -82,9 +89,7 @@ class Extension : public gin::Wrappable<Extension>,
   v8::Isolate* isolate_;  // not owned
   BraveBrowserContext* browser_context_;
 
-  std::unique_ptr<base::DictionaryValue> LoadManifest(
-      const base::FilePath& extension_root,
-      std::string* error);
+  base::WeakPtrFactory<Extension> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(Extension);
 };
@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include <memory>
+#include <set>
+#include <string>
 #include <utility>
 
 #include "brave/browser/brave_browser_context.h"
@@ -12,6 +14,7 @@
 #include "base/files/file_util.h"
 #include "base/trace_event/trace_event.h"
 #include "brave/browser/brave_permission_manager.h"
+#include "brave/browser/prefs/pref_write_metrics.h"
 #include "chrome/browser/background_fetch/background_fetch_delegate_factory.h"
 #include "chrome/browser/background_fetch/background_fetch_delegate_impl.h"
 #include "chrome/browser/browser_process.h"
@@ -52,6 +55,7 @@
 #include "net/cookies/cookie_store.h"
 #include "net/url_request/url_request_context.h"
 #include "net/url_request/url_request_job_factory_impl.h"
+#include "services/preferences/tracked/segregated_pref_store.h"
 
 #if BUILDFLAG(ENABLE_EXTENSIONS)
 #include "atom/browser/extensions/atom_browser_client_extensions_part.h"
@@ -83,6 +87,14 @@ const char kPrefExitTypeCrashed[] = "Crashed";
 const char kPrefExitTypeSessionEnded[] = "SessionEnded";
 const char kPrefExitTypeNormal[] = "Normal";
 
+// Large, frequently updated dictionary prefs that get their own file when
+// the partition is created with the |shard_prefs| option.
+const char* const kShardedPrefs[] = {
+  "app_state",
+  extensions::pref_names::kPrefContentSettings,
+  prefs::kPartitionPerHostZoomLevels,
+};
+
 #if BUILDFLAG(ENABLE_EXTENSIONS)
 // WATCH(bridiver) - chrome/browser/profiles/off_the_record_profile_impl.cc
 void NotifyOTRProfileCreatedOnIOThread(void* original_profile,
@@ -146,6 +158,7 @@ BraveBrowserContext::BraveBrowserContext(
     scoped_refptr<base::SequencedTaskRunner> io_task_runner)
     : Profile(partition, in_memory, options),
       pref_registry_(new user_prefs::PrefRegistrySyncable),
+      shard_prefs_(false),
       has_parent_(false),
       original_context_(nullptr),
       otr_context_(nullptr),
@@ -153,8 +166,10 @@ BraveBrowserContext::BraveBrowserContext(
       ready_(new base::WaitableEvent(
           base::WaitableEvent::ResetPolicy::MANUAL,
           base::WaitableEvent::InitialState::NOT_SIGNALED)),
+      async_prefs_(false),
       io_task_runner_(std::move(io_task_runner)),
-      delegate_(g_browser_process->profile_manager()) {
+      delegate_(g_browser_process->profile_manager()),
+      weak_ptr_factory_(this) {
   std::string parent_partition;
   if (options.GetString("parent_partition", &parent_partition)) {
     has_parent_ = true;
@@ -162,14 +177,27 @@ BraveBrowserContext::BraveBrowserContext(
         atom::AtomBrowserContext::From(parent_partition, false));
   }
 
+  options.GetBoolean("shard_prefs", &shard_prefs_);
+
   if (in_memory) {
     original_context_ = static_cast<BraveBrowserContext*>(
         atom::AtomBrowserContext::From(partition, false));
     original_context_->otr_context_ = this;
+  } else if (!has_parent_) {
+    options.GetBoolean("async", &async_prefs_);
   }
-  CreateProfilePrefs(io_task_runner_);
-  if (original_context_) {
-    TrackZoomLevelsFromParent();
+
+  if (!original_context_) {
+    CreateProfilePrefs(io_task_runner_);
+  } else if (original_context_->IsReady()) {
+    OnOriginalContextReady();
+  } else {
+    // The prefs of this partition are layered on those of the original
+    // partition, which is still loading if it was opened with
+    // fromPartitionAsync.
+    original_context_->RunWhenReady(
+        base::Bind(&BraveBrowserContext::OnOriginalContextReady,
+                   weak_ptr_factory_.GetWeakPtr()));
   }
 #if BUILDFLAG(ENABLE_EXTENSIONS)
   if (IsOffTheRecord()) {
@@ -200,9 +228,10 @@ BraveBrowserContext::~BraveBrowserContext() {
   #endif
 
   if (IsOffTheRecord()) {
-    auto user_prefs = user_prefs::UserPrefs::Get(this);
-    if (user_prefs)
-      user_prefs->ClearMutableValues();
+    // Prefs are not created when the original partition never finished
+    // loading.
+    if (user_prefs_)
+      user_prefs_->ClearMutableValues();
 #if BUILDFLAG(ENABLE_EXTENSIONS)
     ExtensionPrefValueMapFactory::GetForBrowserContext(
         original_context_)->ClearAllIncognitoSessionOnlyPreferences();
@@ -210,11 +239,13 @@ BraveBrowserContext::~BraveBrowserContext() {
   }
 
   if (!IsOffTheRecord() && !HasParentContext()) {
-    autofill_data_->ShutdownOnUISequence();
+    if (web_database_) {
+      autofill_data_->ShutdownOnUISequence();
 #if defined(OS_WIN)
-    password_data_->ShutdownOnUISequence();
+      password_data_->ShutdownOnUISequence();
 #endif
-    web_database_->ShutdownDatabase();
+      web_database_->ShutdownDatabase();
+    }
 
     bool prefs_loaded = user_prefs_->GetInitializationStatus() !=
         PrefService::INITIALIZATION_STATUS_WAITING;
@@ -418,7 +449,7 @@ void BraveBrowserContext::CreateProfilePrefs(
 #endif
   user_prefs_registrar_.reset(new PrefChangeRegistrar());
 
-  bool async = false;
+  bool async = async_prefs_;
 
   if (IsOffTheRecord()) {
     overlay_pref_names_.push_back("app_state");
@@ -473,10 +504,8 @@ void BraveBrowserContext::CreateProfilePrefs(
         RegisterProfilePrefsForServices(this, pref_registry_.get());
 
     // create profile prefs
-    base::FilePath filepath = GetPath().Append(
-        FILE_PATH_LITERAL("UserPrefs"));
-    scoped_refptr<JsonPrefStore> pref_store = new JsonPrefStore(
-        filepath, io_task_runner, std::unique_ptr<PrefFilter>());
+    scoped_refptr<PersistentPrefStore> pref_store =
+        CreateUserPrefStore(io_task_runner);
 
     // prepare factory
     sync_preferences::PrefServiceSyncableFactory factory;
@@ -495,9 +524,121 @@ void BraveBrowserContext::CreateProfilePrefs(
   OnPrefsLoaded(true);
 }
 
+scoped_refptr<PersistentPrefStore> BraveBrowserContext::CreateJsonPrefStore(
+    const base::FilePath& path,
+    scoped_refptr<base::SequencedTaskRunner> io_task_runner) {
+  scoped_refptr<PrefWriteMetrics> metrics = new PrefWriteMetrics(path);
+  pref_write_metrics_.push_back(metrics);
+  return new JsonPrefStore(path, io_task_runner, metrics->CreateFilter());
+}
+
+scoped_refptr<PersistentPrefStore> BraveBrowserContext::CreateUserPrefStore(
+    scoped_refptr<base::SequencedTaskRunner> io_task_runner) {
+  base::FilePath filepath = GetPath().Append(FILE_PATH_LITERAL("UserPrefs"));
+  main_pref_store_ = CreateJsonPrefStore(filepath, io_task_runner);
+  if (!shard_prefs_)
+    return main_pref_store_;
+
+  // Each shard is a separate JsonPrefStore so it is serialized and written
+  // independently of the others. SegregatedPrefStore routes reads and writes
+  // for the shard's pref name to the shard and everything else to the
+  // store it wraps.
+  scoped_refptr<PersistentPrefStore> pref_store = main_pref_store_;
+  for (const char* pref_name : kShardedPrefs) {
+    scoped_refptr<PersistentPrefStore> shard = CreateJsonPrefStore(
+        filepath.AddExtension(base::FilePath::FromUTF8Unsafe(pref_name)),
+        io_task_runner);
+    pref_shards_.push_back(std::make_pair(std::string(pref_name), shard));
+    pref_store = new SegregatedPrefStore(pref_store, shard,
+                                         std::set<std::string>({pref_name}));
+  }
+  return pref_store;
+}
+
+// Moves values that were written before the partition was sharded out of
+// the main pref file. SegregatedPrefStore never reads a sharded pref from
+// the main store so they would otherwise be lost.
+void BraveBrowserContext::MigrateShardedPrefs() {
+  for (const auto& shard : pref_shards_) {
+    const base::Value* value = nullptr;
+    if (shard.second->GetValue(shard.first, &value) ||
+        !main_pref_store_->GetValue(shard.first, &value))
+      continue;
+
+    shard.second->SetValue(shard.first, value->CreateDeepCopy(),
+        WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+    main_pref_store_->RemoveValue(shard.first,
+        WriteablePrefStore::DEFAULT_PREF_WRITE_FLAGS);
+  }
+  pref_shards_.clear();
+  main_pref_store_ = nullptr;
+}
+
+std::unique_ptr<base::ListValue> BraveBrowserContext::GetPrefWriteMetrics() {
+  std::unique_ptr<base::ListValue> metrics(new base::ListValue);
+  for (const auto& pref_write_metrics :
+      original_context()->pref_write_metrics_)
+    metrics->Append(pref_write_metrics->ToValue());
+  return metrics;
+}
+
+// The web database is only opened when autofill or the password manager
+// first ask for it so partitions that never use them don't pay for it.
+void BraveBrowserContext::InitWebDataServices() {
+  DCHECK(!IsOffTheRecord() && !HasParentContext());
+  if (web_database_)
+    return;
+
+  // Initialize autofill db
+  base::FilePath webDataPath = GetPath().Append(kWebDataFilename);
+
+  CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  web_database_ = new WebDatabaseService(webDataPath,
+      BrowserThread::GetTaskRunnerForThread(BrowserThread::UI),
+      BrowserThread::GetTaskRunnerForThread(BrowserThread::DB));
+  web_database_->AddTable(base::WrapUnique(new autofill::AutofillTable));
+  web_database_->AddTable(base::WrapUnique(new LoginsTable));
+  web_database_->LoadDatabase();
+
+  autofill_data_ = new autofill::AutofillWebDataService(
+      web_database_,
+      BrowserThread::GetTaskRunnerForThread(BrowserThread::UI),
+      BrowserThread::GetTaskRunnerForThread(BrowserThread::DB),
+      base::Bind(&DatabaseErrorCallback));
+  autofill_data_->Init();
+
+#if defined(OS_WIN)
+  password_data_ = new PasswordWebDataService(
+      web_database_,
+      BrowserThread::GetTaskRunnerForThread(BrowserThread::UI),
+      base::Bind(&PasswordErrorCallback));
+  password_data_->Init();
+#endif
+}
+
+void BraveBrowserContext::RunWhenReady(const base::Closure& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (ready_->IsSignaled()) {
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE, callback);
+    return;
+  }
+  ready_callbacks_.push_back(callback);
+}
+
+bool BraveBrowserContext::IsReady() const {
+  return ready_->IsSignaled();
+}
+
+void BraveBrowserContext::OnOriginalContextReady() {
+  CreateProfilePrefs(io_task_runner_);
+  TrackZoomLevelsFromParent();
+}
+
 void BraveBrowserContext::OnPrefsLoaded(bool success) {
   CHECK(success);
 
+  MigrateShardedPrefs();
+
   BrowserContextDependencyManager::GetInstance()->
       CreateBrowserContextServices(this);
 
@@ -523,32 +664,6 @@ void BraveBrowserContext::OnPrefsLoaded(bool success) {
       prefs()->SetFilePath(prefs::kDownloadDefaultDirectory,
           base::FilePath());
     }
-
-    // Initialize autofill db
-    base::FilePath webDataPath = GetPath().Append(kWebDataFilename);
-
-    CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
-    web_database_ = new WebDatabaseService(webDataPath,
-        BrowserThread::GetTaskRunnerForThread(BrowserThread::UI),
-        BrowserThread::GetTaskRunnerForThread(BrowserThread::DB));
-    web_database_->AddTable(base::WrapUnique(new autofill::AutofillTable));
-    web_database_->AddTable(base::WrapUnique(new LoginsTable));
-    web_database_->LoadDatabase();
-
-    autofill_data_ = new autofill::AutofillWebDataService(
-        web_database_,
-        BrowserThread::GetTaskRunnerForThread(BrowserThread::UI),
-        BrowserThread::GetTaskRunnerForThread(BrowserThread::DB),
-        base::Bind(&DatabaseErrorCallback));
-    autofill_data_->Init();
-
-#if defined(OS_WIN)
-    password_data_ = new PasswordWebDataService(
-        web_database_,
-        BrowserThread::GetTaskRunnerForThread(BrowserThread::UI),
-        base::Bind(&PasswordErrorCallback));
-    password_data_->Init();
-#endif
   }
 
   user_prefs_registrar_->Init(user_prefs_.get());
@@ -559,6 +674,11 @@ void BraveBrowserContext::OnPrefsLoaded(bool success) {
 
   ready_->Signal();
 
+  std::vector<base::Closure> ready_callbacks;
+  ready_callbacks.swap(ready_callbacks_);
+  for (const auto& callback : ready_callbacks)
+    callback.Run();
+
   if (delegate_) {
     TRACE_EVENT0("browser",
         "ProfileImpl::OnPrefsLoaded:DelegateOnProfileCreated")
@@ -586,12 +706,14 @@ BraveBrowserContext::CreateZoomLevelDelegate(
 
 scoped_refptr<autofill::AutofillWebDataService>
 BraveBrowserContext::GetAutofillWebdataService() {
+  original_context()->InitWebDataServices();
   return original_context()->autofill_data_;
 }
 
 #if defined(OS_WIN)
 scoped_refptr<PasswordWebDataService>
 BraveBrowserContext::GetPasswordWebdataService() {
+  original_context()->InitWebDataServices();
   return original_context()->password_data_;
 }
 #endif
@@ -665,7 +787,8 @@ void CreateDirectoryAndSignal(const base::FilePath& path,
                               base::WaitableEvent* done_creating) {
   if (!base::PathExists(path)) {
     DVLOG(1) << "Creating directory " << path.value();
-    base::CreateDirectory(path);
+    if (!base::CreateDirectory(path))
+      LOG(ERROR) << "Failed to create profile directory " << path.value();
   }
   done_creating->Signal();
 }
@@ -676,9 +799,10 @@ void BlockFileThreadOnDirectoryCreate(base::WaitableEvent* done_creating) {
   done_creating->Wait();
 }
 
-// Initiates creation of profile directory on |io_task_runner| and ensures that
-// FILE thread is blocked until that operation finishes. If |create_readme| is
-// true, the profile README will be created in the profile directory.
+// Creates the profile directory on |io_task_runner|, ahead of the pref store
+// reads and writes that the profile posts to that sequence. The FILE thread is
+// blocked until then, so the tasks other services of the profile post there
+// find the directory as well. The UI thread never waits for it.
 void CreateProfileDirectory(base::SequencedTaskRunner* io_task_runner,
                             const base::FilePath& path) {
   base::WaitableEvent* done_creating =
@@ -686,8 +810,6 @@ void CreateProfileDirectory(base::SequencedTaskRunner* io_task_runner,
                               base::WaitableEvent::InitialState::NOT_SIGNALED);
   io_task_runner->PostTask(
       FROM_HERE, base::Bind(&CreateDirectoryAndSignal, path, done_creating));
-  // Block the FILE thread until directory is created on I/O task runner to make
-  // sure that we don't attempt any operation until that part completes.
   BrowserThread::PostTask(
       BrowserThread::FILE, FROM_HERE,
       base::Bind(&BlockFileThreadOnDirectoryCreate,
@@ -7,9 +7,11 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "atom/browser/atom_browser_context.h"
+#include "base/memory/weak_ptr.h"
 #include "content/public/browser/host_zoom_map.h"
 #include "chrome/browser/custom_handlers/protocol_handler_registry.h"
 #include "chrome/browser/profiles/profile.h"
@@ -21,6 +23,7 @@
 #include "components/prefs/overlay_user_pref_store.h"
 #include "components/webdata/common/web_database_service.h"
 
+class PersistentPrefStore;
 class PrefChangeRegistrar;
 
 namespace extensions {
@@ -38,6 +41,7 @@ class PrefRegistrySyncable;
 namespace brave {
 
 class BravePermissionManager;
+class PrefWriteMetrics;
 
 class BraveBrowserContext : public Profile {
  public:
@@ -114,6 +118,17 @@ class BraveBrowserContext : public Profile {
   std::string partition_with_prefix();
   base::WaitableEvent* ready() { return ready_.get(); }
 
+  // Runs |callback| on the UI thread once prefs have been loaded. Partitions
+  // created with the |async| option load their prefs on the profile's
+  // sequenced task runner so this may be well after construction, and so
+  // may their child and off the record partitions.
+  void RunWhenReady(const base::Closure& callback);
+  bool IsReady() const;
+
+  base::WeakPtr<BraveBrowserContext> GetWeakPtr() {
+    return weak_ptr_factory_.GetWeakPtr();
+  }
+
   void AddOverlayPref(const std::string name) override {
     overlay_pref_names_.push_back(name.c_str()); }
 
@@ -129,7 +144,18 @@ class BraveBrowserContext : public Profile {
 
   void SetExitType(ExitType exit_type) override;
 
+  // Write counters for each pref file backing this partition
+  std::unique_ptr<base::ListValue> GetPrefWriteMetrics();
+
  private:
+  scoped_refptr<PersistentPrefStore> CreateUserPrefStore(
+      scoped_refptr<base::SequencedTaskRunner> io_task_runner);
+  scoped_refptr<PersistentPrefStore> CreateJsonPrefStore(
+      const base::FilePath& path,
+      scoped_refptr<base::SequencedTaskRunner> io_task_runner);
+  void MigrateShardedPrefs();
+  void InitWebDataServices();
+  void OnOriginalContextReady();
   void OnPrefsLoaded(bool success);
   void TrackZoomLevelsFromParent();
   void OnParentZoomLevelChanged(
@@ -141,6 +167,14 @@ class BraveBrowserContext : public Profile {
   std::unique_ptr<PrefChangeRegistrar> user_prefs_registrar_;
   std::vector<const char*> overlay_pref_names_;
 
+  // When |shard_prefs_| is set the largest dictionary prefs are kept in their
+  // own files so a change to one of them doesn't rewrite the whole profile.
+  bool shard_prefs_;
+  scoped_refptr<PersistentPrefStore> main_pref_store_;
+  std::vector<std::pair<std::string, scoped_refptr<PersistentPrefStore>>>
+      pref_shards_;
+  std::vector<scoped_refptr<PrefWriteMetrics>> pref_write_metrics_;
+
   std::unique_ptr<content::HostZoomMap::Subscription> track_zoom_subscription_;
     std::unique_ptr<ChromeZoomLevelPrefs::DefaultZoomLevelSubscription>
         parent_default_zoom_level_subscription_;
@@ -152,6 +186,8 @@ class BraveBrowserContext : public Profile {
   BraveBrowserContext* otr_context_;
   const std::string partition_;
   std::unique_ptr<base::WaitableEvent> ready_;
+  bool async_prefs_;
+  std::vector<base::Closure> ready_callbacks_;
 
   scoped_refptr<autofill::AutofillWebDataService> autofill_data_;
 #if defined(OS_WIN)
@@ -167,6 +203,8 @@ class BraveBrowserContext : public Profile {
   extensions::InfoMap* info_map_;  // not owned
   Profile::Delegate* delegate_;
 
+  base::WeakPtrFactory<BraveBrowserContext> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(BraveBrowserContext);
 };
 
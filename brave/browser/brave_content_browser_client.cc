@@ -6,6 +6,8 @@
 
 #include "brave/browser/brave_content_browser_client.h"
 
+#include "atom/browser/renderer_channel_subscriptions.h"
+#include "atom/browser/resource_usage_sampler.h"
 #include "atom/browser/web_contents_permission_helper.h"
 #include "atom/browser/web_contents_preferences.h"
 #include "atom/common/options_switches.h"
@@ -16,6 +18,7 @@
 #include "base/strings/utf_string_conversions.h"
 #include "brave/browser/notifications/platform_notification_service_impl.h"
 #include "brave/browser/password_manager/brave_password_manager_client.h"
+#include "brave/browser/resource_coordinator/background_tab_policy.h"
 #include "brave/grit/brave_resources.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/cache_stats_recorder.h"
@@ -394,6 +397,7 @@ void BraveContentBrowserClient::RenderProcessWillLaunch(
 
   host->AddFilter(new printing::PrintingMessageFilter(id, profile));
   host->AddFilter(new TtsMessageFilter(host->GetBrowserContext()));
+  host->AddFilter(new atom::ResourceUsageFilter(id));
 
 #if BUILDFLAG(USE_BROWSER_SPELLCHECKER)
   host->AddFilter(new SpellCheckMessageFilterPlatform(id));
@@ -401,6 +405,10 @@ void BraveContentBrowserClient::RenderProcessWillLaunch(
 
 #if BUILDFLAG(ENABLE_EXTENSIONS)
   extensions_part_->RenderProcessWillLaunch(host);
+
+  // Only script contexts with extension bindings report their ipc listeners.
+  atom::RendererChannelSubscriptions::GetInstance()->AddProcess(id);
+  host->AddFilter(new atom::RendererChannelSubscriptionsFilter(id));
 #endif
 
   RendererContentSettingRules rules;
@@ -559,6 +567,9 @@ void BraveContentBrowserClient::AppendExtraCommandLineSwitches(
       command_line->AppendSwitch(
           switches::kDisableClientSidePhishingDetection);
       // }
+
+      BackgroundTabPolicy::FromBrowserContext(process->GetBrowserContext())->
+          AppendRendererSwitches(command_line);
     }
 
     static const char* const kSwitchNames[] = {
@@ -0,0 +1,241 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/extensions/extension_manifest_cache.h"
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/md5.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/values.h"
+#include "components/version_info/version_info.h"
+#include "extensions/common/constants.h"
+
+namespace brave {
+
+namespace {
+
+const char kKey[] = "key";
+const char kManifest[] = "manifest";
+const char kInstallWarnings[] = "install_warnings";
+const char kMessage[] = "message";
+const char kWarningKey[] = "key";
+const char kSpecific[] = "specific";
+
+// Adds every string in |value| that names a file of the extension, which
+// covers the icons, scripts and pages validation checks without knowing the
+// manifest keys that refer to them.
+void CollectReferencedPaths(const base::Value& value,
+                            std::set<std::string>* paths) {
+  std::string path;
+  const base::DictionaryValue* dict = nullptr;
+  const base::ListValue* list = nullptr;
+  if (value.GetAsString(&path)) {
+    path.erase(0, path.find_first_not_of('/'));
+    if (!path.empty())
+      paths->insert(path);
+  } else if (value.GetAsDictionary(&dict)) {
+    for (base::DictionaryValue::Iterator it(*dict); !it.IsAtEnd();
+         it.Advance())
+      CollectReferencedPaths(it.value(), paths);
+  } else if (value.GetAsList(&list)) {
+    for (const auto& item : *list)
+      CollectReferencedPaths(item, paths);
+  }
+}
+
+std::string GetFileStamp(const base::FilePath& path) {
+  base::File::Info info;
+  if (!base::GetFileInfo(path, &info))
+    return path.AsUTF8Unsafe() + "|missing";
+  return path.AsUTF8Unsafe() + "|" + base::Int64ToString(info.size) + "|" +
+         base::Int64ToString(info.last_modified.ToInternalValue());
+}
+
+// Validation depends on the manifest, the files it refers to and the message
+// catalogs it is localized with, so those are part of the key, with their
+// size and modification time. The rest of the extension is never looked at,
+// which keeps a cache hit cheap for large extensions. Returns false when the
+// extension has no manifest.
+bool GetFilesDigest(const base::FilePath& extension_path,
+                    std::string* digest) {
+  std::string manifest;
+  if (!base::ReadFileToString(
+          extension_path.Append(extensions::kManifestFilename), &manifest))
+    return false;
+
+  base::MD5Context context;
+  base::MD5Init(&context);
+  base::MD5Update(&context, manifest);
+
+  std::set<std::string> paths;
+  std::unique_ptr<base::Value> value = base::JSONReader::Read(manifest);
+  if (value)
+    CollectReferencedPaths(*value, &paths);
+  for (const auto& path : paths) {
+    base::FilePath file_path = base::FilePath::FromUTF8Unsafe(path);
+    // Most strings are names, URLs or match patterns, which do not exist as
+    // files and only cost a failed stat.
+    if (file_path.IsAbsolute() || file_path.ReferencesParent())
+      continue;
+    base::FilePath full_path = extension_path.Append(file_path);
+    if (!base::PathExists(full_path))
+      continue;
+    base::MD5Update(&context, GetFileStamp(full_path));
+    base::MD5Update(&context, "\n");
+  }
+
+  std::vector<std::string> locales;
+  base::FileEnumerator enumerator(
+      extension_path.Append(extensions::kLocaleFolder), false,
+      base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next())
+    locales.push_back(GetFileStamp(path.Append(extensions::kMessagesFilename)));
+  // The enumeration order is not defined.
+  std::sort(locales.begin(), locales.end());
+  for (const auto& locale : locales) {
+    base::MD5Update(&context, locale);
+    base::MD5Update(&context, "\n");
+  }
+
+  base::MD5Digest result;
+  base::MD5Final(&result, &context);
+  *digest = base::MD5DigestToBase16(result);
+  return true;
+}
+
+// Validation can change between versions, so they do not share entries.
+bool GetEntryKey(const base::FilePath& extension_path,
+                 extensions::Manifest::Location location,
+                 int flags,
+                 std::string* key) {
+  std::string files_digest;
+  if (!GetFilesDigest(extension_path, &files_digest))
+    return false;
+
+  *key = base::StringPrintf("%s|%d|%d|%s|%s",
+                            version_info::GetVersionNumber().c_str(),
+                            location,
+                            flags,
+                            files_digest.c_str(),
+                            extension_path.AsUTF8Unsafe().c_str());
+  return true;
+}
+
+}  // namespace
+
+ExtensionManifestCache::Entry::Entry() {
+}
+
+ExtensionManifestCache::Entry::~Entry() {
+}
+
+ExtensionManifestCache::ExtensionManifestCache(const base::FilePath& cache_dir)
+    : cache_dir_(cache_dir) {
+}
+
+ExtensionManifestCache::~ExtensionManifestCache() {
+}
+
+bool ExtensionManifestCache::Get(
+    const base::FilePath& extension_path,
+    extensions::Manifest::Location location,
+    int flags,
+    const base::DictionaryValue& provided_manifest,
+    Entry* entry) const {
+  base::AssertBlockingAllowed();
+
+  std::string expected_key;
+  if (!GetEntryKey(extension_path, location, flags, &expected_key))
+    return false;
+
+  std::string contents;
+  if (!base::ReadFileToString(GetEntryPath(extension_path), &contents))
+    return false;
+
+  std::unique_ptr<base::DictionaryValue> root =
+      base::DictionaryValue::From(base::JSONReader::Read(contents));
+  std::string key;
+  base::DictionaryValue* manifest = nullptr;
+  base::ListValue* warnings = nullptr;
+  if (!root ||
+      !root->GetString(kKey, &key) || key != expected_key ||
+      !root->GetDictionary(kManifest, &manifest) ||
+      !root->GetList(kInstallWarnings, &warnings))
+    return false;
+
+  if (!provided_manifest.empty() && !provided_manifest.Equals(manifest))
+    return false;
+
+  std::vector<extensions::InstallWarning> install_warnings;
+  for (const auto& value : *warnings) {
+    const base::DictionaryValue* warning = nullptr;
+    std::string message, warning_key, specific;
+    if (!value.GetAsDictionary(&warning) ||
+        !warning->GetString(kMessage, &message) ||
+        !warning->GetString(kWarningKey, &warning_key) ||
+        !warning->GetString(kSpecific, &specific))
+      return false;
+    install_warnings.push_back(
+        extensions::InstallWarning(message, warning_key, specific));
+  }
+
+  entry->manifest = manifest->CreateDeepCopy();
+  entry->install_warnings.swap(install_warnings);
+  return true;
+}
+
+void ExtensionManifestCache::Put(
+    const base::FilePath& extension_path,
+    extensions::Manifest::Location location,
+    int flags,
+    const base::DictionaryValue& manifest,
+    const std::vector<extensions::InstallWarning>& install_warnings) const {
+  base::AssertBlockingAllowed();
+
+  std::string key;
+  if (!GetEntryKey(extension_path, location, flags, &key))
+    return;
+
+  auto warnings = std::make_unique<base::ListValue>();
+  for (const auto& install_warning : install_warnings) {
+    auto warning = std::make_unique<base::DictionaryValue>();
+    warning->SetString(kMessage, install_warning.message);
+    warning->SetString(kWarningKey, install_warning.key);
+    warning->SetString(kSpecific, install_warning.specific);
+    warnings->Append(std::move(warning));
+  }
+
+  base::DictionaryValue root;
+  root.SetString(kKey, key);
+  root.Set(kManifest, manifest.CreateDeepCopy());
+  root.Set(kInstallWarnings, std::move(warnings));
+
+  std::string contents;
+  if (!base::JSONWriter::Write(root, &contents) ||
+      !base::CreateDirectory(cache_dir_))
+    return;
+
+  base::ImportantFileWriter::WriteFileAtomically(GetEntryPath(extension_path),
+                                                 contents);
+}
+
+base::FilePath ExtensionManifestCache::GetEntryPath(
+    const base::FilePath& extension_path) const {
+  return cache_dir_.AppendASCII(
+      base::MD5String(extension_path.AsUTF8Unsafe()) + ".json");
+}
+
+}  // namespace brave
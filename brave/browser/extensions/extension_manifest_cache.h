@@ -0,0 +1,64 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_EXTENSIONS_EXTENSION_MANIFEST_CACHE_H_
+#define BRAVE_BROWSER_EXTENSIONS_EXTENSION_MANIFEST_CACHE_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "extensions/common/install_warning.h"
+#include "extensions/common/manifest.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace brave {
+
+// Remembers the manifests of extensions that passed validation, with the
+// warnings validation produced, so an unchanged extension is not parsed and
+// validated again on the next launch. There is one file per extension path
+// under |cache_dir|. An entry is only used while the manifest, the files it
+// refers to and the message catalogs keep the contents, sizes and
+// modification times they were stored with, since validation depends on
+// them. All methods block and may run on any thread.
+class ExtensionManifestCache {
+ public:
+  struct Entry {
+    Entry();
+    ~Entry();
+
+    std::unique_ptr<base::DictionaryValue> manifest;
+    std::vector<extensions::InstallWarning> install_warnings;
+  };
+
+  explicit ExtensionManifestCache(const base::FilePath& cache_dir);
+  ~ExtensionManifestCache();
+
+  // |provided_manifest| is the manifest the caller was given, or empty when
+  // it is read from |extension_path|. A non empty one must equal the cached
+  // manifest.
+  bool Get(const base::FilePath& extension_path,
+           extensions::Manifest::Location location,
+           int flags,
+           const base::DictionaryValue& provided_manifest,
+           Entry* entry) const;
+  void Put(const base::FilePath& extension_path,
+           extensions::Manifest::Location location,
+           int flags,
+           const base::DictionaryValue& manifest,
+           const std::vector<extensions::InstallWarning>& install_warnings)
+      const;
+
+ private:
+  base::FilePath GetEntryPath(const base::FilePath& extension_path) const;
+
+  base::FilePath cache_dir_;
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_EXTENSIONS_EXTENSION_MANIFEST_CACHE_H_
@@ -0,0 +1,130 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/extensions/extension_url_overrides.h"
+
+#include <set>
+
+#include "base/strings/string_util.h"
+#include "extensions/common/constants.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+base::LazyInstance<ExtensionURLOverrides>::Leaky g_url_overrides =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Longer chains of rules are treated as loops.
+const size_t kMaxRewrites = 8;
+
+bool ApplyRule(const ExtensionURLOverrides::Rule& rule,
+               const GURL& url,
+               GURL* result) {
+  switch (rule.type) {
+    case ExtensionURLOverrides::Rule::PREFIX: {
+      const std::string& spec = url.spec();
+      if (!base::StartsWith(spec, rule.pattern, base::CompareCase::SENSITIVE))
+        return false;
+      *result = GURL(rule.replacement + spec.substr(rule.pattern.size()));
+      return true;
+    }
+    case ExtensionURLOverrides::Rule::HOST: {
+      if (url.host_piece() != rule.pattern)
+        return false;
+      GURL::Replacements replacements;
+      replacements.SetHostStr(rule.replacement);
+      *result = url.ReplaceComponents(replacements);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+// static
+ExtensionURLOverrides* ExtensionURLOverrides::GetInstance() {
+  return g_url_overrides.Pointer();
+}
+
+ExtensionURLOverrides::ExtensionURLOverrides() {
+}
+
+ExtensionURLOverrides::~ExtensionURLOverrides() {
+}
+
+void ExtensionURLOverrides::SetRules(const std::string& extension_id,
+                                     Direction direction,
+                                     const std::vector<Rule>& rules) {
+  base::AutoLock lock(lock_);
+  if (rules.empty())
+    this->rules(direction).erase(extension_id);
+  else
+    this->rules(direction)[extension_id] = rules;
+}
+
+void ExtensionURLOverrides::RemoveRules(const std::string& extension_id) {
+  base::AutoLock lock(lock_);
+  forward_rules_.erase(extension_id);
+  reverse_rules_.erase(extension_id);
+}
+
+bool ExtensionURLOverrides::Rewrite(const std::string& extension_id,
+                                    Direction direction,
+                                    GURL* url) const {
+  base::AutoLock lock(lock_);
+  auto it = rules(direction).find(extension_id);
+  if (it == rules(direction).end())
+    return false;
+
+  for (const auto& rule : it->second) {
+    GURL result;
+    if (ApplyRule(rule, *url, &result)) {
+      if (!result.is_valid())
+        return false;
+      *url = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ExtensionURLOverrides::RewriteExtensionURL(Direction direction,
+                                                GURL* url) const {
+  if (!url->SchemeIs(extensions::kExtensionScheme))
+    return false;
+  return Rewrite(url->host(), direction, url);
+}
+
+bool ExtensionURLOverrides::ResolveExtensionURL(GURL* url) const {
+  std::set<GURL> visited = {*url};
+  GURL current = *url;
+  for (size_t i = 0; i < kMaxRewrites; ++i) {
+    GURL next = current;
+    if (!RewriteExtensionURL(FORWARD, &next)) {
+      if (i == 0)
+        return false;
+      *url = current;
+      return true;
+    }
+    if (!visited.insert(next).second)
+      return false;
+    current = next;
+  }
+  return false;
+}
+
+ExtensionURLOverrides::RuleMap& ExtensionURLOverrides::rules(
+    Direction direction) {
+  return direction == FORWARD ? forward_rules_ : reverse_rules_;
+}
+
+const ExtensionURLOverrides::RuleMap& ExtensionURLOverrides::rules(
+    Direction direction) const {
+  return direction == FORWARD ? forward_rules_ : reverse_rules_;
+}
+
+}  // namespace brave
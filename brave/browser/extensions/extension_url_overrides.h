@@ -0,0 +1,90 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_EXTENSIONS_EXTENSION_URL_OVERRIDES_H_
+#define BRAVE_BROWSER_EXTENSIONS_EXTENSION_URL_OVERRIDES_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/lazy_instance.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+
+class GURL;
+
+namespace brave {
+
+// Declarative rewrites of extension URLs, registered per extension from JS and
+// evaluated natively, so rewriting a navigation does not run script. Reads
+// take a lock and are safe on any thread, including IO.
+class ExtensionURLOverrides {
+ public:
+  enum Direction {
+    FORWARD,
+    REVERSE,
+  };
+
+  struct Rule {
+    enum Type {
+      // URLs that start with |pattern| get it replaced by |replacement|.
+      PREFIX,
+      // URLs whose host equals |pattern| get |replacement| as their host.
+      HOST,
+    };
+
+    Type type;
+    std::string pattern;
+    std::string replacement;
+  };
+
+  static ExtensionURLOverrides* GetInstance();
+
+  // Replaces the rules of |extension_id|. Empty |rules| removes them.
+  void SetRules(const std::string& extension_id,
+                Direction direction,
+                const std::vector<Rule>& rules);
+  // Removes the rules of both directions, when the extension is unloaded.
+  void RemoveRules(const std::string& extension_id);
+
+  // Applies the first rule of |extension_id| that matches |url|. Returns false
+  // when no rule matches or the rewritten URL is invalid.
+  bool Rewrite(const std::string& extension_id,
+               Direction direction,
+               GURL* url) const;
+
+  // Same for chrome-extension URLs, which carry the extension id as their
+  // host, so no registry lookup is needed. The network delegate uses it on the
+  // IO thread to redirect the subresource requests that navigations, which
+  // are rewritten by BrowserURLHandler, don't cover.
+  bool RewriteExtensionURL(Direction direction, GURL* url) const;
+
+  // Follows the forward rules of chrome-extension URLs until none matches,
+  // so a redirect to the result is not rewritten again. Returns false when
+  // no rule matches, or when the rules lead back to a URL they already
+  // visited or don't settle within a few steps.
+  bool ResolveExtensionURL(GURL* url) const;
+
+ private:
+  friend struct base::LazyInstanceTraitsBase<ExtensionURLOverrides>;
+
+  using RuleMap = std::map<std::string, std::vector<Rule>>;
+
+  ExtensionURLOverrides();
+  ~ExtensionURLOverrides();
+
+  RuleMap& rules(Direction direction);
+  const RuleMap& rules(Direction direction) const;
+
+  mutable base::Lock lock_;
+  RuleMap forward_rules_;
+  RuleMap reverse_rules_;
+
+  DISALLOW_COPY_AND_ASSIGN(ExtensionURLOverrides);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_EXTENSIONS_EXTENSION_URL_OVERRIDES_H_
@@ -0,0 +1,192 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/guest_view/tab_view/spare_renderer_pool.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/metrics/histogram_macros.h"
+#include "brave/browser/guest_view/tab_view/spare_renderer_pool_factory.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/site_instance.h"
+#include "content/public/common/url_utils.h"
+#include "extensions/common/constants.h"
+#include "url/gurl.h"
+
+using content::BrowserThread;
+using content::RenderProcessHost;
+using content::SiteInstance;
+
+namespace brave {
+
+namespace {
+
+// Wait for things to settle after a tab has been opened before launching
+// its replacement.
+const int kReplenishDelayMs = 1000;
+const int kSuppressAfterPressureSeconds = 60;
+
+// The first navigation of these pages would leave the spare for a process
+// with other privileges.
+bool CanStartInSpare(const GURL& url) {
+  return !url.SchemeIs(extensions::kExtensionScheme) &&
+      !content::HasWebUIScheme(url);
+}
+
+}  // namespace
+
+SpareRendererPool::Stats::Stats()
+    : hits(0), misses(0), launched(0), dropped(0) {
+}
+
+// static
+SpareRendererPool* SpareRendererPool::FromBrowserContext(
+    content::BrowserContext* browser_context) {
+  return SpareRendererPoolFactory::GetForBrowserContext(browser_context);
+}
+
+SpareRendererPool::SpareRendererPool(content::BrowserContext* browser_context)
+    : browser_context_(browser_context),
+      target_size_(0) {
+}
+
+SpareRendererPool::~SpareRendererPool() {
+  DCHECK(spares_.empty());
+}
+
+scoped_refptr<SiteInstance> SpareRendererPool::Take(const GURL& url) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (target_size_ == 0 || !CanStartInSpare(url))
+    return nullptr;
+
+  scoped_refptr<SiteInstance> spare;
+  if (!spares_.empty()) {
+    spare = spares_.front().site_instance;
+    spares_.front().host->RemoveObserver(this);
+    spares_.pop_front();
+    stats_.hits++;
+  } else {
+    stats_.misses++;
+  }
+  UMA_HISTOGRAM_BOOLEAN("Brave.SpareRendererPool.Hit", !!spare);
+
+  ScheduleReplenish();
+  return spare;
+}
+
+void SpareRendererPool::SetTargetSize(size_t size) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  target_size_ = size;
+
+  if (target_size_ == 0) {
+    memory_pressure_listener_.reset();
+    replenish_timer_.Stop();
+    Drain();
+    return;
+  }
+
+  if (!memory_pressure_listener_) {
+    memory_pressure_listener_.reset(new base::MemoryPressureListener(
+        base::Bind(&SpareRendererPool::OnMemoryPressure,
+                   base::Unretained(this))));
+  }
+  while (spares_.size() > target_size_) {
+    spares_.back().host->RemoveObserver(this);
+    spares_.pop_back();
+    stats_.dropped++;
+  }
+  ScheduleReplenish();
+}
+
+void SpareRendererPool::Shutdown() {
+  memory_pressure_listener_.reset();
+  replenish_timer_.Stop();
+  Drain();
+}
+
+void SpareRendererPool::RenderProcessExited(RenderProcessHost* host,
+                                            base::TerminationStatus status,
+                                            int exit_code) {
+  RemoveSpare(host);
+  ScheduleReplenish();
+}
+
+void SpareRendererPool::RenderProcessHostDestroyed(RenderProcessHost* host) {
+  RemoveSpare(host);
+}
+
+void SpareRendererPool::ScheduleReplenish() {
+  if (spares_.size() >= target_size_ || replenish_timer_.IsRunning())
+    return;
+
+  base::TimeDelta delay =
+      base::TimeDelta::FromMilliseconds(kReplenishDelayMs);
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (suppressed_until_ > now)
+    delay = std::max(delay, suppressed_until_ - now);
+  replenish_timer_.Start(FROM_HERE, delay,
+                         base::Bind(&SpareRendererPool::Replenish,
+                                    base::Unretained(this)));
+}
+
+void SpareRendererPool::Replenish() {
+  if (spares_.size() >= target_size_ ||
+      RenderProcessHost::run_renderer_in_process())
+    return;
+
+  // A spare only helps if it gets a process of its own.
+  if (RenderProcessHost::ShouldTryToUseExistingProcessHost(browser_context_,
+                                                           GURL()))
+    return;
+
+  scoped_refptr<SiteInstance> spare = SiteInstance::Create(browser_context_);
+  RenderProcessHost* host = spare->GetProcess();
+  for (const auto& other : spares_) {
+    if (other.host == host)
+      return;
+  }
+  if (!host->Init())
+    return;
+
+  host->AddObserver(this);
+  spares_.push_back({spare, host});
+  stats_.launched++;
+
+  // Launch one process at a time to keep the cost of each step small.
+  ScheduleReplenish();
+}
+
+void SpareRendererPool::Drain() {
+  for (const auto& spare : spares_)
+    spare.host->RemoveObserver(this);
+  stats_.dropped += spares_.size();
+  spares_.clear();
+}
+
+void SpareRendererPool::RemoveSpare(RenderProcessHost* host) {
+  for (auto it = spares_.begin(); it != spares_.end(); ++it) {
+    if (it->host == host) {
+      host->RemoveObserver(this);
+      spares_.erase(it);
+      stats_.dropped++;
+      return;
+    }
+  }
+}
+
+void SpareRendererPool::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+    return;
+
+  suppressed_until_ = base::TimeTicks::Now() +
+      base::TimeDelta::FromSeconds(kSuppressAfterPressureSeconds);
+  replenish_timer_.Stop();
+  Drain();
+  ScheduleReplenish();
+}
+
+}  // namespace brave
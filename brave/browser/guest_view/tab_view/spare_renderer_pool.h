@@ -0,0 +1,109 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_GUEST_VIEW_TAB_VIEW_SPARE_RENDERER_POOL_H_
+#define BRAVE_BROWSER_GUEST_VIEW_TAB_VIEW_SPARE_RENDERER_POOL_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "content/public/browser/render_process_host_observer.h"
+
+class GURL;
+
+namespace content {
+class BrowserContext;
+class RenderProcessHost;
+class SiteInstance;
+}
+
+namespace brave {
+
+// Keeps renderer processes of a browser context launched ahead of time, so a
+// new tab does not wait for a process to start before its first navigation.
+// A spare is a SiteInstance without a site whose process has been
+// initialized; the tab that takes it is assigned its site on navigation.
+// The pool refills itself after a short delay and empties on memory pressure.
+class SpareRendererPool : public KeyedService,
+                          public content::RenderProcessHostObserver {
+ public:
+  struct Stats {
+    Stats();
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t launched;
+    uint64_t dropped;
+  };
+
+  static SpareRendererPool* FromBrowserContext(
+      content::BrowserContext* browser_context);
+
+  explicit SpareRendererPool(content::BrowserContext* browser_context);
+  ~SpareRendererPool() override;
+
+  // Returns a SiteInstance whose renderer is already running for a tab that
+  // first loads |url|, or nullptr if there is none. The pool is refilled in
+  // the background either way. Extension and WebUI pages need a process of
+  // their own, so they never get a spare and are not counted as hits or
+  // misses.
+  scoped_refptr<content::SiteInstance> Take(const GURL& url);
+
+  // Sets how many spares are kept. 0 disables the pool.
+  void SetTargetSize(size_t size);
+  size_t target_size() const { return target_size_; }
+  size_t size() const { return spares_.size(); }
+
+  const Stats& stats() const { return stats_; }
+
+  // KeyedService:
+  void Shutdown() override;
+
+  // content::RenderProcessHostObserver:
+  void RenderProcessExited(content::RenderProcessHost* host,
+                           base::TerminationStatus status,
+                           int exit_code) override;
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+
+ private:
+  struct Spare {
+    scoped_refptr<content::SiteInstance> site_instance;
+    // Kept so the process can be matched without asking |site_instance|,
+    // which would launch a new one once this has gone away.
+    content::RenderProcessHost* host;
+  };
+
+  void ScheduleReplenish();
+  void Replenish();
+  void Drain();
+  void RemoveSpare(content::RenderProcessHost* host);
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  content::BrowserContext* browser_context_;  // not owned
+  size_t target_size_;
+  std::deque<Spare> spares_;
+
+  // Spares are not launched again until then after memory pressure.
+  base::TimeTicks suppressed_until_;
+
+  base::OneShotTimer replenish_timer_;
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpareRendererPool);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_GUEST_VIEW_TAB_VIEW_SPARE_RENDERER_POOL_H_
@@ -0,0 +1,44 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/guest_view/tab_view/spare_renderer_pool_factory.h"
+
+#include "base/memory/singleton.h"
+#include "brave/browser/guest_view/tab_view/spare_renderer_pool.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+
+namespace brave {
+
+// static
+SpareRendererPool* SpareRendererPoolFactory::GetForBrowserContext(
+    content::BrowserContext* context) {
+  return static_cast<SpareRendererPool*>(
+      GetInstance()->GetServiceForBrowserContext(context, true));
+}
+
+// static
+SpareRendererPoolFactory* SpareRendererPoolFactory::GetInstance() {
+  return base::Singleton<SpareRendererPoolFactory>::get();
+}
+
+SpareRendererPoolFactory::SpareRendererPoolFactory()
+    : BrowserContextKeyedServiceFactory(
+        "SpareRendererPool",
+        BrowserContextDependencyManager::GetInstance()) {
+}
+
+SpareRendererPoolFactory::~SpareRendererPoolFactory() {
+}
+
+KeyedService* SpareRendererPoolFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new SpareRendererPool(context);
+}
+
+content::BrowserContext* SpareRendererPoolFactory::GetBrowserContextToUse(
+    content::BrowserContext* context) const {
+  return context;
+}
+
+}  // namespace brave
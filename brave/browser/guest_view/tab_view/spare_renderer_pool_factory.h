@@ -0,0 +1,45 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_GUEST_VIEW_TAB_VIEW_SPARE_RENDERER_POOL_FACTORY_H_
+#define BRAVE_BROWSER_GUEST_VIEW_TAB_VIEW_SPARE_RENDERER_POOL_FACTORY_H_
+
+#include "base/macros.h"
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+
+namespace base {
+template <typename T> struct DefaultSingletonTraits;
+}
+
+namespace brave {
+
+class SpareRendererPool;
+
+// Owns a SpareRendererPool for each browser context, including partitions
+// and off the record contexts, since renderers are not shared between them.
+class SpareRendererPoolFactory : public BrowserContextKeyedServiceFactory {
+ public:
+  static SpareRendererPool* GetForBrowserContext(
+      content::BrowserContext* context);
+
+  static SpareRendererPoolFactory* GetInstance();
+
+ private:
+  friend struct base::DefaultSingletonTraits<SpareRendererPoolFactory>;
+
+  SpareRendererPoolFactory();
+  ~SpareRendererPoolFactory() override;
+
+  // BrowserContextKeyedServiceFactory:
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  content::BrowserContext* GetBrowserContextToUse(
+      content::BrowserContext* context) const override;
+
+  DISALLOW_COPY_AND_ASSIGN(SpareRendererPoolFactory);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_GUEST_VIEW_TAB_VIEW_SPARE_RENDERER_POOL_FACTORY_H_
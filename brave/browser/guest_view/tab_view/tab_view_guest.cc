@@ -22,6 +22,7 @@
 #include "atom/browser/extensions/api/atom_extensions_api_client.h"
 #include "base/memory/ptr_util.h"
 #include "brave/browser/brave_browser_context.h"
+#include "brave/browser/guest_view/tab_view/spare_renderer_pool.h"
 #include "build/build_config.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/profiles/profile.h"
@@ -239,17 +240,12 @@ void TabViewGuest::DidInitialize(const base::DictionaryValue& create_params) {
 void TabViewGuest::CreateWebContents(
     const base::DictionaryValue& params,
     const WebContentsCreatedCallback& callback) {
-  v8::Isolate* isolate = v8::Isolate::GetCurrent();
-  v8::Locker locker(isolate);
-  v8::HandleScope handle_scope(isolate);
-
-  mate::Dictionary options = mate::Dictionary::CreateEmpty(isolate);
-
   std::string name;
-  if (params.GetString("name", &name))
-    options.Set("name", name);
+  params.GetString("name", &name);
   std::string partition;
   params.GetString("partition", &partition);
+  std::string src;
+  params.GetString("src", &src);
   base::DictionaryValue partition_options;
   std::string parent_partition;
   if (params.GetString("parent_partition", &parent_partition)) {
@@ -264,11 +260,44 @@ void TabViewGuest::CreateWebContents(
       partition_options.SetString("parent_partition", "");
     }
   }
-  atom::AtomBrowserContext* browser_context =
-      brave::BraveBrowserContext::FromPartition(partition, partition_options);
+  auto browser_context = static_cast<brave::BraveBrowserContext*>(
+      brave::BraveBrowserContext::FromPartition(partition, partition_options));
+  // the partition may still be loading if it was opened with
+  // fromPartitionAsync
+  if (!browser_context->IsReady()) {
+    browser_context->RunWhenReady(base::Bind(
+        &TabViewGuest::CreateWebContentsWhenReady,
+        weak_ptr_factory_.GetWeakPtr(), browser_context->GetWeakPtr(),
+        name, GURL(src), callback));
+    return;
+  }
+  CreateWebContentsWhenReady(browser_context->GetWeakPtr(), name, GURL(src),
+                             callback);
+}
+
+void TabViewGuest::CreateWebContentsWhenReady(
+    base::WeakPtr<BraveBrowserContext> browser_context,
+    const std::string& name,
+    const GURL& url,
+    const WebContentsCreatedCallback& callback) {
+  if (!browser_context) {
+    callback.Run(nullptr);
+    return;
+  }
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+
+  mate::Dictionary options = mate::Dictionary::CreateEmpty(isolate);
+  if (!name.empty())
+    options.Set("name", name);
 
-  content::WebContents::CreateParams create_params(browser_context);
+  content::WebContents::CreateParams create_params(browser_context.get());
   create_params.guest_delegate = this;
+  // Start in a renderer that was launched ahead of time when there is one.
+  create_params.site_instance =
+      SpareRendererPool::FromBrowserContext(browser_context.get())->Take(url);
 
   mate::Handle<atom::api::WebContents> new_api_web_contents =
       atom::api::WebContents::CreateWithParams(isolate, options, create_params);
@@ -404,7 +433,8 @@ TabViewGuest::TabViewGuest(WebContents* owner_web_contents)
     : GuestView<TabViewGuest>(owner_web_contents),
       api_web_contents_(nullptr),
       clone_(false),
-      can_run_detached_(true) {
+      can_run_detached_(true),
+      weak_ptr_factory_(this) {
 }
 
 TabViewGuest::~TabViewGuest() {
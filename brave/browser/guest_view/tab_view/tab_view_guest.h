@@ -11,6 +11,7 @@
 #include <string>
 
 #include "base/macros.h"
+#include "base/memory/weak_ptr.h"
 #include "components/guest_view/browser/guest_view.h"
 
 namespace atom {
@@ -21,6 +22,8 @@ class WebContents;
 
 namespace brave {
 
+class BraveBrowserContext;
+
 class TabViewGuest : public guest_view::GuestView<TabViewGuest> {
  public:
   static GuestViewBase* Create(content::WebContents* owner_web_contents);
@@ -57,6 +60,11 @@ class TabViewGuest : public guest_view::GuestView<TabViewGuest> {
       bool force_navigation);
   void NavigateGuest(const std::string& src, bool force_navigation);
   void ApplyAttributes(const base::DictionaryValue& params);
+  void CreateWebContentsWhenReady(
+      base::WeakPtr<BraveBrowserContext> browser_context,
+      const std::string& name,
+      const GURL& url,
+      const WebContentsCreatedCallback& callback);
 
   // GuestViewBase implementation.
   void GuestDestroyed() final;
@@ -108,6 +116,8 @@ class TabViewGuest : public guest_view::GuestView<TabViewGuest> {
   using PendingWindowMap = std::map<TabViewGuest*, NewWindowInfo>;
   PendingWindowMap pending_new_windows_;
 
+  base::WeakPtrFactory<TabViewGuest> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(TabViewGuest);
 };
 
@@ -0,0 +1,111 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/prefs/pref_write_metrics.h"
+
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/values.h"
+
+namespace brave {
+
+class PrefWriteMetrics::Filter : public PrefFilter {
+ public:
+  explicit Filter(scoped_refptr<PrefWriteMetrics> metrics)
+      : metrics_(std::move(metrics)) {}
+  ~Filter() override {}
+
+  // PrefFilter:
+  void FilterOnLoad(
+      const PostFilterOnLoadCallback& post_filter_on_load_callback,
+      std::unique_ptr<base::DictionaryValue> pref_store_contents) override {
+    post_filter_on_load_callback.Run(std::move(pref_store_contents), false);
+  }
+
+  void FilterUpdate(const std::string& path) override {}
+
+  // Called by JsonPrefStore right before it serializes |pref_store_contents|.
+  // The returned callbacks run on the file task runner around the write.
+  OnWriteCallbackPair FilterSerializeData(
+      base::DictionaryValue* pref_store_contents) override {
+    return std::make_pair(
+        base::Bind(&PrefWriteMetrics::OnBeforeWrite, metrics_,
+                   base::TimeTicks::Now()),
+        base::Bind(&PrefWriteMetrics::OnAfterWrite, metrics_));
+  }
+
+  void OnStoreDeletionFromDisk() override {}
+
+ private:
+  scoped_refptr<PrefWriteMetrics> metrics_;
+
+  DISALLOW_COPY_AND_ASSIGN(Filter);
+};
+
+PrefWriteMetrics::PrefWriteMetrics(const base::FilePath& path)
+    : path_(path),
+      write_count_(0),
+      failed_write_count_(0),
+      bytes_written_(0),
+      last_file_size_(0) {
+}
+
+PrefWriteMetrics::~PrefWriteMetrics() {
+}
+
+std::unique_ptr<PrefFilter> PrefWriteMetrics::CreateFilter() {
+  return std::unique_ptr<PrefFilter>(new Filter(this));
+}
+
+void PrefWriteMetrics::OnBeforeWrite(base::TimeTicks serialize_start) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::AutoLock auto_lock(lock_);
+  // JsonPrefStore has no hook between the end of the serialization on the UI
+  // thread and the post to the file task runner, so the two are measured
+  // together.
+  total_serialize_and_queue_time_ += now - serialize_start;
+  pending_write_start_ = now;
+}
+
+void PrefWriteMetrics::OnAfterWrite(bool success) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  int64_t file_size = 0;
+  if (success && !base::GetFileSize(path_, &file_size))
+    file_size = 0;
+
+  base::AutoLock auto_lock(lock_);
+  base::TimeDelta write_time = now - pending_write_start_;
+  if (!success) {
+    failed_write_count_++;
+    return;
+  }
+
+  write_count_++;
+  bytes_written_ += file_size;
+  last_file_size_ = file_size;
+  total_write_time_ += write_time;
+  if (write_time > max_write_time_)
+    max_write_time_ = write_time;
+}
+
+std::unique_ptr<base::DictionaryValue> PrefWriteMetrics::ToValue() const {
+  std::unique_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+  value->SetString("path", path_.AsUTF8Unsafe());
+
+  base::AutoLock auto_lock(lock_);
+  value->SetInteger("writeCount", write_count_);
+  value->SetInteger("failedWriteCount", failed_write_count_);
+  value->SetDouble("bytesWritten", static_cast<double>(bytes_written_));
+  value->SetDouble("fileSize", static_cast<double>(last_file_size_));
+  value->SetDouble("serializeAndQueueTime",
+                   total_serialize_and_queue_time_.InMillisecondsF());
+  value->SetDouble("writeTime", total_write_time_.InMillisecondsF());
+  value->SetDouble("maxWriteTime", max_write_time_.InMillisecondsF());
+  return value;
+}
+
+}  // namespace brave
@@ -0,0 +1,66 @@
+// Copyright 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_PREFS_PREF_WRITE_METRICS_H_
+#define BRAVE_BROWSER_PREFS_PREF_WRITE_METRICS_H_
+
+#include <memory>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "components/prefs/pref_filter.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace brave {
+
+// Write counters for a single JsonPrefStore file. The counters are updated
+// on the pref store's file task runner and read on the UI thread.
+class PrefWriteMetrics : public base::RefCountedThreadSafe<PrefWriteMetrics> {
+ public:
+  explicit PrefWriteMetrics(const base::FilePath& path);
+
+  // Returns a filter to hand to the JsonPrefStore for |path|.
+  std::unique_ptr<PrefFilter> CreateFilter();
+
+  std::unique_ptr<base::DictionaryValue> ToValue() const;
+
+  const base::FilePath& path() const { return path_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<PrefWriteMetrics>;
+  class Filter;
+
+  ~PrefWriteMetrics();
+
+  void OnBeforeWrite(base::TimeTicks serialize_start);
+  void OnAfterWrite(bool success);
+
+  const base::FilePath path_;
+
+  mutable base::Lock lock_;
+  int write_count_;
+  int failed_write_count_;
+  int64_t bytes_written_;
+  int64_t last_file_size_;
+  // From the start of the serialization until the write starts on the file
+  // task runner.
+  base::TimeDelta total_serialize_and_queue_time_;
+  base::TimeDelta total_write_time_;
+  base::TimeDelta max_write_time_;
+  // Writes for one file are sequenced on the store's file task runner so
+  // there is at most one write in flight.
+  base::TimeTicks pending_write_start_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrefWriteMetrics);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_PREFS_PREF_WRITE_METRICS_H_
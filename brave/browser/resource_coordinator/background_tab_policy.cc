@@ -0,0 +1,391 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/resource_coordinator/background_tab_policy.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "atom/browser/extensions/tab_helper.h"
+#include "atom/common/api/api_messages.h"
+#include "atom/common/options_switches.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/process/process.h"
+#include "base/process/process_metrics.h"
+#include "base/task_runner_util.h"
+#include "base/task_scheduler/post_task.h"
+#include "brave/browser/resource_coordinator/background_tab_policy_factory.h"
+#include "chrome/browser/media/webrtc/media_capture_devices_dispatcher.h"
+#include "chrome/browser/media/webrtc/media_stream_capture_indicator.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/render_widget_host.h"
+#include "content/public/browser/render_widget_host_iterator.h"
+#include "content/public/browser/render_widget_host_view.h"
+#include "content/public/browser/web_contents.h"
+
+#if defined(OS_MACOSX)
+#include "content/public/browser/browser_child_process_host.h"
+#endif
+
+using content::BrowserThread;
+using content::RenderProcessHost;
+
+namespace brave {
+
+namespace {
+
+const int kCheckIntervalSeconds = 10;
+
+bool IsCapturing(content::WebContents* contents) {
+  return MediaCaptureDevicesDispatcher::GetInstance()->
+      GetMediaStreamCaptureIndicator()->IsCapturingUserMedia(contents);
+}
+
+void SetProcessBackgrounded(base::Process process) {
+  if (process.IsValid())
+    process.SetProcessBackgrounded(true);
+}
+
+}  // namespace
+
+// Measures the CPU usage of renderers between the time they are found hidden
+// and the time they are frozen.
+class BackgroundTabPolicy::CpuMonitor {
+ public:
+  CpuMonitor() {}
+  ~CpuMonitor() {}
+
+  void Start(int render_process_id, base::ProcessHandle handle) {
+#if defined(OS_MACOSX)
+    auto metrics = base::ProcessMetrics::CreateProcessMetrics(
+        handle, content::BrowserChildProcessHost::GetPortProvider());
+#else
+    auto metrics = base::ProcessMetrics::CreateProcessMetrics(handle);
+#endif
+    // The first call only sets the starting point.
+    metrics->GetPlatformIndependentCPUUsage();
+    metrics_[render_process_id] = std::move(metrics);
+  }
+
+  // Returns the percent of one core used since Start().
+  double Stop(int render_process_id) {
+    auto it = metrics_.find(render_process_id);
+    if (it == metrics_.end())
+      return 0;
+
+    double cpu_usage = it->second->GetPlatformIndependentCPUUsage();
+    metrics_.erase(it);
+    return cpu_usage;
+  }
+
+ private:
+  std::map<int, std::unique_ptr<base::ProcessMetrics>> metrics_;
+
+  DISALLOW_COPY_AND_ASSIGN(CpuMonitor);
+};
+
+BackgroundTabPolicy::Options::Options()
+    : enabled(false),
+      timer_throttling(TimerThrottling::ALIGNED),
+      lower_priority(false) {
+}
+
+BackgroundTabPolicy::Stats::Stats()
+    : freezes(0), thaws(0), frozen_processes(0) {
+}
+
+BackgroundTabPolicy::ProcessState::ProcessState()
+    : frozen(false), cpu_usage(0) {
+}
+
+// static
+BackgroundTabPolicy* BackgroundTabPolicy::FromBrowserContext(
+    content::BrowserContext* browser_context) {
+  return BackgroundTabPolicyFactory::GetForBrowserContext(browser_context);
+}
+
+// static
+bool BackgroundTabPolicy::TimerThrottlingFromString(
+    const std::string& value,
+    TimerThrottling* throttling) {
+  if (value == "none")
+    *throttling = TimerThrottling::NONE;
+  else if (value == "aligned")
+    *throttling = TimerThrottling::ALIGNED;
+  else if (value == "budget")
+    *throttling = TimerThrottling::BUDGET;
+  else
+    return false;
+  return true;
+}
+
+// static
+const char* BackgroundTabPolicy::TimerThrottlingToString(
+    TimerThrottling throttling) {
+  switch (throttling) {
+    case TimerThrottling::NONE:
+      return "none";
+    case TimerThrottling::ALIGNED:
+      return "aligned";
+    case TimerThrottling::BUDGET:
+      return "budget";
+  }
+  NOTREACHED();
+  return "aligned";
+}
+
+BackgroundTabPolicy::BackgroundTabPolicy(
+    content::BrowserContext* browser_context)
+    : browser_context_(browser_context),
+      task_runner_(base::CreateSequencedTaskRunnerWithTraits(
+          {base::MayBlock(), base::TaskPriority::BACKGROUND,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      cpu_monitor_(new CpuMonitor, base::OnTaskRunnerDeleter(task_runner_)),
+      weak_factory_(this) {
+}
+
+BackgroundTabPolicy::~BackgroundTabPolicy() {
+  DCHECK(processes_.empty());
+}
+
+void BackgroundTabPolicy::SetOptions(const Options& options) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  options_ = options;
+  if (!options_.enabled || options_.freeze_after.is_zero())
+    ThawAll();
+  UpdateTimer();
+}
+
+BackgroundTabPolicy::Stats BackgroundTabPolicy::GetStats() const {
+  Stats stats = stats_;
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (const auto& entry : processes_) {
+    const ProcessState& state = entry.second;
+    if (!state.frozen)
+      continue;
+
+    base::TimeDelta frozen_time = now - state.frozen_since;
+    stats.frozen_processes++;
+    stats.frozen_time += frozen_time;
+    stats.cpu_time_saved += base::TimeDelta::FromMicrosecondsD(
+        frozen_time.InMicrosecondsF() * state.cpu_usage / 100);
+  }
+  return stats;
+}
+
+void BackgroundTabPolicy::AppendRendererSwitches(
+    base::CommandLine* command_line) const {
+  if (!options_.enabled)
+    return;
+
+  command_line->AppendSwitchASCII(
+      atom::switches::kBackgroundTimerThrottling,
+      TimerThrottlingToString(options_.timer_throttling));
+}
+
+void BackgroundTabPolicy::TabWasShown(int32_t tab_id,
+                                      content::WebContents* contents) {
+  hidden_tabs_.erase(tab_id);
+
+  std::set<RenderProcessHost*> hosts;
+  for (content::RenderFrameHost* frame : contents->GetAllFrames())
+    hosts.insert(frame->GetProcess());
+  for (RenderProcessHost* host : hosts)
+    StopTracking(host, true);
+}
+
+void BackgroundTabPolicy::TabWasHidden(int32_t tab_id) {
+  hidden_tabs_.insert(std::make_pair(tab_id, base::TimeTicks::Now()));
+}
+
+void BackgroundTabPolicy::TabFrameCreated(
+    int32_t tab_id,
+    content::RenderFrameHost* render_frame_host) {
+  // Tabs created in the background are never hidden, so they start out
+  // hidden when the view of their page is not showing. The view of a tab
+  // that is shown later gets TabWasShown.
+  if (!render_frame_host->GetParent()) {
+    content::RenderWidgetHostView* view = render_frame_host->GetView();
+    if (view && !view->IsShowing())
+      hidden_tabs_.insert(std::make_pair(tab_id, base::TimeTicks::Now()));
+  }
+
+  // A visible page must not end up in a frozen renderer.
+  if (hidden_tabs_.find(tab_id) == hidden_tabs_.end())
+    StopTracking(render_frame_host->GetProcess(), true);
+}
+
+void BackgroundTabPolicy::TabDestroyed(int32_t tab_id) {
+  hidden_tabs_.erase(tab_id);
+}
+
+void BackgroundTabPolicy::Shutdown() {
+  check_timer_.Stop();
+  ThawAll();
+}
+
+void BackgroundTabPolicy::RenderProcessExited(RenderProcessHost* host,
+                                              base::TerminationStatus status,
+                                              int exit_code) {
+  StopTracking(host, false);
+}
+
+void BackgroundTabPolicy::RenderProcessHostDestroyed(RenderProcessHost* host) {
+  StopTracking(host, false);
+}
+
+void BackgroundTabPolicy::UpdateTimer() {
+  if (!options_.enabled || options_.freeze_after.is_zero()) {
+    check_timer_.Stop();
+    return;
+  }
+
+  if (!check_timer_.IsRunning()) {
+    check_timer_.Start(FROM_HERE,
+                       base::TimeDelta::FromSeconds(kCheckIntervalSeconds),
+                       base::Bind(&BackgroundTabPolicy::CheckProcesses,
+                                  base::Unretained(this)));
+  }
+}
+
+void BackgroundTabPolicy::CheckProcesses() {
+  // When all the tabs of each renderer were hidden. A renderer that also
+  // hosts a visible, audible or capturing tab, or anything that is not a tab,
+  // is left out.
+  std::map<int, base::TimeTicks> hidden_since;
+  std::set<int> busy;
+  std::unique_ptr<content::RenderWidgetHostIterator> widgets(
+      content::RenderWidgetHost::GetRenderWidgetHosts());
+  while (content::RenderWidgetHost* widget = widgets->GetNextHost()) {
+    RenderProcessHost* host = widget->GetProcess();
+    if (host->GetBrowserContext() != browser_context_)
+      continue;
+
+    // Every renderer that hosts frames of a page has a view of it.
+    content::RenderViewHost* view = content::RenderViewHost::From(widget);
+    if (!view)
+      continue;
+
+    int id = host->GetID();
+    content::WebContents* contents =
+        content::WebContents::FromRenderViewHost(view);
+    auto tab = hidden_tabs_.find(extensions::TabHelper::IdForTab(contents));
+    if (tab == hidden_tabs_.end() || contents->WasRecentlyAudible() ||
+        IsCapturing(contents)) {
+      busy.insert(id);
+      continue;
+    }
+    hidden_since[id] = std::max(hidden_since[id], tab->second);
+  }
+  for (int id : busy)
+    hidden_since.erase(id);
+
+  std::vector<int> released;
+  for (const auto& entry : processes_) {
+    if (hidden_since.find(entry.first) == hidden_since.end())
+      released.push_back(entry.first);
+  }
+  for (int id : released)
+    StopTracking(RenderProcessHost::FromID(id), true);
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (const auto& entry : hidden_since) {
+    RenderProcessHost* host = RenderProcessHost::FromID(entry.first);
+    if (!host || !host->IsReady())
+      continue;
+
+    auto it = processes_.find(entry.first);
+    if (it == processes_.end()) {
+      processes_[entry.first] = ProcessState();
+      host->AddObserver(this);
+      task_runner_->PostTask(FROM_HERE,
+          base::Bind(&CpuMonitor::Start,
+                     base::Unretained(cpu_monitor_.get()),
+                     entry.first, host->GetHandle()));
+    } else if (!it->second.frozen &&
+               now - entry.second >= options_.freeze_after) {
+      Freeze(host);
+    }
+  }
+}
+
+void BackgroundTabPolicy::Freeze(RenderProcessHost* host) {
+  ProcessState& state = processes_[host->GetID()];
+  state.frozen = true;
+  state.frozen_since = base::TimeTicks::Now();
+  stats_.freezes++;
+
+  host->Send(new AtomMsg_SetTimersSuspended(true));
+
+  base::PostTaskAndReplyWithResult(task_runner_.get(), FROM_HERE,
+      base::Bind(&CpuMonitor::Stop,
+                 base::Unretained(cpu_monitor_.get()), host->GetID()),
+      base::Bind(&BackgroundTabPolicy::OnCpuUsage,
+                 weak_factory_.GetWeakPtr(), host->GetID()));
+
+#if !defined(OS_MACOSX)
+  // Content raises the priority again when one of the tabs is shown.
+  if (options_.lower_priority && base::Process::CanBackgroundProcesses()) {
+    base::Process process =
+        base::Process::DeprecatedGetProcessFromHandle(host->GetHandle());
+    BrowserThread::PostTask(BrowserThread::PROCESS_LAUNCHER, FROM_HERE,
+        base::Bind(&SetProcessBackgrounded, base::Passed(&process)));
+  }
+#endif
+}
+
+void BackgroundTabPolicy::StopTracking(RenderProcessHost* host, bool resume) {
+  if (!host)
+    return;
+
+  auto it = processes_.find(host->GetID());
+  if (it == processes_.end())
+    return;
+
+  const ProcessState& state = it->second;
+  if (state.frozen) {
+    base::TimeDelta frozen_time = base::TimeTicks::Now() - state.frozen_since;
+    stats_.thaws++;
+    stats_.frozen_time += frozen_time;
+    stats_.cpu_time_saved += base::TimeDelta::FromMicrosecondsD(
+        frozen_time.InMicrosecondsF() * state.cpu_usage / 100);
+    if (resume)
+      host->Send(new AtomMsg_SetTimersSuspended(false));
+  } else {
+    task_runner_->PostTask(FROM_HERE,
+        base::Bind(base::IgnoreResult(&CpuMonitor::Stop),
+                   base::Unretained(cpu_monitor_.get()), host->GetID()));
+  }
+
+  host->RemoveObserver(this);
+  processes_.erase(it);
+}
+
+void BackgroundTabPolicy::ThawAll() {
+  std::vector<int> ids;
+  for (const auto& entry : processes_)
+    ids.push_back(entry.first);
+  for (int id : ids) {
+    RenderProcessHost* host = RenderProcessHost::FromID(id);
+    if (host)
+      StopTracking(host, true);
+    else
+      processes_.erase(id);
+  }
+}
+
+void BackgroundTabPolicy::OnCpuUsage(int render_process_id,
+                                     double cpu_usage) {
+  auto it = processes_.find(render_process_id);
+  if (it != processes_.end() && it->second.frozen)
+    it->second.cpu_usage = cpu_usage;
+}
+
+}  // namespace brave
@@ -0,0 +1,156 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_RESOURCE_COORDINATOR_BACKGROUND_TAB_POLICY_H_
+#define BRAVE_BROWSER_RESOURCE_COORDINATOR_BACKGROUND_TAB_POLICY_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "content/public/browser/render_process_host_observer.h"
+
+namespace base {
+class CommandLine;
+}
+
+namespace content {
+class BrowserContext;
+class RenderFrameHost;
+class RenderProcessHost;
+class WebContents;
+}
+
+namespace brave {
+
+// Limits the work done by the hidden tabs of a browser context. Renderers are
+// launched with the configured timer throttling for hidden pages, and a
+// renderer whose tabs have all been hidden for |freeze_after| gets its timers
+// suspended until one of them is shown again. Tabs that play audio or capture
+// media keep their renderer running. TabHelper reports the visibility of the
+// tabs.
+class BackgroundTabPolicy : public KeyedService,
+                            public content::RenderProcessHostObserver {
+ public:
+  enum class TimerThrottling {
+    NONE,
+    // Timers of hidden pages run at most once a second.
+    ALIGNED,
+    // Also limits the CPU time of the timers of hidden pages.
+    BUDGET,
+  };
+
+  struct Options {
+    Options();
+
+    bool enabled;
+    TimerThrottling timer_throttling;
+    // Zero never freezes.
+    base::TimeDelta freeze_after;
+    // Runs frozen renderers at background priority.
+    bool lower_priority;
+  };
+
+  struct Stats {
+    Stats();
+
+    uint64_t freezes;
+    uint64_t thaws;
+    size_t frozen_processes;
+    base::TimeDelta frozen_time;
+    // CPU time the frozen renderers would have used at the rate they had
+    // while hidden before being frozen.
+    base::TimeDelta cpu_time_saved;
+  };
+
+  static BackgroundTabPolicy* FromBrowserContext(
+      content::BrowserContext* browser_context);
+
+  static bool TimerThrottlingFromString(const std::string& value,
+                                        TimerThrottling* throttling);
+  static const char* TimerThrottlingToString(TimerThrottling throttling);
+
+  explicit BackgroundTabPolicy(content::BrowserContext* browser_context);
+  ~BackgroundTabPolicy() override;
+
+  // The timer throttling only applies to renderers launched afterwards.
+  void SetOptions(const Options& options);
+  const Options& options() const { return options_; }
+
+  Stats GetStats() const;
+
+  // Adds the timer throttling switch for a renderer of the browser context.
+  void AppendRendererSwitches(base::CommandLine* command_line) const;
+
+  // Called by TabHelper. A tab is hidden from TabWasHidden, or from the
+  // creation of its main frame if its view is not showing then, until
+  // TabWasShown.
+  void TabWasShown(int32_t tab_id, content::WebContents* contents);
+  void TabWasHidden(int32_t tab_id);
+  void TabFrameCreated(int32_t tab_id,
+                       content::RenderFrameHost* render_frame_host);
+  void TabDestroyed(int32_t tab_id);
+
+  // KeyedService:
+  void Shutdown() override;
+
+  // content::RenderProcessHostObserver:
+  void RenderProcessExited(content::RenderProcessHost* host,
+                           base::TerminationStatus status,
+                           int exit_code) override;
+  void RenderProcessHostDestroyed(content::RenderProcessHost* host) override;
+
+ private:
+  class CpuMonitor;
+
+  struct ProcessState {
+    ProcessState();
+
+    bool frozen;
+    base::TimeTicks frozen_since;
+    // Percent of one core used while hidden, before the process was frozen.
+    double cpu_usage;
+  };
+
+  void UpdateTimer();
+  void CheckProcesses();
+  void Freeze(content::RenderProcessHost* host);
+  // Thaws the renderer if it is frozen, and resumes its timers unless
+  // |resume| is false because it has gone away.
+  void StopTracking(content::RenderProcessHost* host, bool resume);
+  void ThawAll();
+  void OnCpuUsage(int render_process_id, double cpu_usage);
+
+  content::BrowserContext* browser_context_;  // not owned
+  Options options_;
+
+  // When each hidden tab was hidden.
+  std::map<int32_t, base::TimeTicks> hidden_tabs_;
+  // Renderers that are measured or frozen, by child process id.
+  std::map<int, ProcessState> processes_;
+
+  base::RepeatingTimer check_timer_;
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  // Lives on |task_runner_|.
+  std::unique_ptr<CpuMonitor, base::OnTaskRunnerDeleter> cpu_monitor_;
+
+  Stats stats_;
+
+  base::WeakPtrFactory<BackgroundTabPolicy> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundTabPolicy);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_RESOURCE_COORDINATOR_BACKGROUND_TAB_POLICY_H_
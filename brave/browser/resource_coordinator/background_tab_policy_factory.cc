@@ -0,0 +1,44 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/resource_coordinator/background_tab_policy_factory.h"
+
+#include "base/memory/singleton.h"
+#include "brave/browser/resource_coordinator/background_tab_policy.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+
+namespace brave {
+
+// static
+BackgroundTabPolicy* BackgroundTabPolicyFactory::GetForBrowserContext(
+    content::BrowserContext* context) {
+  return static_cast<BackgroundTabPolicy*>(
+      GetInstance()->GetServiceForBrowserContext(context, true));
+}
+
+// static
+BackgroundTabPolicyFactory* BackgroundTabPolicyFactory::GetInstance() {
+  return base::Singleton<BackgroundTabPolicyFactory>::get();
+}
+
+BackgroundTabPolicyFactory::BackgroundTabPolicyFactory()
+    : BrowserContextKeyedServiceFactory(
+        "BackgroundTabPolicy",
+        BrowserContextDependencyManager::GetInstance()) {
+}
+
+BackgroundTabPolicyFactory::~BackgroundTabPolicyFactory() {
+}
+
+KeyedService* BackgroundTabPolicyFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new BackgroundTabPolicy(context);
+}
+
+content::BrowserContext* BackgroundTabPolicyFactory::GetBrowserContextToUse(
+    content::BrowserContext* context) const {
+  return context;
+}
+
+}  // namespace brave
@@ -0,0 +1,45 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_RESOURCE_COORDINATOR_BACKGROUND_TAB_POLICY_FACTORY_H_
+#define BRAVE_BROWSER_RESOURCE_COORDINATOR_BACKGROUND_TAB_POLICY_FACTORY_H_
+
+#include "base/macros.h"
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+
+namespace base {
+template <typename T> struct DefaultSingletonTraits;
+}
+
+namespace brave {
+
+class BackgroundTabPolicy;
+
+// Owns a BackgroundTabPolicy for each browser context, including partitions
+// and off the record contexts, which have renderers of their own.
+class BackgroundTabPolicyFactory : public BrowserContextKeyedServiceFactory {
+ public:
+  static BackgroundTabPolicy* GetForBrowserContext(
+      content::BrowserContext* context);
+
+  static BackgroundTabPolicyFactory* GetInstance();
+
+ private:
+  friend struct base::DefaultSingletonTraits<BackgroundTabPolicyFactory>;
+
+  BackgroundTabPolicyFactory();
+  ~BackgroundTabPolicyFactory() override;
+
+  // BrowserContextKeyedServiceFactory:
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  content::BrowserContext* GetBrowserContextToUse(
+      content::BrowserContext* context) const override;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundTabPolicyFactory);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_RESOURCE_COORDINATOR_BACKGROUND_TAB_POLICY_FACTORY_H_
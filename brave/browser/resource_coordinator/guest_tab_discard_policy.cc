@@ -0,0 +1,360 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/resource_coordinator/guest_tab_discard_policy.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/metrics/histogram_macros.h"
+#include "base/process/process_metrics.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/values.h"
+#include "chrome/browser/resource_coordinator/discard_reason.h"
+#include "chrome/browser/resource_coordinator/tab_manager.h"
+#include "chrome/browser/resource_coordinator/tab_stats.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/browser/web_contents_observer.h"
+
+#if defined(OS_MACOSX)
+#include "content/public/browser/browser_child_process_host.h"
+#endif
+
+using content::BrowserThread;
+
+namespace resource_coordinator {
+
+namespace {
+
+const int kDefaultMinInactiveTimeMinutes = 10;
+const int kDefaultCheckIntervalSeconds = 60;
+const int kDefaultMaxDiscardsOnPressure = 3;
+
+// Returns the private memory in KB of each process, by child process id.
+std::unique_ptr<std::map<int, uint64_t>> MeasurePrivateMemory(
+    const std::map<int, base::ProcessHandle>& processes) {
+  std::unique_ptr<std::map<int, uint64_t>> private_kb(
+      new std::map<int, uint64_t>);
+  for (const auto& process : processes) {
+#if defined(OS_MACOSX)
+    std::unique_ptr<base::ProcessMetrics> metrics(
+        base::ProcessMetrics::CreateProcessMetrics(
+            process.second,
+            content::BrowserChildProcessHost::GetPortProvider()));
+#else
+    std::unique_ptr<base::ProcessMetrics> metrics(
+        base::ProcessMetrics::CreateProcessMetrics(process.second));
+#endif
+    base::WorkingSetKBytes working_set;
+    if (metrics->GetWorkingSetKBytes(&working_set))
+      (*private_kb)[process.first] = working_set.priv;
+  }
+  return private_kb;
+}
+
+struct Candidate {
+  int64_t tab_contents_id;
+  uint64_t reclaim_kb;
+  double score;
+};
+
+}  // namespace
+
+// Measures how long a discarded tab takes to load again once it is shown.
+class GuestTabDiscardPolicy::ReloadObserver
+    : public content::WebContentsObserver {
+ public:
+  ReloadObserver(GuestTabDiscardPolicy* policy,
+                 content::WebContents* contents)
+      : content::WebContentsObserver(contents),
+        policy_(policy),
+        start_time_(base::TimeTicks::Now()) {}
+
+  // content::WebContentsObserver:
+  void DidStopLoading() override {
+    // Deletes |this|.
+    policy_->OnReloadFinished(web_contents(),
+                              base::TimeTicks::Now() - start_time_, true);
+  }
+
+  void WebContentsDestroyed() override {
+    // Deletes |this|.
+    policy_->OnReloadFinished(web_contents(), base::TimeDelta(), false);
+  }
+
+ private:
+  GuestTabDiscardPolicy* policy_;
+  base::TimeTicks start_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReloadObserver);
+};
+
+GuestTabDiscardPolicy::GuestTabDiscardPolicy(TabManager* tab_manager)
+    : tab_manager_(tab_manager),
+      enabled_(true),
+      memory_budget_kb_(0),
+      min_inactive_time_(
+          base::TimeDelta::FromMinutes(kDefaultMinInactiveTimeMinutes)),
+      check_interval_(
+          base::TimeDelta::FromSeconds(kDefaultCheckIntervalSeconds)),
+      max_discards_on_pressure_(kDefaultMaxDiscardsOnPressure),
+      measuring_(false),
+      has_pending_trigger_(false),
+      pending_trigger_(Trigger::kBudget),
+      discards_(0),
+      urgent_discards_(0),
+      failed_discards_(0),
+      reclaimed_kb_(0),
+      last_measured_kb_(0),
+      reloads_(0),
+      aborted_reloads_(0),
+      memory_consumer_id_(0),
+      weak_factory_(this) {
+  memory_consumer_id_ =
+      atom::MemoryCoordinator::GetInstance()->RegisterConsumer(
+          "background-tabs", atom::MemoryCoordinator::PRIORITY_TABS,
+          base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE,
+          base::Bind(&GuestTabDiscardPolicy::ReclaimMemory,
+                     base::Unretained(this)));
+}
+
+GuestTabDiscardPolicy::~GuestTabDiscardPolicy() {
+  atom::MemoryCoordinator::GetInstance()->UnregisterConsumer(
+      memory_consumer_id_);
+  RunPendingReclaims();
+}
+
+void GuestTabDiscardPolicy::SetOptions(const base::DictionaryValue& options) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  options.GetBoolean("enabled", &enabled_);
+
+  double memory_budget_mb;
+  if (options.GetDouble("memoryBudget", &memory_budget_mb))
+    memory_budget_kb_ =
+        static_cast<uint64_t>(std::max(memory_budget_mb, 0.0) * 1024);
+
+  int min_inactive_time;
+  if (options.GetInteger("minInactiveTime", &min_inactive_time))
+    min_inactive_time_ =
+        base::TimeDelta::FromSeconds(std::max(min_inactive_time, 0));
+
+  int check_interval;
+  if (options.GetInteger("checkInterval", &check_interval))
+    check_interval_ = base::TimeDelta::FromSeconds(std::max(check_interval, 1));
+
+  int max_discards;
+  if (options.GetInteger("maxDiscardsOnPressure", &max_discards))
+    max_discards_on_pressure_ = std::max(max_discards, 0);
+
+  UpdateCheckTimer();
+}
+
+std::unique_ptr<base::DictionaryValue> GuestTabDiscardPolicy::GetStats() const {
+  std::unique_ptr<base::DictionaryValue> stats(new base::DictionaryValue);
+  stats->SetInteger("discards", discards_);
+  stats->SetInteger("urgentDiscards", urgent_discards_);
+  stats->SetInteger("failedDiscards", failed_discards_);
+  stats->SetDouble("reclaimedMemory", reclaimed_kb_);
+  stats->SetDouble("lastMeasuredMemory", last_measured_kb_);
+  stats->SetInteger("reloads", reloads_);
+  stats->SetInteger("abortedReloads", aborted_reloads_);
+  stats->SetDouble("totalReloadTime", total_reload_time_.InMillisecondsF());
+  return stats;
+}
+
+void GuestTabDiscardPolicy::OnDiscardedTabReloading(
+    content::WebContents* contents) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  reload_observers_[contents].reset(new ReloadObserver(this, contents));
+}
+
+void GuestTabDiscardPolicy::ReclaimMemory(
+    atom::MemoryCoordinator::Level level,
+    const atom::MemoryCoordinator::DoneCallback& done) {
+  pending_reclaims_.push_back(std::make_pair(done, reclaimed_kb_));
+  switch (level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      MaybeDiscard(Trigger::kModeratePressure);
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      MaybeDiscard(Trigger::kCriticalPressure);
+      break;
+    default:
+      break;
+  }
+  // Nothing to measure, or the policy is disabled.
+  if (!measuring_)
+    RunPendingReclaims();
+}
+
+void GuestTabDiscardPolicy::RunPendingReclaims() {
+  std::vector<std::pair<atom::MemoryCoordinator::DoneCallback, uint64_t>>
+      pending;
+  pending.swap(pending_reclaims_);
+  for (const auto& reclaim : pending)
+    reclaim.first.Run((reclaimed_kb_ - reclaim.second) * 1024);
+}
+
+void GuestTabDiscardPolicy::OnCheckTimer() {
+  MaybeDiscard(Trigger::kBudget);
+}
+
+void GuestTabDiscardPolicy::UpdateCheckTimer() {
+  if (enabled_ && memory_budget_kb_ > 0) {
+    check_timer_.Start(FROM_HERE, check_interval_,
+        base::Bind(&GuestTabDiscardPolicy::OnCheckTimer,
+                   base::Unretained(this)));
+  } else {
+    check_timer_.Stop();
+  }
+}
+
+void GuestTabDiscardPolicy::MaybeDiscard(Trigger trigger) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  if (!enabled_)
+    return;
+
+  if (measuring_) {
+    if (!has_pending_trigger_ || trigger > pending_trigger_)
+      pending_trigger_ = trigger;
+    has_pending_trigger_ = true;
+    return;
+  }
+
+  std::map<int, base::ProcessHandle> processes;
+  for (const auto& tab : tab_manager_->GetTabStats()) {
+    if (!tab.is_discarded && tab.renderer_handle != base::kNullProcessHandle)
+      processes[tab.child_process_host_id] = tab.renderer_handle;
+  }
+  if (processes.empty())
+    return;
+
+  measuring_ = true;
+  pending_trigger_ = trigger;
+  has_pending_trigger_ = true;
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::Bind(&MeasurePrivateMemory, processes),
+      base::Bind(&GuestTabDiscardPolicy::OnMemoryMeasured,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void GuestTabDiscardPolicy::OnMemoryMeasured(
+    std::unique_ptr<std::map<int, uint64_t>> private_kb) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  const Trigger trigger = pending_trigger_;
+  measuring_ = false;
+  has_pending_trigger_ = false;
+
+  // The tab list is read again since tabs may have changed during the
+  // measurement.
+  const TabStatsList tabs = tab_manager_->GetTabStats();
+
+  std::map<int, int> tabs_per_process;
+  for (const auto& tab : tabs) {
+    if (!tab.is_discarded)
+      tabs_per_process[tab.child_process_host_id]++;
+  }
+
+  uint64_t total_kb = 0;
+  for (const auto& process : *private_kb) {
+    if (tabs_per_process.count(process.first))
+      total_kb += process.second;
+  }
+  last_measured_kb_ = total_kb;
+  UMA_HISTOGRAM_MEMORY_LARGE_MB("Tabs.GuestDiscardPolicy.RendererMemory",
+                                total_kb / 1024);
+
+  const bool critical = trigger == Trigger::kCriticalPressure;
+  const base::TimeTicks now = base::TimeTicks::Now();
+  std::vector<Candidate> candidates;
+  for (const auto& tab : tabs) {
+    if (tab.is_discarded || tab.is_active || tab.is_in_visible_window ||
+        tab.is_pinned || tab.is_media || tab.has_form_entry ||
+        !tab.is_auto_discardable)
+      continue;
+    const base::TimeDelta inactive_time = now - tab.last_active;
+    // Under critical pressure recently used tabs are fair game too.
+    if (!critical && inactive_time < min_inactive_time_)
+      continue;
+
+    // A process shared by several tabs only goes away with the last of them,
+    // so split its memory between them.
+    uint64_t reclaim_kb = 0;
+    auto it = private_kb->find(tab.child_process_host_id);
+    if (it != private_kb->end())
+      reclaim_kb = it->second / std::max(
+          tabs_per_process[tab.child_process_host_id], 1);
+
+    Candidate candidate;
+    candidate.tab_contents_id = tab.tab_contents_id;
+    candidate.reclaim_kb = reclaim_kb;
+    candidate.score = std::max(inactive_time.InSecondsF(), 1.0) *
+        (1.0 + reclaim_kb / 1024.0);
+    candidates.push_back(candidate);
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              return a.score > b.score;
+            });
+
+  int pressure_discards = 0;
+  switch (trigger) {
+    case Trigger::kModeratePressure:
+      pressure_discards = 1;
+      break;
+    case Trigger::kCriticalPressure:
+      pressure_discards = max_discards_on_pressure_;
+      break;
+    case Trigger::kBudget:
+      break;
+  }
+
+  const DiscardReason reason = trigger == Trigger::kBudget ?
+      DiscardReason::kProactive : DiscardReason::kUrgent;
+  for (const auto& candidate : candidates) {
+    const bool over_budget =
+        memory_budget_kb_ > 0 && total_kb > memory_budget_kb_;
+    if (!over_budget && pressure_discards <= 0)
+      break;
+
+    if (!tab_manager_->DiscardTabById(candidate.tab_contents_id, reason)) {
+      failed_discards_++;
+      continue;
+    }
+
+    discards_++;
+    if (reason == DiscardReason::kUrgent)
+      urgent_discards_++;
+    reclaimed_kb_ += candidate.reclaim_kb;
+    total_kb -= std::min(total_kb, candidate.reclaim_kb);
+    pressure_discards--;
+    UMA_HISTOGRAM_MEMORY_KB("Tabs.GuestDiscardPolicy.ReclaimedMemory",
+                            candidate.reclaim_kb);
+  }
+
+  RunPendingReclaims();
+}
+
+void GuestTabDiscardPolicy::OnReloadFinished(content::WebContents* contents,
+                                             base::TimeDelta duration,
+                                             bool completed) {
+  if (completed) {
+    reloads_++;
+    total_reload_time_ += duration;
+    UMA_HISTOGRAM_MEDIUM_TIMES("Tabs.GuestDiscardPolicy.ReloadTime", duration);
+  } else {
+    aborted_reloads_++;
+  }
+  reload_observers_.erase(contents);
+}
+
+}  // namespace resource_coordinator
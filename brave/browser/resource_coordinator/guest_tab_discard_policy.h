@@ -0,0 +1,115 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_DISCARD_POLICY_H_
+#define BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_DISCARD_POLICY_H_
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "atom/browser/memory_coordinator.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace content {
+class WebContents;
+}
+
+namespace resource_coordinator {
+
+class TabManager;
+
+// Decides which guest tabs to discard without involving the embedder.
+// Tabs are ranked by how long they have been in the background and by the
+// private memory of their renderer, and pinned, audible, form editing and
+// visible tabs are never picked. Discarding happens when the renderers of all
+// tabs use more than the memory budget, or when the memory coordinator asks
+// for memory back.
+class GuestTabDiscardPolicy {
+ public:
+  explicit GuestTabDiscardPolicy(TabManager* tab_manager);
+  ~GuestTabDiscardPolicy();
+
+  // Updates the policy from |options|. Unknown keys are ignored.
+  void SetOptions(const base::DictionaryValue& options);
+  std::unique_ptr<base::DictionaryValue> GetStats() const;
+
+  // Called when a discarded tab is reloaded so the cost of the reload can be
+  // measured.
+  void OnDiscardedTabReloading(content::WebContents* contents);
+
+ private:
+  class ReloadObserver;
+
+  enum class Trigger {
+    kBudget,
+    kModeratePressure,
+    kCriticalPressure,
+  };
+
+  void ReclaimMemory(atom::MemoryCoordinator::Level level,
+                     const atom::MemoryCoordinator::DoneCallback& done);
+  // Reports what was discarded since each pending request was made.
+  void RunPendingReclaims();
+  void OnCheckTimer();
+  void UpdateCheckTimer();
+
+  // Measures renderer memory on a background sequence and discards from the
+  // reply. Triggers arriving during a measurement are merged into it.
+  void MaybeDiscard(Trigger trigger);
+  void OnMemoryMeasured(std::unique_ptr<std::map<int, uint64_t>> private_kb);
+
+  void OnReloadFinished(content::WebContents* contents,
+                        base::TimeDelta duration,
+                        bool completed);
+
+  TabManager* tab_manager_;  // Weak, owns us.
+
+  bool enabled_;
+  // Renderer private memory budget in KB, 0 for no budget.
+  uint64_t memory_budget_kb_;
+  base::TimeDelta min_inactive_time_;
+  base::TimeDelta check_interval_;
+  int max_discards_on_pressure_;
+
+  bool measuring_;
+  bool has_pending_trigger_;
+  Trigger pending_trigger_;
+
+  int discards_;
+  int urgent_discards_;
+  int failed_discards_;
+  uint64_t reclaimed_kb_;
+  uint64_t last_measured_kb_;
+  int reloads_;
+  int aborted_reloads_;
+  base::TimeDelta total_reload_time_;
+
+  std::map<content::WebContents*, std::unique_ptr<ReloadObserver>>
+      reload_observers_;
+
+  // Memory coordinator requests waiting for the current measurement, with
+  // |reclaimed_kb_| at the time of the request.
+  std::vector<std::pair<atom::MemoryCoordinator::DoneCallback, uint64_t>>
+      pending_reclaims_;
+  int memory_consumer_id_;
+
+  base::RepeatingTimer check_timer_;
+
+  base::WeakPtrFactory<GuestTabDiscardPolicy> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(GuestTabDiscardPolicy);
+};
+
+}  // namespace resource_coordinator
+
+#endif  // BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_DISCARD_POLICY_H_
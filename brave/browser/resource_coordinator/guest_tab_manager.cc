@@ -35,7 +35,12 @@ DEFINE_WEB_CONTENTS_USER_DATA_KEY(content::RestoreHelper);
 
 namespace resource_coordinator {
 
-GuestTabManager::GuestTabManager() : TabManager() {}
+GuestTabManager::GuestTabManager()
+    : TabManager(),
+      discard_policy_(new GuestTabDiscardPolicy(this)),
+      restore_loader_(new GuestTabRestoreLoader) {}
+
+GuestTabManager::~GuestTabManager() {}
 
 WebContents* GuestTabManager::CreateNullContents(
     TabStripModel* model, WebContents* old_contents) {
@@ -93,6 +98,7 @@ void GuestTabManager::ActiveTabChanged(content::WebContents* old_contents,
     if (!tab_helper->is_placeholder()) {
       // if the helper is set this is a discarded tab so we need to reload
       new_contents->GetController().Reload(content::ReloadType::NORMAL, true);
+      discard_policy_->OnDiscardedTabReloading(new_contents);
     }
   }
 }
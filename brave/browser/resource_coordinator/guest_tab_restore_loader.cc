@@ -0,0 +1,282 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/browser/resource_coordinator/guest_tab_restore_loader.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "atom/browser/extensions/tab_helper.h"
+#include "base/sys_info.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/browser/web_contents_observer.h"
+
+using content::BrowserThread;
+
+namespace resource_coordinator {
+
+namespace {
+
+const int kDefaultLoadTimeoutSeconds = 10;
+// Loads run at the reduced concurrency for this long after moderate pressure.
+const int kPressureBackoffSeconds = 30;
+const size_t kMaxTimings = 500;
+
+}  // namespace
+
+// Follows one restored tab from the queue until it finishes loading.
+class GuestTabRestoreLoader::TabObserver
+    : public content::WebContentsObserver {
+ public:
+  enum class State {
+    kQueued,
+    kLoading,
+  };
+
+  TabObserver(GuestTabRestoreLoader* loader,
+              content::WebContents* contents,
+              Priority priority)
+      : content::WebContentsObserver(contents),
+        loader_(loader),
+        priority_(priority),
+        state_(State::kQueued),
+        holds_slot_(false),
+        timed_out_(false),
+        added_time_(base::TimeTicks::Now()) {}
+
+  void StartLoading(base::TimeDelta timeout) {
+    state_ = State::kLoading;
+    holds_slot_ = true;
+    load_start_time_ = base::TimeTicks::Now();
+    timer_.Start(FROM_HERE, timeout,
+        base::Bind(&GuestTabRestoreLoader::OnTabLoadTimedOut,
+                   base::Unretained(loader_), base::Unretained(this)));
+  }
+
+  // Gives up the load slot while still waiting for the load to finish.
+  bool ReleaseSlot() {
+    timer_.Stop();
+    bool held = holds_slot_;
+    holds_slot_ = false;
+    return held;
+  }
+
+  void set_timed_out() { timed_out_ = true; }
+
+  Priority priority() const { return priority_; }
+  State state() const { return state_; }
+  bool timed_out() const { return timed_out_; }
+  base::TimeTicks added_time() const { return added_time_; }
+  base::TimeTicks load_start_time() const { return load_start_time_; }
+
+  // content::WebContentsObserver:
+  void DidStartLoading() override {
+    // The tab was activated before its turn came.
+    if (state_ == State::kQueued)
+      loader_->OnTabLoadStarted(this);
+  }
+
+  void DidStopLoading() override {
+    // Deletes |this|.
+    if (state_ == State::kLoading)
+      loader_->OnTabLoadFinished(this);
+  }
+
+  void WebContentsDestroyed() override {
+    // Deletes |this|.
+    loader_->OnTabDestroyed(this);
+  }
+
+ private:
+  GuestTabRestoreLoader* loader_;
+  Priority priority_;
+  State state_;
+  bool holds_slot_;
+  bool timed_out_;
+  base::TimeTicks added_time_;
+  base::TimeTicks load_start_time_;
+  base::OneShotTimer timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(TabObserver);
+};
+
+GuestTabRestoreLoader::GuestTabRestoreLoader()
+    : loading_count_(0),
+      max_concurrent_loads_(0),
+      load_timeout_(base::TimeDelta::FromSeconds(kDefaultLoadTimeoutSeconds)),
+      loaded_count_(0),
+      timed_out_count_(0),
+      deferred_count_(0),
+      timings_(new base::ListValue) {
+  // Leave a core for the browser and GPU processes, and allow one load per
+  // 2GB of memory.
+  const size_t by_cpu = std::max(base::SysInfo::NumberOfProcessors() / 2, 1);
+  const size_t by_memory = std::max(
+      base::SysInfo::AmountOfPhysicalMemoryMB() / 2048, 1);
+  default_max_concurrent_loads_ = std::min(by_cpu, by_memory);
+
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&GuestTabRestoreLoader::OnMemoryPressure,
+                 base::Unretained(this))));
+}
+
+GuestTabRestoreLoader::~GuestTabRestoreLoader() {}
+
+void GuestTabRestoreLoader::AddTab(content::WebContents* contents,
+                                   Priority priority) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  if (tabs_.count(contents))
+    return;
+
+  TabObserver* tab = new TabObserver(this, contents, priority);
+  tabs_[contents].reset(tab);
+
+  auto tab_helper = extensions::TabHelper::FromWebContents(contents);
+  if (tab_helper && tab_helper->IsDiscarded()) {
+    queues_[static_cast<int>(priority)].push_back(tab);
+  } else {
+    loading_count_++;
+    tab->StartLoading(load_timeout_);
+  }
+
+  LoadNextTabs();
+}
+
+void GuestTabRestoreLoader::SetOptions(const base::DictionaryValue& options) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  int max_concurrent_loads;
+  if (options.GetInteger("maxConcurrentLoads", &max_concurrent_loads))
+    max_concurrent_loads_ = std::max(max_concurrent_loads, 0);
+
+  int load_timeout;
+  if (options.GetInteger("loadTimeout", &load_timeout))
+    load_timeout_ = base::TimeDelta::FromMilliseconds(std::max(load_timeout, 0));
+
+  LoadNextTabs();
+}
+
+std::unique_ptr<base::DictionaryValue> GuestTabRestoreLoader::GetStats() const {
+  size_t queued = 0;
+  for (const auto& queue : queues_)
+    queued += queue.size();
+
+  std::unique_ptr<base::DictionaryValue> stats(new base::DictionaryValue);
+  stats->SetInteger("maxConcurrentLoads", GetMaxConcurrentLoads());
+  stats->SetInteger("queued", queued);
+  stats->SetInteger("loading", loading_count_);
+  stats->SetInteger("loaded", loaded_count_);
+  stats->SetInteger("timedOut", timed_out_count_);
+  stats->SetInteger("deferred", deferred_count_);
+  stats->Set("tabs", timings_->CreateDeepCopy());
+  return stats;
+}
+
+void GuestTabRestoreLoader::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  switch (level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      last_pressure_time_ = base::TimeTicks::Now();
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      // Stop restoring, the queued tabs stay discarded until activated.
+      last_pressure_time_ = base::TimeTicks::Now();
+      for (auto& queue : queues_) {
+        for (TabObserver* tab : queue) {
+          deferred_count_++;
+          tabs_.erase(tab->web_contents());
+        }
+        queue.clear();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void GuestTabRestoreLoader::LoadNextTabs() {
+  while (loading_count_ < GetMaxConcurrentLoads()) {
+    auto queue = std::find_if(std::begin(queues_), std::end(queues_),
+        [](const std::deque<TabObserver*>& queue) { return !queue.empty(); });
+    if (queue == std::end(queues_))
+      return;
+
+    TabObserver* tab = queue->front();
+    queue->pop_front();
+    loading_count_++;
+    tab->StartLoading(load_timeout_);
+
+    auto tab_helper =
+        extensions::TabHelper::FromWebContents(tab->web_contents());
+    if (!tab_helper || !tab_helper->LoadIfDiscarded())
+      OnTabLoadFinished(tab);
+  }
+}
+
+size_t GuestTabRestoreLoader::GetMaxConcurrentLoads() const {
+  if (!last_pressure_time_.is_null() &&
+      base::TimeTicks::Now() - last_pressure_time_ <
+          base::TimeDelta::FromSeconds(kPressureBackoffSeconds))
+    return 1;
+  return max_concurrent_loads_ ? max_concurrent_loads_
+                               : default_max_concurrent_loads_;
+}
+
+void GuestTabRestoreLoader::OnTabLoadStarted(TabObserver* tab) {
+  auto& queue = queues_[static_cast<int>(tab->priority())];
+  queue.erase(std::remove(queue.begin(), queue.end(), tab), queue.end());
+  loading_count_++;
+  tab->StartLoading(load_timeout_);
+}
+
+void GuestTabRestoreLoader::OnTabLoadTimedOut(TabObserver* tab) {
+  // Keep waiting for the load to finish so it can be timed, but let the next
+  // tab start.
+  if (tab->ReleaseSlot())
+    loading_count_--;
+  tab->set_timed_out();
+  timed_out_count_++;
+  LoadNextTabs();
+}
+
+void GuestTabRestoreLoader::OnTabLoadFinished(TabObserver* tab) {
+  if (tab->ReleaseSlot())
+    loading_count_--;
+  loaded_count_++;
+  RecordTiming(tab);
+  tabs_.erase(tab->web_contents());
+  LoadNextTabs();
+}
+
+void GuestTabRestoreLoader::OnTabDestroyed(TabObserver* tab) {
+  auto& queue = queues_[static_cast<int>(tab->priority())];
+  queue.erase(std::remove(queue.begin(), queue.end(), tab), queue.end());
+  if (tab->ReleaseSlot())
+    loading_count_--;
+  tabs_.erase(tab->web_contents());
+  LoadNextTabs();
+}
+
+void GuestTabRestoreLoader::RecordTiming(const TabObserver* tab) {
+  const base::TimeTicks now = base::TimeTicks::Now();
+  std::unique_ptr<base::DictionaryValue> timing(new base::DictionaryValue);
+  timing->SetInteger("tabId",
+      extensions::TabHelper::IdForTab(tab->web_contents()));
+  timing->SetInteger("priority", static_cast<int>(tab->priority()));
+  timing->SetDouble("queueTime",
+      (tab->load_start_time() - tab->added_time()).InMillisecondsF());
+  timing->SetDouble("loadTime",
+      (now - tab->load_start_time()).InMillisecondsF());
+  timing->SetBoolean("timedOut", tab->timed_out());
+
+  if (timings_->GetSize() >= kMaxTimings)
+    timings_->Remove(0, nullptr);
+  timings_->Append(std::move(timing));
+}
+
+}  // namespace resource_coordinator
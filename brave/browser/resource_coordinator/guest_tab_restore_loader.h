@@ -0,0 +1,90 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_RESTORE_LOADER_H_
+#define BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_RESTORE_LOADER_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/time/time.h"
+
+namespace base {
+class DictionaryValue;
+class ListValue;
+}
+
+namespace content {
+class WebContents;
+}
+
+namespace resource_coordinator {
+
+// Loads restored guest tabs a few at a time. Tabs are created as discarded
+// placeholders and handed to the loader, which reloads them in priority order
+// while keeping the number of concurrent loads bounded by the number of CPU
+// cores and the amount of physical memory. Tabs the user activates, including
+// a restored tab that is created active, load right away through the usual
+// discarded tab path and only hold a load slot.
+class GuestTabRestoreLoader {
+ public:
+  enum class Priority {
+    kVisibleWindow = 0,
+    kBackground,
+  };
+
+  GuestTabRestoreLoader();
+  ~GuestTabRestoreLoader();
+
+  // Starts tracking |contents|. Tabs that are not discarded are considered to
+  // be loading already.
+  void AddTab(content::WebContents* contents, Priority priority);
+
+  // Updates the loader from |options|. Unknown keys are ignored.
+  void SetOptions(const base::DictionaryValue& options);
+  std::unique_ptr<base::DictionaryValue> GetStats() const;
+
+ private:
+  class TabObserver;
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+  // Starts loading queued tabs until the concurrency limit is reached.
+  void LoadNextTabs();
+  size_t GetMaxConcurrentLoads() const;
+
+  void OnTabLoadStarted(TabObserver* tab);
+  void OnTabLoadTimedOut(TabObserver* tab);
+  void OnTabLoadFinished(TabObserver* tab);
+  void OnTabDestroyed(TabObserver* tab);
+  void RecordTiming(const TabObserver* tab);
+
+  // Tabs waiting to be loaded, one queue per priority.
+  std::deque<TabObserver*> queues_[2];
+  std::map<content::WebContents*, std::unique_ptr<TabObserver>> tabs_;
+  // Number of tabs holding a load slot.
+  size_t loading_count_;
+
+  size_t default_max_concurrent_loads_;
+  size_t max_concurrent_loads_;
+  base::TimeDelta load_timeout_;
+  base::TimeTicks last_pressure_time_;
+
+  int loaded_count_;
+  int timed_out_count_;
+  int deferred_count_;
+  std::unique_ptr<base::ListValue> timings_;
+
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  DISALLOW_COPY_AND_ASSIGN(GuestTabRestoreLoader);
+};
+
+}  // namespace resource_coordinator
+
+#endif  // BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_RESTORE_LOADER_H_
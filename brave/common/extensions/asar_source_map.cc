@@ -27,7 +27,8 @@ bool ReadFromPath(
     base::Callback<bool(const base::FilePath& path, std::string* contents)>,
     const base::FilePath& file,
     const base::FilePath& path,
-    std::string* source) {
+    std::string* source,
+    base::FilePath* source_path) {
   base::FilePath file_path = path.Append(file);
   if (!file_path.MatchesExtension(FILE_PATH_LITERAL(".js")))
     file_path = file_path.AddExtension(FILE_PATH_LITERAL("js"));
@@ -42,22 +43,29 @@ bool ReadFromPath(
       .Append(file)
       .AddExtension(FILE_PATH_LITERAL("js"));
 
-  return asar::ReadFileToString(file_path, source) ||
-      asar::ReadFileToString(module_path1, source) ||
-      asar::ReadFileToString(module_path2, source);
+  for (const base::FilePath& candidate :
+       {file_path, module_path1, module_path2}) {
+    if (asar::ReadFileToString(candidate, source)) {
+      if (source_path)
+        *source_path = candidate;
+      return true;
+    }
+  }
+  return false;
 }
 
 bool ReadFromSearchPaths(const std::vector<base::FilePath>& search_paths,
                         const base::FilePath& file_path,
-                        std::string* source) {
+                        std::string* source,
+                        base::FilePath* source_path) {
   for (size_t i = 0; i < search_paths.size(); ++i) {
     if (IsAsarPath(search_paths[i])) {
       if (!ReadFromPath(base::Bind(&asar::ReadFileToString),
-          file_path, search_paths[i], source))
+          file_path, search_paths[i], source, source_path))
         continue;
     } else {
       if (!ReadFromPath(base::Bind(&base::ReadFileToString),
-          file_path, search_paths[i], source))
+          file_path, search_paths[i], source, source_path))
         continue;
     }
     return true;
@@ -101,6 +109,10 @@ const base::FilePath GetFilePath(const std::string& name) {
 
 }  // namespace
 
+const char kModuleSystemArguments[] =
+    "define, requireNative, requireAsync, privates, $Array, $Function, $JSON, "
+    "$Object, $RegExp, $String, $Error";
+
 AsarSourceMap::AsarSourceMap(
     const std::vector<base::FilePath>& search_paths)
     : search_paths_(search_paths) {
@@ -112,20 +124,21 @@ AsarSourceMap::~AsarSourceMap() {
 v8::Local<v8::String> AsarSourceMap::GetSource(
     v8::Isolate* isolate,
     const std::string& name) const {
-  std::string source;
-  if (ReadFromSearchPaths(search_paths_, GetFilePath(name), &source)) {
-    if (name != commonjs) {
-      source =
-          "const fn = function (require, module, console) { " + source + " };"
-          "require('" +
-            commonjs +
-          "').require(fn, exports, '" +
-          GetFilePath(name).AsUTF8Unsafe() +
-          "', this);";
-    }
+  // Other modules are read and compiled by commonjs through ReadModule(), so
+  // their code can be cached.
+  if (name != commonjs) {
+    return gin::StringToV8(isolate,
+        "require('" +
+          std::string(commonjs) +
+        "').load(exports, '" +
+        GetFilePath(name).AsUTF8Unsafe() +
+        "', this, [" + kModuleSystemArguments + "]);");
+  }
 
+  std::string source;
+  if (ReadFromSearchPaths(search_paths_, GetFilePath(name), &source,
+                          nullptr))
     return gin::StringToV8(isolate, source);
-  }
 
   NOTREACHED() << "No module is registered with name \"" << name << "\"";
   return v8::Local<v8::String>();
@@ -133,7 +146,14 @@ v8::Local<v8::String> AsarSourceMap::GetSource(
 
 bool AsarSourceMap::Contains(const std::string& name) const {
   std::string source;
-  return ReadFromSearchPaths(search_paths_, GetFilePath(name), &source);
+  return ReadFromSearchPaths(search_paths_, GetFilePath(name), &source,
+                             nullptr);
+}
+
+bool AsarSourceMap::ReadModule(const std::string& name,
+                               std::string* source,
+                               base::FilePath* path) const {
+  return ReadFromSearchPaths(search_paths_, GetFilePath(name), source, path);
 }
 
 }  // namespace brave
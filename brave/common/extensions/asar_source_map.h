@@ -15,6 +15,10 @@
 
 namespace brave {
 
+// The names the extensions module system gives the modules it wraps, passed
+// on to the modules compiled by commonjs so they stay in scope there.
+extern const char kModuleSystemArguments[];
+
 class AsarSourceMap : public extensions::SourceMap {
  public:
   explicit AsarSourceMap(const std::vector<base::FilePath>& search_paths);
@@ -24,6 +28,11 @@ class AsarSourceMap : public extensions::SourceMap {
                                  const std::string& name) const override;
   bool Contains(const std::string& name) const override;
 
+  // Reads the source of module |name| and the path of the file it is in.
+  bool ReadModule(const std::string& name,
+                  std::string* source,
+                  base::FilePath* path) const;
+
  private:
   std::vector<base::FilePath> search_paths_;
 
@@ -0,0 +1,65 @@
+// Copyright (c) 2018 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/extensions/code_cache_bindings.h"
+
+#include <string>
+
+#include "atom/common/code_cache.h"
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "brave/common/extensions/asar_source_map.h"
+#include "extensions/renderer/script_context.h"
+#include "gin/converter.h"
+
+namespace brave {
+
+CodeCacheBindings::CodeCacheBindings(
+        extensions::ScriptContext* context,
+        const AsarSourceMap* source_map)
+    : extensions::ObjectBackedNativeHandler(context),
+      source_map_(source_map) {
+  RouteFunction("compileModule",
+              base::Bind(&CodeCacheBindings::CompileModule,
+                         base::Unretained(this)));
+}
+
+CodeCacheBindings::~CodeCacheBindings() {
+}
+
+void CodeCacheBindings::CompileModule(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  if (args.Length() != 1 || !args[0]->IsString()) {
+    GetIsolate()->ThrowException(v8::String::NewFromUtf8(
+        GetIsolate(), "Invalid arguments to 'compileModule'"));
+    return;
+  }
+
+  std::string name(*v8::String::Utf8Value(args[0]));
+  std::string source;
+  base::FilePath path;
+  if (!source_map_->ReadModule(name, &source, &path)) {
+    GetIsolate()->ThrowException(v8::Exception::Error(
+        gin::StringToV8(GetIsolate(), "Cannot find module '" + name + "'")));
+    return;
+  }
+
+  // Modules used to be wrapped by the module system, which runs them in
+  // strict mode and gives them its exports object and its functions.
+  source = "(function (require, module, console, exports, " +
+      std::string(kModuleSystemArguments) + ") {'use strict'; " + source +
+      "\n})";
+
+  v8::Local<v8::Context> v8_context = context()->v8_context();
+  v8::Local<v8::Script> script;
+  v8::Local<v8::Value> fn;
+  if (!atom::CodeCache::GetInstance()->Compile(
+          v8_context, gin::StringToV8(GetIsolate(), source),
+          path.AsUTF8Unsafe()).ToLocal(&script) ||
+      !script->Run(v8_context).ToLocal(&fn))
+    return;
+  args.GetReturnValue().Set(fn);
+}
+
+}  // namespace brave
@@ -6,7 +6,9 @@
 
 #include "atom/browser/api/atom_api_app.h"
 #include "atom/browser/javascript_environment.h"
+#include "atom/browser/v8_profiling_host.h"
 #include "base/lazy_instance.h"
+#include "base/memory/ref_counted.h"
 #include "base/run_loop.h"
 #include "base/threading/thread_local.h"
 #include "brave/common/workers/worker_bindings.h"
@@ -28,6 +30,7 @@ void NotifyStart(atom::api::App* app, int worker_id) {
 }
 
 void NotifyStop(atom::api::App* app, int worker_id) {
+  atom::V8ProfilingHost::GetInstance()->OnWorkerStopped(worker_id);
   app->Emit("worker-stop", worker_id);
 }
 
@@ -35,6 +38,46 @@ void NotifyError(atom::api::App* app, int worker_id, std::string error) {
   app->Emit("worker-onerror", worker_id, error);
 }
 
+// Adds up what the worker threads freed and reports it once all are done.
+// Each posted task and each reply holds a reference, so the report is sent
+// when the last of them has run or was dropped because its worker stopped.
+class WorkerReclaim : public base::RefCountedThreadSafe<WorkerReclaim> {
+ public:
+  explicit WorkerReclaim(const atom::MemoryCoordinator::DoneCallback& done)
+      : done_(done), bytes_freed_(0) {}
+
+  // Called on the UI thread.
+  void OnThreadDone(uint64_t bytes_freed) {
+    bytes_freed_ += bytes_freed;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<WorkerReclaim>;
+
+  // The last reference may be released on a worker thread.
+  ~WorkerReclaim() {
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                            base::Bind(done_, bytes_freed_));
+  }
+
+  atom::MemoryCoordinator::DoneCallback done_;
+  uint64_t bytes_freed_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerReclaim);
+};
+
+void ReclaimOnWorkerThread(atom::MemoryCoordinator::Level level,
+                           const base::Callback<void(uint64_t)>& reply) {
+  uint64_t bytes_freed = 0;
+  V8WorkerThread* thread = V8WorkerThread::current();
+  if (thread && thread->env()) {
+    bytes_freed = atom::MemoryCoordinator::ReclaimIsolateMemory(
+        thread->env()->isolate(), level);
+  }
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                          base::Bind(reply, bytes_freed));
+}
+
 void Kill(V8WorkerThread* worker) {
   delete worker;
 }
@@ -83,10 +126,6 @@ void V8WorkerThread::Init() {
   env()->module_system()->RegisterNativeHandler(
       "worker", std::unique_ptr<extensions::NativeHandler>(
           new WorkerBindings(env()->script_context(), this)));
-
-  memory_pressure_listener_.reset(new base::MemoryPressureListener(
-      base::Bind(&V8WorkerThread::OnMemoryPressure,
-        base::Unretained(this))));
 }
 
 void V8WorkerThread::Run(base::RunLoop* run_loop) {
@@ -104,15 +143,20 @@ void V8WorkerThread::Run(base::RunLoop* run_loop) {
 // Called just after the message loop ends
 void V8WorkerThread::CleanUp() {
   content::WorkerThreadRegistry::Instance()->WillStopCurrentWorkerThread();
-  memory_pressure_listener_.reset();
   env()->OnMessageLoopDestroying();
   js_env_.reset();
   V8WorkerThread::Shutdown();
 }
 
-void V8WorkerThread::OnMemoryPressure(
-    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
-  env()->isolate()->LowMemoryNotification();
+// static
+void V8WorkerThread::ReclaimMemory(
+    atom::MemoryCoordinator::Level level,
+    const atom::MemoryCoordinator::DoneCallback& done) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  scoped_refptr<WorkerReclaim> reclaim(new WorkerReclaim(done));
+  content::WorkerThreadRegistry::Instance()->PostTaskToAllThreads(
+      base::Bind(&ReclaimOnWorkerThread, level,
+                 base::Bind(&WorkerReclaim::OnThreadDone, reclaim)));
 }
 
 void V8WorkerThread::LoadModule() {
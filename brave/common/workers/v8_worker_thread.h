@@ -8,7 +8,7 @@
 #include <memory>
 #include <string>
 
-#include "base/memory/memory_pressure_listener.h"
+#include "atom/browser/memory_coordinator.h"
 #include "base/threading/thread.h"
 
 namespace atom {
@@ -29,6 +29,10 @@ class V8WorkerThread : public base::Thread {
   static V8WorkerThread* current();
   static void Shutdown();
 
+  // Collects garbage in the isolates of all worker threads. UI thread.
+  static void ReclaimMemory(atom::MemoryCoordinator::Level level,
+                            const atom::MemoryCoordinator::DoneCallback& done);
+
   void Init() override;
   void Run(base::RunLoop* run_loop) override;
   void CleanUp() override;
@@ -39,13 +43,10 @@ class V8WorkerThread : public base::Thread {
 
  private:
   void LoadModule();
-  void OnMemoryPressure(
-    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
 
   const std::string module_name_;
   atom::api::App* app_;
   std::unique_ptr<atom::JavascriptEnvironment> js_env_;
-  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 };
 
 }  // namespace brave
@@ -4,7 +4,9 @@
 
 #include "brave/renderer/brave_content_renderer_client.h"
 
+#include "atom/renderer/background_tab_throttler.h"
 #include "atom/renderer/content_settings_manager.h"
+#include "atom/renderer/resource_usage_reporter.h"
 #include "brave/renderer/printing/brave_print_render_frame_helper_delegate.h"
 #include "chrome/common/render_messages.h"
 #include "chrome/common/secure_origin_whitelist.h"
@@ -97,6 +99,12 @@ void BraveContentRendererClient::RenderThreadStarted() {
 
   thread->AddObserver(chrome_observer_.get());
 
+  resource_usage_reporter_.reset(new atom::ResourceUsageReporter());
+  thread->AddObserver(resource_usage_reporter_.get());
+
+  background_tab_throttler_.reset(new atom::BackgroundTabThrottler());
+  thread->AddObserver(background_tab_throttler_.get());
+
   prescient_networking_dispatcher_.reset(
       new network_hints::PrescientNetworkingDispatcher());
 
@@ -18,7 +18,9 @@
 #include "base/compiler_specific.h"
 
 namespace atom {
+class BackgroundTabThrottler;
 class ContentSettingsManager;
+class ResourceUsageReporter;
 }
 
 namespace blink {
@@ -68,6 +70,8 @@ class BraveContentRendererClient : public ChromeContentRendererClient {
   std::unique_ptr<SpellCheck> spellcheck_;
 
   std::unique_ptr<ChromeRenderThreadObserver> chrome_observer_;
+  std::unique_ptr<atom::ResourceUsageReporter> resource_usage_reporter_;
+  std::unique_ptr<atom::BackgroundTabThrottler> background_tab_throttler_;
   std::unique_ptr<web_cache::WebCacheImpl> web_cache_impl_;
 
   std::unique_ptr<network_hints::PrescientNetworkingDispatcher>
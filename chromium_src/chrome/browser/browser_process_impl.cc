@@ -357,11 +357,10 @@ void BrowserProcessImpl::PreMainMessageLoopRun() {
   storage_monitor::StorageMonitor::Create();
 #endif
 
-// Start the tab manager here so that we give the most amount of time for the
-// other services to start up before we start adjusting the oom priority.
-#if defined(OS_WIN) || defined(OS_MACOSX) || defined(OS_LINUX)
-  g_browser_process->GetTabManager()->Start();
-#endif
+  // The tab manager is not started. GuestTabDiscardPolicy decides which tabs
+  // are discarded, and the memory pressure listener and timers of the tab
+  // manager would discard the same tabs on their own. The tab manager is
+  // still created on first use to track the tabs and discard them.
 }
 
 resource_coordinator::TabManager* BrowserProcessImpl::GetTabManager() {
@@ -4,6 +4,11 @@
 
 #include "chrome/browser/media/webrtc/media_stream_capture_indicator.h"
 
+#include "browser/media/media_capture_devices_dispatcher.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/web_contents.h"
+
 MediaStreamCaptureIndicator::MediaStreamCaptureIndicator() {
 }
 
@@ -12,6 +17,15 @@ MediaStreamCaptureIndicator::~MediaStreamCaptureIndicator() {
 
 bool MediaStreamCaptureIndicator::IsCapturingUserMedia(
     content::WebContents* web_contents) const {
+  if (!web_contents)
+    return false;
+
+  auto dispatcher = brightray::MediaCaptureDevicesDispatcher::GetInstance();
+  for (content::RenderFrameHost* frame : web_contents->GetAllFrames()) {
+    if (dispatcher->IsCapturingUserMedia(frame->GetProcess()->GetID(),
+                                         frame->GetRoutingID()))
+      return true;
+  }
   return false;
 }
 
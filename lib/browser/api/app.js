@@ -9,8 +9,10 @@ module.exports = app
 const electron = require('electron')
 const {deprecate, Menu} = electron
 const {EventEmitter} = require('events')
+const trackListeners = require('../listener-tracking')
 
 Object.setPrototypeOf(App.prototype, EventEmitter.prototype)
+trackListeners(App.prototype)
 
 let appPath = null
 
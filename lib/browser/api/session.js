@@ -1,6 +1,7 @@
 const {EventEmitter} = require('events')
 const {app} = require('electron')
-const {fromPartition, getAllSessions, Session} = process.atomBinding('session')
+const trackListeners = require('../listener-tracking')
+const {fromPartition, fromPartitionAsync, getAllSessions, Session} = process.atomBinding('session')
 
 // Public API.
 Object.defineProperties(exports, {
@@ -12,6 +13,22 @@ Object.defineProperties(exports, {
     enumerable: true,
     value: fromPartition
   },
+  fromPartitionAsync: {
+    enumerable: true,
+    value: function (partition, options, callback) {
+      if (typeof options === 'function') {
+        callback = options
+        options = {}
+      }
+      options = options || {}
+      if (typeof callback === 'function') {
+        return fromPartitionAsync(partition, options, callback)
+      }
+      return new Promise((resolve) => {
+        fromPartitionAsync(partition, options, resolve)
+      })
+    }
+  },
   getAllSessions: {
     enumerable: true,
     value: getAllSessions
@@ -19,7 +36,36 @@ Object.defineProperties(exports, {
 })
 
 Object.setPrototypeOf(Session.prototype, EventEmitter.prototype)
+trackListeners(Session.prototype)
 
 Session.prototype._init = function () {
   app.emit('session-created', this)
 }
+
+// Runs a native cache walk, calling back node style or returning a Promise.
+const walkCache = function (walk, options, callback) {
+  const progress = typeof options.progress === 'function' ? options.progress : () => {}
+  const run = (done) => {
+    walk(options, progress, (error, result) => {
+      done(error ? new Error(error) : null, result)
+    })
+  }
+  if (typeof callback === 'function') {
+    return run(callback)
+  }
+  return new Promise((resolve, reject) => {
+    run((error, result) => error ? reject(error) : resolve(result))
+  })
+}
+
+Session.prototype.getCacheUsage = function (options, callback) {
+  if (typeof options === 'function') {
+    callback = options
+    options = {}
+  }
+  return walkCache(this._getCacheUsage.bind(this), options || {}, callback)
+}
+
+Session.prototype.clearCacheEntries = function (filter, callback) {
+  return walkCache(this._clearCacheEntries.bind(this), filter || {}, callback)
+}
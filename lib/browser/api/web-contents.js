@@ -5,6 +5,7 @@ const electron = require('electron')
 const {app, ipcMain, session, NavigationController, BrowserWindow} = electron
 // Load the guest view manager.
 const guestViewManager = require('../guest-view-manager')
+const trackListeners = require('../listener-tracking')
 
 
 // session is not used here, the purpose is to make sure session is initalized
@@ -90,6 +91,7 @@ const {WebContents} = binding
 
 Object.setPrototypeOf(NavigationController.prototype, EventEmitter.prototype)
 Object.setPrototypeOf(WebContents.prototype, NavigationController.prototype)
+trackListeners(WebContents.prototype)
 
 // WebContents::send(channel, args..)
 WebContents.prototype.sendShared = function (channel, shared) {
@@ -249,5 +251,29 @@ module.exports = {
 
   getAllWebContents () {
     return binding.getAllWebContents()
+  },
+
+  setThumbnailCacheLimits (limits) {
+    binding.setThumbnailCacheLimits(limits)
+  },
+
+  getThumbnailCacheStats () {
+    return binding.getThumbnailCacheStats()
+  },
+
+  setTabDiscardPolicy (options) {
+    binding.setTabDiscardPolicy(options)
+  },
+
+  getTabDiscardStats () {
+    return binding.getTabDiscardStats()
+  },
+
+  setTabRestoreOptions (options) {
+    binding.setTabRestoreOptions(options)
+  },
+
+  getTabRestoreStats () {
+    return binding.getTabRestoreStats()
   }
 }
@@ -0,0 +1,54 @@
+'use strict'
+
+// Compiles the modules loaded by the browser process with the V8 code cache
+// kept in the user data directory, so unchanged modules are not compiled
+// again on the next start.
+
+const Module = require('module')
+const vm = require('vm')
+const v8Util = process.atomBinding('v8_util')
+
+if (v8Util.getCodeCacheStats().enabled) {
+  const compile = Module.prototype._compile
+  const runInThisContext = vm.runInThisContext
+
+  // The file name of the module being compiled by the module loader, other
+  // callers of vm.runInThisContext are left alone.
+  let compiling = null
+
+  Module.prototype._compile = function (content, filename) {
+    const previous = compiling
+    compiling = filename
+    try {
+      return compile.apply(this, arguments)
+    } finally {
+      compiling = previous
+    }
+  }
+
+  // Module.prototype._compile calls this with the wrapped module source and
+  // its file name.
+  vm.runInThisContext = function (code, options) {
+    if (compiling === null || typeof code !== 'string' || options == null ||
+        options.filename !== compiling || options.cachedData) {
+      return runInThisContext.apply(this, arguments)
+    }
+    // Modules required while this one runs set their own file name.
+    compiling = null
+
+    const cachedData = v8Util.getCodeCache(options.filename, code)
+    const script = new vm.Script(code, Object.assign({}, options, {
+      cachedData: cachedData,
+      produceCachedData: !cachedData
+    }))
+    if (cachedData) {
+      // V8 has compiled the module anyway, a new cache is produced next time.
+      if (script.cachedDataRejected) {
+        v8Util.rejectCodeCache(options.filename)
+      }
+    } else if (script.cachedDataProduced) {
+      v8Util.setCodeCache(options.filename, code, script.cachedData)
+    }
+    return script.runInThisContext(options)
+  }
+}
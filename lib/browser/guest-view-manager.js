@@ -43,7 +43,44 @@ let supportedWebViewEvents = [
   'did-block-run-insecure-content'
 ]
 
+// Events that cost too much to build for every guest. They are only forwarded
+// while the <webview> of the embedder has listeners for them.
+const lazyWebViewEvents = [
+  'did-get-response-details'
+]
+
 let guests = {}
+
+const createDispatcher = function (guest, tabId, event) {
+  return function (_, ...args) {
+    const embedder = guests[tabId]
+
+    if (!embedder || embedder.isDestroyed())
+      return
+
+    let forceSend = false
+    if (['destroyed', 'did-detach', 'will-detach'].includes(event)) {
+      delete guests[tabId]
+      forceSend = true
+    }
+
+    if (guest.isDestroyed() && !forceSend)
+      return
+
+    // ResponseHeaders can't be sent, the embedder wraps the object again.
+    if (event === 'did-get-response-details') {
+      args[6] = args[6].toObject()
+    }
+
+    embedder.send.apply(embedder, ['ELECTRON_GUEST_VIEW_INTERNAL_DISPATCH_EVENT-' + tabId, event].concat(args))
+  }
+}
+
+// The lazy events the embedder listens to, by tab id. The embedder can report
+// its listeners before the guest is registered.
+let lazyListening = {}
+// The registered guests and their listeners of the lazy events, by tab id.
+let lazyForwarders = {}
 const registerGuest = function (guest, embedder) {
   const tabId = guest.getId()
 
@@ -60,27 +97,17 @@ const registerGuest = function (guest, embedder) {
   }
 
   // Dispatch events to embedder.
-  const fn = function (event) {
-    guest.on(event, function (_, ...args) {
-      const embedder = guests[tabId]
-
-      if (!embedder || embedder.isDestroyed())
-        return
-
-      let forceSend = false
-      if (['destroyed', 'did-detach', 'will-detach'].includes(event)) {
-        delete guests[tabId]
-        forceSend = true
-      }
-
-      if (guest.isDestroyed() && !forceSend)
-        return
-
-      embedder.send.apply(embedder, ['ELECTRON_GUEST_VIEW_INTERNAL_DISPATCH_EVENT-' + tabId, event].concat(args))
-    })
-  }
   for (const event of supportedWebViewEvents) {
-    fn(event)
+    guest.on(event, createDispatcher(guest, tabId, event))
+  }
+
+  lazyForwarders[tabId] = {guest, listeners: {}}
+  guest.once('destroyed', function () {
+    delete lazyForwarders[tabId]
+    delete lazyListening[tabId]
+  })
+  for (const event of lazyWebViewEvents) {
+    updateLazyForwarding(tabId, event)
   }
 
   // Dispatch guest's IPC messages to embedder.
@@ -93,4 +120,31 @@ const registerGuest = function (guest, embedder) {
   })
 }
 
+// Forwards a lazy event of the guest while the embedder listens to it.
+const updateLazyForwarding = function (tabId, event) {
+  const forwarders = lazyForwarders[tabId]
+  if (!forwarders) return
+
+  const listening = !!(lazyListening[tabId] && lazyListening[tabId][event])
+  const listener = forwarders.listeners[event]
+  if (listening && !listener) {
+    forwarders.listeners[event] = createDispatcher(forwarders.guest, tabId, event)
+    forwarders.guest.on(event, forwarders.listeners[event])
+  } else if (!listening && listener) {
+    delete forwarders.listeners[event]
+    forwarders.guest.removeListener(event, listener)
+  }
+}
+
+ipcMain.on('ELECTRON_GUEST_VIEW_MANAGER_SET_LISTENING', function (event, tabId, name, listening) {
+  if (!lazyWebViewEvents.includes(name)) return
+  // Only the current embedder of a registered guest decides.
+  const embedder = guests[tabId]
+  if (embedder !== undefined && embedder !== event.sender) return
+
+  if (!lazyListening[tabId]) lazyListening[tabId] = {}
+  lazyListening[tabId][name] = !!listening
+  updateLazyForwarding(tabId, name)
+})
+
 exports.registerGuest = registerGuest
@@ -19,6 +19,9 @@ if (index > -1) {
   process.argv.push(removedItem)
 }
 
+// Compile the modules loaded from here on with the code cache.
+require('./code-cache')
+
 // Clear search paths.
 require('../common/reset-search-paths')
 
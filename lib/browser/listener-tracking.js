@@ -0,0 +1,44 @@
+'use strict'
+
+const {EventEmitter} = require('events')
+
+const {addListener, prependListener, removeListener, removeAllListeners} =
+  EventEmitter.prototype
+
+// Tells the native side of the emitter whether |name| has listeners, so it
+// can skip building and emitting events nobody listens to.
+const update = function (emitter, name) {
+  if (typeof name !== 'string') return
+  if (typeof emitter.isDestroyed === 'function' && emitter.isDestroyed()) return
+  emitter._setListening(name, emitter.listenerCount(name) > 0)
+}
+
+// Makes the emitters with |prototype| report their listeners. It must be
+// called before any listener is added, once() and the other helpers go
+// through the methods replaced here.
+module.exports = function (prototype) {
+  prototype.addListener = prototype.on = function (name, listener) {
+    addListener.call(this, name, listener)
+    update(this, name)
+    return this
+  }
+
+  prototype.prependListener = function (name, listener) {
+    prependListener.call(this, name, listener)
+    update(this, name)
+    return this
+  }
+
+  prototype.removeListener = function (name, listener) {
+    removeListener.call(this, name, listener)
+    update(this, name)
+    return this
+  }
+
+  prototype.removeAllListeners = function (name) {
+    const names = arguments.length === 0 ? this.eventNames() : [name]
+    removeAllListeners.apply(this, arguments)
+    names.forEach((name) => update(this, name))
+    return this
+  }
+}
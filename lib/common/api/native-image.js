@@ -1 +1,31 @@
-module.exports = process.atomBinding('native_image')
+const nativeImage = process.atomBinding('native_image')
+
+const {createFromPathAsync} = nativeImage
+const NativeImagePrototype = Object.getPrototypeOf(nativeImage.createEmpty())
+const {processAsync} = NativeImagePrototype
+
+// Return a Promise when no callback is passed to the async methods.
+const promisify = function (fn, self, args) {
+  if (typeof args[args.length - 1] === 'function') {
+    return fn.apply(self, args)
+  }
+  return new Promise((resolve, reject) => {
+    fn.call(self, ...args, (error, result) => {
+      if (error) {
+        reject(new Error(error))
+      } else {
+        resolve(result)
+      }
+    })
+  })
+}
+
+nativeImage.createFromPathAsync = function (...args) {
+  return promisify(createFromPathAsync, nativeImage, args)
+}
+
+NativeImagePrototype.processAsync = function (...args) {
+  return promisify(processAsync, this, args)
+}
+
+module.exports = nativeImage
@@ -1,6 +1,10 @@
 const path = requireNative('path')
+const codeCache = requireNative('code_cache')
 
-const commonjs = function (fn, exports, modulePath, __global__) {
+// |moduleSystemArgs| are the values of kModuleSystemArguments, which follow
+// the arguments of commonjs modules.
+const commonjs = function (fn, exports, modulePath, __global__,
+                           moduleSystemArgs = []) {
   // convert module.exports to exports.$set
   const exportsHandler = {
     set: (target, name, value) => {
@@ -66,7 +70,8 @@ const commonjs = function (fn, exports, modulePath, __global__) {
     }
 
     try {
-      fn.apply(__global__, [requireProxy, moduleProxy, console])
+      fn.apply(__global__,
+        [requireProxy, moduleProxy, console, exports].concat(moduleSystemArgs))
     } catch (e) {
       if (__global__.onerror) {
         __global__.onerror(e)
@@ -77,3 +82,6 @@ const commonjs = function (fn, exports, modulePath, __global__) {
 }
 
 exports.$set('require', commonjs)
+exports.$set('load', (exports, modulePath, __global__, moduleSystemArgs) =>
+  commonjs(codeCache.compileModule(modulePath), exports, modulePath, __global__,
+           moduleSystemArgs))
@@ -39,7 +39,26 @@ var WEB_VIEW_EVENTS = {
   'show-autofill-settings': [],
   'update-autofill-popup-data-list-values': ['values', 'labels'],
   'hide-autofill-popup': [],
-  'show-autofill-popup': ['suggestions', 'rect']
+  'show-autofill-popup': ['suggestions', 'rect'],
+  'did-get-response-details': ['status', 'newURL', 'originalURL', 'httpResponseCode', 'requestMethod', 'referrer', 'headers', 'resourceType']
+}
+
+// Same interface as the ResponseHeaders of webContents, over the object of
+// lower-cased header names the browser sends.
+var ResponseHeaders = function (headers) {
+  this.headers_ = headers || {}
+}
+
+ResponseHeaders.prototype.get = function (name) {
+  return this.headers_[String(name).toLowerCase()]
+}
+
+ResponseHeaders.prototype.has = function (name) {
+  return this.get(name) !== undefined
+}
+
+ResponseHeaders.prototype.toObject = function () {
+  return this.headers_
 }
 
 var dispatchEvent = function (webView, eventName, eventKey, ...args) {
@@ -56,6 +75,9 @@ var dispatchEvent = function (webView, eventName, eventKey, ...args) {
 const GuestViewInternal = {
   registerEvents: function (webView, tabId) {
     ipcRenderer.on('ELECTRON_GUEST_VIEW_INTERNAL_DISPATCH_EVENT-' + tabId, function (event, eventName, ...args) {
+      if (eventName === 'did-get-response-details') {
+        args[6] = new ResponseHeaders(args[6])
+      }
       dispatchEvent.apply(null, [webView, eventName, eventName].concat(args))
     })
 
@@ -67,6 +89,10 @@ const GuestViewInternal = {
     })
 
   },
+  // Tells the browser whether the <webview> of |tabId| listens to |eventName|.
+  setListening: function (tabId, eventName, listening) {
+    ipcRenderer.send('ELECTRON_GUEST_VIEW_MANAGER_SET_LISTENING', tabId, eventName, listening)
+  },
   deregisterEvents: function (tabId) {
     ipcRenderer.removeAllListeners('ELECTRON_GUEST_VIEW_INTERNAL_DISPATCH_EVENT-' + tabId)
     ipcRenderer.removeAllListeners('ELECTRON_GUEST_VIEW_INTERNAL_IPC_MESSAGE-' + tabId)
@@ -334,4 +334,148 @@ describe('app module', function () {
       assert.equal(typeof app.isAccessibilitySupportEnabled(), 'boolean')
     })
   })
+
+  describe('app.sendMemoryPressureAlert(level)', function () {
+    it('emits memory-reclaimed with a report per consumer', function (done) {
+      app.once('memory-reclaimed', function (event, details) {
+        assert.equal(details.level, 'moderate')
+        assert.equal(typeof details.bytesFreed, 'number')
+        const names = details.consumers.map((consumer) => consumer.name)
+        assert.ok(names.includes('native-image-cache'))
+        assert.ok(!names.includes('asar-extracted-files'))
+        done()
+      })
+      app.sendMemoryPressureAlert('moderate')
+    })
+  })
+
+  describe('app.startResourceUsageSampling(interval)', function () {
+    afterEach(function () {
+      app.stopResourceUsageSampling()
+    })
+
+    it('emits resource-usage with the browser process', function (done) {
+      app.once('resource-usage', function (event, details) {
+        const browser = details.processes.find((process) => process.type === 'browser')
+        assert.ok(browser)
+        assert.equal(browser.id, 0)
+        assert.ok(browser.v8HeapUsed > 0)
+        assert.ok(Array.isArray(details.tabs))
+        assert.ok(Array.isArray(details.workers))
+        done()
+      })
+      app.startResourceUsageSampling(100)
+    })
+
+    it('throws for intervals that are not numbers or too short', function () {
+      assert.throws(() => {
+        app.startResourceUsageSampling('100')
+      }, /`interval` must be a number/)
+      assert.throws(() => {
+        app.startResourceUsageSampling(0)
+      }, /`interval` must be at least 100/)
+      assert.throws(() => {
+        app.startResourceUsageSampling(99)
+      }, /`interval` must be at least 100/)
+    })
+  })
+
+  describe('app.getStartupTimeline()', function () {
+    it('records the phases relative to the entry point of the executable', function () {
+      const timeline = app.getStartupTimeline()
+      const find = (name) => timeline.find((event) => event.name === name)
+      const phases = ['PreEarlyInitialization', 'PreCreateThreads',
+        'PreMainMessageLoopRun', 'JavascriptEnvironment', 'NodeEnvironment']
+      phases.forEach((name) => {
+        assert.ok(find(name), name)
+        assert.ok(find(name).duration >= 0, name)
+      })
+      // The main function of the executable runs before the first phase.
+      assert.ok(find('PreEarlyInitialization').startTime > 0)
+      assert.ok(find('PreCreateThreads').startTime >=
+                find('PreEarlyInitialization').startTime)
+    })
+  })
+
+  describe('app.writeStartupTrace(path)', function () {
+    const tracePath = path.join(app.getPath('temp'), 'muon-spec-startup-trace.json')
+
+    afterEach(function () {
+      if (fs.existsSync(tracePath)) {
+        fs.unlinkSync(tracePath)
+      }
+    })
+
+    it('writes the timeline in the trace event format', function (done) {
+      app.writeStartupTrace(tracePath)
+      // The file is written on a background thread.
+      const interval = setInterval(function () {
+        if (!fs.existsSync(tracePath)) {
+          return
+        }
+        clearInterval(interval)
+        const trace = JSON.parse(fs.readFileSync(tracePath, 'utf8'))
+        const names = app.getStartupTimeline().map((event) => event.name)
+        trace.traceEvents.forEach((event) => {
+          assert.ok(names.includes(event.name), event.name)
+        })
+        const phase = trace.traceEvents.find((event) => event.name === 'PreCreateThreads')
+        assert.equal(phase.ph, 'X')
+        assert.equal(phase.cat, 'startup')
+        assert.ok(phase.ts > 0)
+        done()
+      }, 50)
+    })
+  })
+
+  describe('native events without listeners', function () {
+    const fixtures = path.resolve(__dirname, 'fixtures')
+    const emitter = remote.require(path.join(fixtures, 'module', 'emit-tracking.js'))
+
+    it('are not emitted', function () {
+      assert.deepEqual(emitter.run(['emit']), {emitted: 0, delivered: 0})
+    })
+
+    it('are emitted again once a listener is added with once()', function () {
+      assert.deepEqual(emitter.run(['once', 'emit', 'emit']),
+                       {emitted: 1, delivered: 1})
+    })
+
+    it('are emitted again once a listener is added with prependListener()', function () {
+      assert.deepEqual(emitter.run(['prepend', 'emit', 'remove', 'emit']),
+                       {emitted: 1, delivered: 1})
+    })
+
+    // Timings are too noisy to pass or fail on, the benchmark only reports
+    // them when MUON_EMIT_BENCHMARK is set.
+    const benchmarkIt = process.env.MUON_EMIT_BENCHMARK ? it : xit
+    benchmarkIt('reports the cost of emitting them', function () {
+      const benchmark = remote.require(path.join(fixtures, 'module', 'emit-benchmark.js'))
+      const iterations = 100000
+      const result = benchmark.run(iterations)
+      console.log(`Emit cost per event: ${result.withoutListeners.toFixed(0)}ns without listeners, ` +
+                  `${result.withListeners.toFixed(0)}ns with one, ` +
+                  `${result.afterRemoval.toFixed(0)}ns after removing it`)
+      assert.equal(result.count, iterations)
+    })
+  })
+
+  describe('app.stopProfiling(target, fd, callback)', function () {
+    it('writes the profiles of the browser process', function (done) {
+      const profilePath = path.join(app.getPath('temp'), 'muon-spec-profile.json')
+      const mainFs = remote.require('fs')
+      assert.ok(app.startProfiling({}, {heapSamplingInterval: 1024}))
+      const fd = mainFs.openSync(profilePath, 'w')
+      assert.ok(app.stopProfiling({}, fd, (success) => {
+        assert.ok(success)
+        const profile = JSON.parse(fs.readFileSync(profilePath, 'utf8'))
+        fs.unlinkSync(profilePath)
+        assert.ok(profile.cpuProfile.nodes.length > 0)
+        assert.equal(profile.cpuProfile.samples.length, profile.cpuProfile.timeDeltas.length)
+        assert.ok(Array.isArray(profile.heapProfile.head.children))
+        done()
+      }))
+      mainFs.closeSync(fd)
+    })
+  })
 })
@@ -143,6 +143,19 @@ describe('browser-window module', function () {
       w.loadURL('file://' + path.join(fixtures, 'pages', 'did-get-response-details.html'))
     })
 
+    it('should only emit did-get-response-details for filtered resources', function (done) {
+      w.webContents.setResponseDetailsFilter({resourceTypes: ['image']})
+      w.webContents.on('did-get-response-details', function (event, status, newUrl, oldUrl, responseCode, method, referrer, headers, resourceType) {
+        assert.equal(newUrl.slice(newUrl.lastIndexOf('/') + 1), 'logo.png')
+        assert.equal(resourceType, 'image')
+        assert.equal(typeof headers.toObject(), 'object')
+        assert.equal(headers.has('x-not-sent'), false)
+        assert.equal(headers.get('x-not-sent'), undefined)
+        done()
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'did-get-response-details.html'))
+    })
+
     it('should emit did-fail-load event for files that do not exist', function (done) {
       w.webContents.on('did-fail-load', function (event, code, desc, url, isMainFrame) {
         assert.equal(code, -6)
@@ -485,6 +485,89 @@ describe('ipc module', function () {
     })
   })
 
+  describe('webContents.send channel subscriptions', function () {
+    beforeEach(function () {
+      w = new BrowserWindow({show: false})
+    })
+
+    afterEach(function () {
+      ipcMain.removeAllListeners('subscriptions')
+    })
+
+    // Runs |steps| in order, each when the page reports the state it waits
+    // for, and calls back with the pings the page received.
+    const run = function (steps, done) {
+      ipcMain.on('subscriptions', function (event, state, received) {
+        if (state === 'report') {
+          done(received)
+          return
+        }
+        const step = steps.shift()
+        assert.equal(state, step.on)
+        step.run()
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'ipc-subscriptions.html'))
+    }
+
+    it('delivers messages only while the channel has a listener', function (done) {
+      const contents = w.webContents
+      run([{
+        on: 'ready',
+        run: () => {
+          contents.send('ping', 1)
+          contents.send('subscribe')
+        }
+      }, {
+        on: 'subscribed',
+        run: () => {
+          contents.send('ping', 2)
+          contents.send('unsubscribe')
+        }
+      }, {
+        on: 'unsubscribed',
+        run: () => {
+          contents.send('ping', 3)
+          contents.send('subscribe')
+        }
+      }, {
+        on: 'subscribed',
+        run: () => {
+          contents.send('ping', 4)
+          contents.send('report')
+        }
+      }], function (received) {
+        assert.deepEqual(received, [2, 4])
+        done()
+      })
+    })
+
+    it('drops the listeners of a page that went away', function (done) {
+      const contents = w.webContents
+      run([{
+        on: 'ready',
+        run: () => contents.send('subscribe')
+      }, {
+        on: 'subscribed',
+        run: () => contents.reload()
+      }, {
+        on: 'ready',
+        run: () => {
+          contents.send('ping', 1)
+          contents.send('subscribe')
+        }
+      }, {
+        on: 'subscribed',
+        run: () => {
+          contents.send('ping', 2)
+          contents.send('report')
+        }
+      }], function (received) {
+        assert.deepEqual(received, [2])
+        done()
+      })
+    })
+  })
+
   describe('remote listeners', function () {
     it('can be added and removed correctly', function () {
       w = new BrowserWindow({
@@ -59,4 +59,127 @@ describe('nativeImage module', () => {
       assert.equal(image.getSize().width, 256)
     })
   })
+
+  describe('createFromPathAsync(path)', () => {
+    it('decodes images in the background', () => {
+      const imagePath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+      return nativeImage.createFromPathAsync(imagePath).then((image) => {
+        assert(!image.isEmpty())
+        assert.equal(image.getSize().height, 190)
+        assert.equal(image.getSize().width, 538)
+      })
+    })
+
+    it('rejects for invalid paths', () => {
+      return nativeImage.createFromPathAsync('does-not-exist.png').then(() => {
+        assert.fail('should not resolve')
+      }, (error) => {
+        assert(error instanceof Error)
+      })
+    })
+  })
+
+  describe('processAsync(operations)', () => {
+    const imagePath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+
+    it('crops and resizes without encoding', () => {
+      const image = nativeImage.createFromPath(imagePath)
+      return image.processAsync([
+        {type: 'crop', x: 0, y: 0, width: 200, height: 100},
+        {type: 'resize', width: 100, height: 50, quality: 'best'}
+      ]).then((result) => {
+        assert.equal(result.getSize().width, 100)
+        assert.equal(result.getSize().height, 50)
+      })
+    })
+
+    it('encodes to a buffer', (done) => {
+      const image = nativeImage.createFromPath(imagePath)
+      image.processAsync([{type: 'encode', format: 'png'}], (error, buffer) => {
+        assert.equal(error, null)
+        const decoded = nativeImage.createFromBuffer(buffer)
+        assert.deepEqual(decoded.getSize(), image.getSize())
+        done()
+      })
+    })
+
+    it('crops and resizes in DIPs of scaled images', () => {
+      const buffer = nativeImage.createFromPath(imagePath).toPNG()
+      const image = nativeImage.createFromBuffer(buffer, 2.0)
+      return image.processAsync([
+        {type: 'crop', x: 10, y: 10, width: 100, height: 50},
+        {type: 'resize', width: 50, height: 25},
+        {type: 'encode', format: 'png'}
+      ]).then((result) => {
+        assert.deepEqual(nativeImage.createFromBuffer(result).getSize(),
+                         {width: 100, height: 50})
+      })
+    })
+
+    it('fails for crops outside of the image', (done) => {
+      const image = nativeImage.createFromPath(imagePath)
+      const {width, height} = image.getSize()
+      image.processAsync([
+        {type: 'crop', x: width - 10, y: 0, width: 20, height: height}
+      ], (error, result) => {
+        assert.equal(error, 'Crop rect is outside of the image')
+        assert.equal(result, null)
+        done()
+      })
+    })
+
+    it('throws for unknown operations', () => {
+      const image = nativeImage.createFromPath(imagePath)
+      assert.throws(() => {
+        image.processAsync([{type: 'rotate'}], () => {})
+      }, /Unknown image operation/)
+    })
+
+    it('throws for steps after encode and invalid quality', () => {
+      const image = nativeImage.createFromPath(imagePath)
+      assert.throws(() => {
+        image.processAsync([
+          {type: 'encode', format: 'png'},
+          {type: 'resize', width: 10, height: 10}
+        ], () => {})
+      }, /encode must be the last operation/)
+      assert.throws(() => {
+        image.processAsync([{type: 'encode', format: 'jpeg', quality: 101}],
+          () => {})
+      }, /between 0 and 100/)
+    })
+  })
+
+  describe('decoded image cache', () => {
+    const imagePath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+
+    beforeEach(() => {
+      nativeImage.clearCache()
+    })
+
+    it('serves repeated loads of the same path from the cache', () => {
+      const before = nativeImage.getCacheStats()
+      nativeImage.createFromPath(imagePath)
+      nativeImage.createFromPath(imagePath)
+      const after = nativeImage.getCacheStats()
+      assert.equal(after.count, 1)
+      assert.equal(after.hits - before.hits, 1)
+      assert.equal(after.misses - before.misses, 1)
+    })
+
+    it('evicts entries to stay under the size limit', () => {
+      nativeImage.createFromPath(imagePath)
+      nativeImage.setCacheSize(0)
+      assert.equal(nativeImage.getCacheStats().count, 0)
+      nativeImage.setCacheSize(32 * 1024 * 1024)
+    })
+
+    it('throws for negative and non-finite sizes', () => {
+      for (const size of [-1, NaN, Infinity, 'big']) {
+        assert.throws(() => {
+          nativeImage.setCacheSize(size)
+        }, /`maxSize` must be a non-negative number/)
+      }
+    })
+  })
 })
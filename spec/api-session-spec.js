@@ -2,6 +2,7 @@ const assert = require('assert')
 const http = require('http')
 const path = require('path')
 const fs = require('fs')
+const os = require('os')
 const {closeWindow} = require('./window-helpers')
 
 const {ipcRenderer, remote} = require('electron')
@@ -49,6 +50,60 @@ describe('session module', function () {
     })
   })
 
+  describe('session.fromPartitionAsync(partition, options, callback)', function () {
+    it('calls back with the session once the partition has loaded', function (done) {
+      const partition = `persist:async-${Date.now()}`
+      session.fromPartitionAsync(partition, {}, function (ses) {
+        assert.equal(ses.partition, partition)
+        assert.equal(ses, session.fromPartition(partition))
+        done()
+      })
+    })
+
+    it('returns a Promise when no callback is given', function () {
+      const partition = `persist:async-promise-${Date.now()}`
+      return session.fromPartitionAsync(partition).then(function (ses) {
+        assert.equal(ses, session.fromPartition(partition))
+      })
+    })
+
+    it('creates child partitions of a partition that is still loading', function () {
+      const name = `async-child-${Date.now()}`
+      return Promise.all([
+        session.fromPartitionAsync(`persist:${name}`),
+        session.fromPartitionAsync(name)
+      ]).then(function (sessions) {
+        assert.equal(sessions[0].partition, `persist:${name}`)
+        assert.equal(sessions[1].partition, name)
+        assert.notEqual(sessions[0], sessions[1])
+      })
+    })
+
+    it('makes webContents.create and BrowserWindow throw until it has loaded', function () {
+      const loading = remote.require(path.join(fixtures, 'module', 'partition-loading.js'))
+      const message = 'The partition is still loading, use session.fromPartitionAsync'
+      return loading.run(`persist:async-loading-${Date.now()}`).then(function (errors) {
+        assert.deepEqual(errors, {
+          fromPartition: message,
+          webContents: message,
+          window: message
+        })
+      })
+    })
+
+    it('loads many partitions concurrently', function () {
+      const partitions = []
+      for (let i = 0; i < 10; i++) {
+        partitions.push(`persist:async-many-${Date.now()}-${i}`)
+      }
+      return Promise.all(partitions.map((partition) => {
+        return session.fromPartitionAsync(partition)
+      })).then(function (sessions) {
+        assert.deepEqual(sessions.map((ses) => ses.partition), partitions)
+      })
+    })
+  })
+
   describe('ses.cookies', function () {
     it('should get cookies', function (done) {
       var server = http.createServer(function (req, res) {
@@ -125,6 +180,39 @@ describe('session module', function () {
       })
     })
 
+    it('should answer several filters in one query', function (done) {
+      session.defaultSession.cookies.set({
+        url: url,
+        name: 'query_a',
+        value: '1'
+      }, function (error) {
+        if (error) {
+          return done(error)
+        }
+        session.defaultSession.cookies.query([
+          {domains: ['127.0.0.1'], namePrefix: 'query_'},
+          {name: 'query_missing'}
+        ], function (error, result) {
+          if (error) {
+            return done(error)
+          }
+          assert.equal(result.matches.length, 2)
+          assert.equal(result.matches[0].length, 1)
+          assert.equal(result.matches[1].length, 0)
+          const row = result.matches[0][0]
+          assert.equal(result.cookies.name[row], 'query_a')
+          assert.equal(result.cookies.value[row], '1')
+          done()
+        })
+      })
+    })
+
+    it('throws on invalid query filters', function () {
+      assert.throws(function () {
+        session.defaultSession.cookies.query([1], function () {})
+      }, /Each filter must be an object/)
+    })
+
     it('should remove cookies', function (done) {
       session.defaultSession.cookies.set({
         url: url,
@@ -332,6 +420,88 @@ describe('session module', function () {
     })
   })
 
+  describe('download progress', function () {
+    const chunk = Buffer.alloc(64 * 1024)
+    const chunks = 5
+    let server = null
+
+    beforeEach(function (done) {
+      server = http.createServer(function (req, res) {
+        res.writeHead(200, {
+          'Content-Length': chunk.length * chunks,
+          'Content-Type': 'application/octet-stream',
+          'Content-Disposition': 'attachment; filename="mock.bin"'
+        })
+        let sent = 0
+        const send = function () {
+          res.write(chunk)
+          if (++sent === chunks) return res.end()
+          setTimeout(send, 100)
+        }
+        send()
+      })
+      server.listen(0, '127.0.0.1', done)
+    })
+
+    afterEach(function () {
+      session.defaultSession.setDownloadProgressOptions({interval: 0})
+      server.close()
+      const downloadFilePath = path.join(fixtures, 'mock.pdf')
+      if (fs.existsSync(downloadFilePath)) fs.unlinkSync(downloadFilePath)
+    })
+
+    it('emits download-progress with the totals of the session', function (done) {
+      const totals = []
+      const listener = function (event, downloads, total) {
+        totals.push(total)
+      }
+      session.defaultSession.on('download-progress', listener)
+      ipcRenderer.sendSync('set-download-option', false, false)
+      ipcRenderer.once('download-done', function (event, state) {
+        session.defaultSession.removeListener('download-progress', listener)
+        assert.equal(state, 'completed')
+        assert.ok(totals.length > 0)
+        for (const total of totals) {
+          assert.equal(total.totalBytes, chunk.length * chunks)
+        }
+        done()
+      })
+      w.webContents.downloadURL(`${url}:${server.address().port}/`)
+    })
+
+    it('emits every updated event unless an interval is set', function (done) {
+      const updates = []
+      session.defaultSession.once('will-download', function (event, item) {
+        item.on('updated', function (event, state, progress) {
+          updates.push(progress.receivedBytes)
+        })
+      })
+      ipcRenderer.sendSync('set-download-option', false, false)
+      ipcRenderer.once('download-done', function () {
+        // Each chunk is sent 100ms apart, none is held back.
+        assert.ok(updates.length >= chunks - 1, updates)
+        done()
+      })
+      w.webContents.downloadURL(`${url}:${server.address().port}/`)
+    })
+
+    it('throttles updated events once an interval is set', function (done) {
+      const updates = []
+      session.defaultSession.setDownloadProgressOptions({interval: 10000})
+      session.defaultSession.once('will-download', function (event, item) {
+        item.on('updated', function (event, state, progress) {
+          updates.push(progress.receivedBytes)
+        })
+      })
+      ipcRenderer.sendSync('set-download-option', false, false)
+      ipcRenderer.once('download-done', function () {
+        assert.ok(updates.length < chunks - 1, updates)
+        done()
+      })
+      w.webContents.downloadURL(`${url}:${server.address().port}/`)
+    })
+  })
+
   describe('ses.protocol', function () {
     const partitionName = 'temp'
     const protocolName = 'sp'
@@ -376,6 +546,486 @@ describe('session module', function () {
     })
   })
 
+  describe('ses.extensions.load(path)', function () {
+    let extensionDir = null
+    let partition = null
+
+    const waitFor = function (event) {
+      return new Promise(function (resolve) {
+        remote.process.once(event, function (details) {
+          resolve(details)
+        })
+      })
+    }
+
+    const getCacheEntries = function () {
+      const cacheDir = path.join(remote.app.getPath('userData'), 'Partitions',
+                                 partition, 'Extension Manifest Cache')
+      return fs.existsSync(cacheDir) ? fs.readdirSync(cacheDir) : []
+    }
+
+    beforeEach(function () {
+      extensionDir = fs.mkdtempSync(path.join(os.tmpdir(), 'muon-extension-'))
+      fs.mkdirSync(path.join(extensionDir, 'icons'))
+      fs.writeFileSync(path.join(extensionDir, 'icons', 'icon.png'),
+                       fs.readFileSync(path.join(fixtures, 'assets', 'logo.png')))
+      fs.writeFileSync(path.join(extensionDir, 'manifest.json'), JSON.stringify({
+        name: 'manifest-cache',
+        version: '1.0',
+        manifest_version: 2,
+        icons: {'16': 'icons/icon.png'}
+      }))
+      partition = `extension-cache-${Date.now()}`
+    })
+
+    it('caches the manifest of a valid extension', function () {
+      const ses = session.fromPartition(`persist:${partition}`)
+      const ready = waitFor('extension-ready')
+      ses.extensions.load(extensionDir)
+      return ready.then(function (installInfo) {
+        assert.equal(installInfo.name, 'manifest-cache')
+        assert.equal(getCacheEntries().length, 1)
+      })
+    })
+
+    it('validates again when a file the manifest refers to is removed', function () {
+      const ses = session.fromPartition(`persist:${partition}`)
+      const ready = waitFor('extension-ready')
+      ses.extensions.load(extensionDir)
+      return ready.then(function () {
+        // Removing a file in a subdirectory leaves the modification times of
+        // manifest.json and of the extension directory unchanged.
+        fs.unlinkSync(path.join(extensionDir, 'icons', 'icon.png'))
+        const error = waitFor('extension-load-error')
+        ses.extensions.load(extensionDir)
+        return error
+      }).then(function (error) {
+        assert.ok(/icon/i.test(error), error)
+      })
+    })
+
+    // Loads the extension in |partition| and copies its cache entry to a new
+    // partition with the name in the cached manifest changed. Loading it there
+    // reports that name only when the entry is used without validation.
+    const loadWithMarkedEntry = function (modify) {
+      const ses = session.fromPartition(`persist:${partition}`)
+      const ready = waitFor('extension-ready')
+      ses.extensions.load(extensionDir)
+      return ready.then(function () {
+        const [entryName] = getCacheEntries()
+        const cacheDir = path.join(remote.app.getPath('userData'), 'Partitions',
+                                   partition, 'Extension Manifest Cache')
+        const entry = JSON.parse(
+          fs.readFileSync(path.join(cacheDir, entryName), 'utf8'))
+        entry.manifest.name = 'from-cache'
+
+        partition = `${partition}-marked`
+        const markedDir = path.join(remote.app.getPath('userData'),
+                                    'Partitions', partition)
+        fs.mkdirSync(markedDir)
+        fs.mkdirSync(path.join(markedDir, 'Extension Manifest Cache'))
+        fs.writeFileSync(
+          path.join(markedDir, 'Extension Manifest Cache', entryName),
+          JSON.stringify(entry))
+
+        modify()
+        const markedReady = waitFor('extension-ready')
+        session.fromPartition(`persist:${partition}`).extensions.load(
+          extensionDir)
+        return markedReady
+      })
+    }
+
+    it('uses the cache for an unchanged extension', function () {
+      return loadWithMarkedEntry(function () {
+        // Files the manifest does not refer to are not part of the key.
+        fs.mkdirSync(path.join(extensionDir, 'data'))
+        fs.writeFileSync(path.join(extensionDir, 'data', 'unused.txt'), 'data')
+      }).then(function (installInfo) {
+        assert.equal(installInfo.name, 'from-cache')
+      })
+    })
+
+    it('validates again when a file the manifest refers to changes', function () {
+      return loadWithMarkedEntry(function () {
+        fs.appendFileSync(path.join(extensionDir, 'icons', 'icon.png'), 'x')
+      }).then(function (installInfo) {
+        assert.equal(installInfo.name, 'manifest-cache')
+      })
+    })
+  })
+
+  describe('ses.extensions.setURLOverrides(extensionId, rules)', function () {
+    const partition = `extension-overrides-${Date.now()}`
+    let extensionDir = null
+
+    const waitFor = function (event) {
+      return new Promise(function (resolve) {
+        remote.process.once(event, function (details) {
+          resolve(details)
+        })
+      })
+    }
+
+    // Resolves with the title the page sets once its image loaded or failed.
+    const loadPage = function (extensionId) {
+      return new Promise(function (resolve) {
+        w.webContents.on('page-title-updated', function listener (event, title) {
+          if (title === 'loaded' || title === 'error') {
+            w.webContents.removeListener('page-title-updated', listener)
+            resolve(title)
+          }
+        })
+        w.loadURL(`chrome-extension://${extensionId}/page.html`)
+      })
+    }
+
+    beforeEach(function () {
+      extensionDir = fs.mkdtempSync(path.join(os.tmpdir(), 'muon-extension-'))
+      fs.mkdirSync(path.join(extensionDir, 'new'))
+      fs.writeFileSync(path.join(extensionDir, 'new', 'image.png'),
+                       fs.readFileSync(path.join(fixtures, 'assets', 'logo.png')))
+      fs.writeFileSync(path.join(extensionDir, 'page.html'),
+        '<img src="old/image.png" onload="document.title = \'loaded\'" ' +
+        'onerror="document.title = \'error\'">')
+      fs.writeFileSync(path.join(extensionDir, 'manifest.json'), JSON.stringify({
+        name: 'url-overrides',
+        version: '1.0',
+        manifest_version: 2
+      }))
+      if (w != null) w.destroy()
+      w = new BrowserWindow({show: false, webPreferences: {partition}})
+    })
+
+    it('redirects subresources until the extension is unloaded', function () {
+      const ses = session.fromPartition(partition)
+      const ready = waitFor('extension-ready')
+      ses.extensions.load(extensionDir)
+      let extensionId = null
+      return ready.then(function (installInfo) {
+        extensionId = installInfo.id
+        ses.extensions.setURLOverrides(extensionId, [{
+          prefix: `chrome-extension://${extensionId}/old/`,
+          replacement: `chrome-extension://${extensionId}/new/`
+        }])
+        return loadPage(extensionId)
+      }).then(function (title) {
+        assert.equal(title, 'loaded')
+        const unloaded = waitFor('extension-unloaded')
+        ses.extensions.disable(extensionId)
+        return unloaded
+      }).then(function () {
+        const enabled = waitFor('extension-ready')
+        ses.extensions.enable(extensionId)
+        return enabled
+      }).then(function () {
+        return loadPage(extensionId)
+      }).then(function (title) {
+        assert.equal(title, 'error')
+      })
+    })
+
+    // Loads the extension in |dir| and resolves with its id.
+    const loadExtension = function (dir) {
+      const ready = waitFor('extension-ready')
+      session.fromPartition(partition).extensions.load(dir)
+      return ready.then(function (installInfo) {
+        return installInfo.id
+      })
+    }
+
+    it('follows chains of prefix rules', function () {
+      const ses = session.fromPartition(partition)
+      return loadExtension(extensionDir).then(function (extensionId) {
+        const base = `chrome-extension://${extensionId}/`
+        ses.extensions.setURLOverrides(extensionId, [
+          {prefix: `${base}old/`, replacement: `${base}mid/`},
+          {prefix: `${base}mid/`, replacement: `${base}new/`}
+        ])
+        return loadPage(extensionId)
+      }).then(function (title) {
+        assert.equal(title, 'loaded')
+      })
+    })
+
+    it('does not follow rules that loop', function () {
+      const ses = session.fromPartition(partition)
+      return loadExtension(extensionDir).then(function (extensionId) {
+        const base = `chrome-extension://${extensionId}/`
+        ses.extensions.setURLOverrides(extensionId, [
+          {prefix: `${base}old/`, replacement: `${base}a/`},
+          {prefix: `${base}a/`, replacement: `${base}b/`},
+          {prefix: `${base}b/`, replacement: `${base}old/`}
+        ])
+        return loadPage(extensionId)
+      }).then(function (title) {
+        assert.equal(title, 'error')
+      })
+    })
+
+    it('moves the extension to another host with host rules', function () {
+      const ses = session.fromPartition(partition)
+      // The other extension has the page and its image under old/.
+      const otherDir = fs.mkdtempSync(path.join(os.tmpdir(), 'muon-extension-'))
+      fs.mkdirSync(path.join(otherDir, 'old'))
+      fs.writeFileSync(path.join(otherDir, 'old', 'image.png'),
+                       fs.readFileSync(path.join(fixtures, 'assets', 'logo.png')))
+      fs.writeFileSync(path.join(otherDir, 'page.html'),
+                       fs.readFileSync(path.join(extensionDir, 'page.html')))
+      fs.writeFileSync(path.join(otherDir, 'manifest.json'), JSON.stringify({
+        name: 'url-overrides-host',
+        version: '1.0',
+        manifest_version: 2,
+        web_accessible_resources: ['page.html', 'old/*']
+      }))
+      let extensionId = null
+      return loadExtension(extensionDir).then(function (id) {
+        extensionId = id
+        return loadExtension(otherDir)
+      }).then(function (otherId) {
+        ses.extensions.setURLOverrides(extensionId, [
+          {host: extensionId, replacement: otherId}
+        ])
+        return loadPage(extensionId)
+      }).then(function (title) {
+        assert.equal(title, 'loaded')
+      })
+    })
+
+    it('rejects invalid rules', function () {
+      const ses = session.fromPartition(partition)
+      assert.throws(function () {
+        ses.extensions.setURLOverrides('id', [{prefix: 'a'}])
+      }, /rules/)
+    })
+  })
+
+  describe('ses.userPrefs', function () {
+    let userPrefs = null
+    let pref = null
+
+    beforeEach(function () {
+      userPrefs = session.defaultSession.userPrefs
+      pref = `spec.dictionary_${Date.now()}`
+      userPrefs.registerDictionaryPref(pref, {}, false)
+    })
+
+    it('changes dictionary prefs in place', function () {
+      const changes = []
+      const listener = (event, path, subPath) => changes.push([path, subPath])
+      userPrefs.on('pref-changed', listener)
+      assert.equal(userPrefs.setDictionaryPrefPath(pref, 'a.b', 1), true)
+      assert.equal(userPrefs.setDictionaryPrefPath(pref, 'a.b', 1), false)
+      assert.equal(userPrefs.getDictionaryPrefPath(pref, 'a.b'), 1)
+      assert.equal(userPrefs.removeDictionaryPrefPath(pref, 'a.b'), true)
+      assert.equal(userPrefs.getDictionaryPrefPath(pref, 'a.b'), null)
+      userPrefs.removeListener('pref-changed', listener)
+      assert.deepEqual(changes, [[pref, 'a.b'], [pref, 'a.b']])
+    })
+
+    it('appends to lists in dictionary prefs', function () {
+      assert.equal(userPrefs.appendDictionaryPrefPath(pref, 'list', 1), true)
+      assert.equal(userPrefs.appendDictionaryPrefPath(pref, 'list', 2), true)
+      assert.deepEqual(userPrefs.getDictionaryPrefPath(pref, 'list'), [1, 2])
+    })
+
+    it('does not replace values that are not lists', function () {
+      userPrefs.setDictionaryPrefPath(pref, 'value', 'string')
+      assert.equal(userPrefs.appendDictionaryPrefPath(pref, 'value', 1), false)
+      assert.equal(userPrefs.appendDictionaryPrefPath(pref, 'value.list', 1),
+                   false)
+      assert.equal(userPrefs.setDictionaryPrefPath(pref, 'value.key', 1), false)
+      assert.equal(userPrefs.getDictionaryPrefPath(pref, 'value'), 'string')
+    })
+
+    it('rejects empty paths', function () {
+      for (const subPath of ['', '.', 'a.', '.a', 'a..b']) {
+        assert.equal(userPrefs.setDictionaryPrefPath(pref, subPath, 1), false)
+        assert.equal(userPrefs.appendDictionaryPrefPath(pref, subPath, 1),
+                     false)
+      }
+      assert.deepEqual(userPrefs.getDictionaryPref(pref), {})
+    })
+
+    it('rejects unknown prefs and prefs of another type', function () {
+      const unknown = `spec.unknown_${Date.now()}`
+      const string = `spec.string_${Date.now()}`
+      const list = `spec.list_${Date.now()}`
+      userPrefs.registerStringPref(string, 'value', false)
+      userPrefs.registerListPref(list, [], false)
+      for (const path of [unknown, string, list]) {
+        assert.equal(userPrefs.setDictionaryPrefPath(path, 'a', 1), false)
+        assert.equal(userPrefs.appendDictionaryPrefPath(path, 'a', 1), false)
+        assert.equal(userPrefs.removeDictionaryPrefPath(path, 'a'), false)
+        assert.equal(userPrefs.getDictionaryPrefPath(path, 'a'), null)
+      }
+      for (const path of [unknown, string, pref]) {
+        assert.equal(userPrefs.appendListPref(path, 1), false)
+      }
+      assert.equal(userPrefs.getStringPref(string), 'value')
+      assert.equal(userPrefs.appendListPref(list, 1), true)
+      assert.deepEqual(userPrefs.getListPref(list), [1])
+    })
+
+    describe('getWriteMetrics()', function () {
+      const findMetrics = function (ses, name) {
+        return ses.userPrefs.getWriteMetrics().find(function (metrics) {
+          return path.basename(metrics.path) === name
+        })
+      }
+
+      it('reports the main pref file of a partition', function () {
+        const ses = session.fromPartition(`persist:prefs-${Date.now()}`)
+        const metrics = ses.userPrefs.getWriteMetrics()
+        assert.equal(metrics.length, 1)
+        assert.equal(path.basename(metrics[0].path), 'UserPrefs')
+        assert.equal(metrics[0].failedWriteCount, 0)
+      })
+
+      it('writes sharded prefs to their own file', function (done) {
+        // ImportantFileWriter batches writes for up to 10 seconds
+        this.timeout(30000)
+        const ses = session.fromPartition(`persist:shard-${Date.now()}`, {
+          shard_prefs: true
+        })
+        assert.ok(findMetrics(ses, 'UserPrefs'))
+        assert.ok(findMetrics(ses, 'UserPrefs.app_state'))
+
+        ses.userPrefs.setDictionaryPref('app_state', {sharded: true})
+        assert.deepEqual(ses.userPrefs.getDictionaryPref('app_state'),
+                         {sharded: true})
+
+        const poll = function () {
+          const metrics = findMetrics(ses, 'UserPrefs.app_state')
+          if (metrics.writeCount === 0) {
+            setTimeout(poll, 100)
+            return
+          }
+          assert.equal(metrics.failedWriteCount, 0)
+          assert.ok(metrics.fileSize > 0)
+          assert.ok(metrics.bytesWritten >= metrics.fileSize)
+          assert.ok(metrics.serializeAndQueueTime >= 0)
+          assert.ok(metrics.maxWriteTime <= metrics.writeTime)
+          const contents = JSON.parse(fs.readFileSync(metrics.path, 'utf8'))
+          assert.deepEqual(contents.app_state, {sharded: true})
+
+          const main = findMetrics(ses, 'UserPrefs')
+          if (fs.existsSync(main.path)) {
+            const mainContents = JSON.parse(fs.readFileSync(main.path, 'utf8'))
+            assert.equal(mainContents.app_state, undefined)
+          }
+          done()
+        }
+        poll()
+      })
+    })
+  })
+
+  describe('ses.getCacheUsage(options)', function () {
+    let server = null
+    let origin = null
+
+    beforeEach(function (done) {
+      server = http.createServer(function (req, res) {
+        res.setHeader('Cache-Control', 'max-age=3600')
+        res.setHeader('Content-Type', 'text/html')
+        res.end('<html>cached</html>')
+      })
+      server.listen(0, '127.0.0.1', function () {
+        origin = `http://127.0.0.1:${server.address().port}`
+        done()
+      })
+    })
+
+    afterEach(function () {
+      server.close()
+    })
+
+    it('sums the cached entries of an origin', function (done) {
+      w.webContents.once('did-finish-load', function () {
+        const options = {origins: [origin], contentTypes: true}
+        session.defaultSession.getCacheUsage(options, function (error, usage) {
+          assert.equal(error, null)
+          assert.ok(usage.entries >= 1)
+          assert.ok(usage.size > 0)
+          assert.deepEqual(Object.keys(usage.origins), [origin])
+          assert.ok(usage.contentTypes['text/html'].entries >= 1)
+          done()
+        })
+      })
+      w.loadURL(`${origin}/`)
+    })
+
+    it('removes the cached entries of an origin', function (done) {
+      w.webContents.once('did-finish-load', function () {
+        const ses = session.defaultSession
+        ses.clearCacheEntries({origins: [origin]}, function (error, removed) {
+          assert.equal(error, null)
+          assert.ok(removed.entries >= 1)
+          ses.getCacheUsage({origins: [origin]}, function (error, usage) {
+            assert.equal(error, null)
+            assert.equal(usage.entries, 0)
+            done()
+          })
+        })
+      })
+      w.loadURL(`${origin}/`)
+    })
+
+    it('calls back when the session is destroyed during the walk', function (done) {
+      const ses = session.fromPartition(`cache-walk-${Date.now()}`)
+      ses.getCacheUsage({batchSize: 1}, function (error) {
+        if (error) {
+          assert.equal(error.message, 'net::ERR_CONTEXT_SHUT_DOWN')
+        }
+        done()
+      })
+      ses.destroy()
+    })
+  })
+
+  describe('ses.setBackgroundTabPolicy(options)', function () {
+    let ses = null
+    let hidden = null
+
+    beforeEach(function () {
+      const partition = `background-tabs-${Date.now()}`
+      ses = session.fromPartition(partition)
+      ses.setBackgroundTabPolicy({enabled: true, freezeAfter: 0.1})
+      hidden = new BrowserWindow({
+        show: false,
+        webPreferences: {partition: partition}
+      })
+    })
+
+    afterEach(function () {
+      ses.setBackgroundTabPolicy({enabled: false})
+      return closeWindow(hidden).then(function () { hidden = null })
+    })
+
+    it('freezes tabs created in the background until they are shown', function (done) {
+      // The renderers are checked every 10 seconds, and frozen on the
+      // second check that finds them hidden.
+      this.timeout(60000)
+      const waitFor = function (condition, callback) {
+        if (condition(ses.getBackgroundTabStats())) {
+          callback()
+        } else {
+          setTimeout(waitFor, 200, condition, callback)
+        }
+      }
+      hidden.loadURL('about:blank')
+      waitFor((stats) => stats.freezes === 1, function () {
+        assert.equal(ses.getBackgroundTabStats().frozenProcesses, 1)
+        hidden.show()
+        waitFor((stats) => stats.thaws === 1, function () {
+          assert.equal(ses.getBackgroundTabStats().frozenProcesses, 0)
+          done()
+        })
+      })
+    })
+  })
+
   describe('ses.setProxy(options, callback)', function () {
     it('allows configuring proxy settings', function (done) {
       const config = {
@@ -97,4 +97,172 @@ describe('webContents module', function () {
       })
     })
   })
+
+  describe('setTabRestoreOptions() API', function () {
+    const url = 'file://' + path.join(fixtures, 'pages', 'a.html')
+    const tabs = []
+
+    afterEach(function () {
+      webContents.setTabRestoreOptions({maxConcurrentLoads: 0})
+      while (tabs.length > 0) {
+        tabs.pop().destroy()
+      }
+    })
+
+    const createTab = function (options) {
+      return new Promise(function (resolve) {
+        webContents.createTab(w.webContents, w.webContents.session,
+            Object.assign({url: url, lazyLoad: true}, options), function (tab) {
+              tabs.push(tab)
+              resolve(tab)
+            })
+      })
+    }
+
+    const waitForLoaded = function (tabIds) {
+      return new Promise(function (resolve) {
+        const poll = function () {
+          const timings = webContents.getTabRestoreStats().tabs.filter(
+              (timing) => tabIds.includes(timing.tabId))
+          if (timings.length === tabIds.length) {
+            resolve(timings)
+          } else {
+            setTimeout(poll, 50)
+          }
+        }
+        poll()
+      })
+    }
+
+    it('loads lazily created background tabs one at a time', function () {
+      webContents.setTabRestoreOptions({maxConcurrentLoads: 1})
+      return Promise.all([
+        createTab({active: false}),
+        createTab({active: false})
+      ]).then(function (created) {
+        const stats = webContents.getTabRestoreStats()
+        assert.equal(stats.maxConcurrentLoads, 1)
+        assert.ok(stats.loading <= 1)
+        return waitForLoaded(created.map((tab) => tab.getId()))
+      }).then(function (timings) {
+        // The window is hidden.
+        for (const timing of timings) {
+          assert.equal(timing.priority, 1)
+        }
+      })
+    })
+
+    it('loads a lazily created active tab right away', function () {
+      return createTab({active: true}).then(function (tab) {
+        return waitForLoaded([tab.getId()])
+      }).then(function (timings) {
+        assert.equal(timings[0].priority, 0)
+        assert.ok(timings[0].queueTime < 1)
+      })
+    })
+  })
+
+  describe('setEventCoalescing() API', function () {
+    const setTitles = `
+      document.title = 'a'
+      document.title = 'b'
+      document.title = 'c'
+    `
+
+    it('does not coalesce any event by default', function () {
+      const events = w.webContents.getEventCoalescingStats().events
+      for (const name in events) {
+        assert.equal(events[name].coalesced, false, name)
+      }
+    })
+
+    it('emits only the latest value of a coalesced event', function (done) {
+      w.webContents.setEventCoalescing({
+        interval: 200,
+        events: {'page-title-updated': true}
+      })
+      w.webContents.once('did-finish-load', function () {
+        const titles = []
+        w.webContents.on('page-title-updated', function (event, title) {
+          titles.push(title)
+        })
+        w.webContents.executeJavaScript(setTitles)
+        setTimeout(function () {
+          assert.deepEqual(titles, ['c'])
+          const stats = w.webContents.getEventCoalescingStats()
+          const titleStats = stats.events['page-title-updated']
+          assert.equal(stats.interval, 200)
+          assert.equal(titleStats.coalesced, true)
+          assert.ok(titleStats.dropped >= 2)
+          done()
+        }, 1000)
+      })
+      w.loadURL('about:blank')
+    })
+
+    it('emits every value when coalescing is disabled', function (done) {
+      w.webContents.setEventCoalescing({interval: 0})
+      w.webContents.once('did-finish-load', function () {
+        const titles = []
+        w.webContents.on('page-title-updated', function (event, title) {
+          titles.push(title)
+          if (title === 'c') {
+            assert.deepEqual(titles, ['a', 'b', 'c'])
+            done()
+          }
+        })
+        w.webContents.executeJavaScript(setTitles)
+      })
+      w.loadURL('about:blank')
+    })
+  })
+
+  describe('captureThumbnail() API', function () {
+    beforeEach(function (done) {
+      w.show()
+      w.webContents.once('did-finish-load', () => done())
+      w.loadURL(`file://${fixtures}/pages/a.html`)
+    })
+
+    it('caches the thumbnail until the page gets input', function (done) {
+      const options = {width: 40, height: 30, format: 'png'}
+      w.webContents.setThumbnailCaptureInterval(0)
+      w.webContents.captureThumbnail(options, function (data) {
+        if (data === null) return done()  // no surface on this platform
+        assert.deepEqual(Array.from(data.slice(1, 4)), [0x50, 0x4e, 0x47])
+
+        const before = webContents.getThumbnailCacheStats()
+        w.webContents.captureThumbnail(options, function (cached) {
+          const stats = webContents.getThumbnailCacheStats()
+          assert.equal(stats.hits, before.hits + 1)
+          assert.equal(cached.length, data.length)
+
+          w.webContents.sendInputEvent({type: 'keyDown', keyCode: 'a'})
+          setTimeout(function () {
+            w.webContents.captureThumbnail(options, function () {
+              const after = webContents.getThumbnailCacheStats()
+              assert.equal(after.misses, stats.misses + 1)
+              done()
+            })
+          }, 100)
+        })
+      })
+    })
+
+    it('rejects a negative capture interval', function () {
+      assert.throws(function () {
+        w.webContents.setThumbnailCaptureInterval(-1)
+      }, /interval/)
+    })
+
+    it('calls pending callbacks with null when the page is destroyed',
+       function (done) {
+         w.webContents.captureThumbnail({width: 40, height: 30},
+                                        function (data) {
+           assert.equal(data, null)
+           done()
+         })
+         w.destroy()
+       })
+  })
 })
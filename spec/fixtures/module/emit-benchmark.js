@@ -0,0 +1,17 @@
+// Runs in the main process, so the listener does not go through remote.
+const {app} = require('electron')
+
+const name = 'emit-benchmark'
+
+exports.run = function (iterations) {
+  const withoutListeners = app._measureEmitCost(name, iterations)
+
+  let count = 0
+  const listener = () => { count++ }
+  app.on(name, listener)
+  const withListeners = app._measureEmitCost(name, iterations)
+  app.removeListener(name, listener)
+
+  const afterRemoval = app._measureEmitCost(name, iterations)
+  return {withoutListeners, withListeners, afterRemoval, count}
+}
@@ -0,0 +1,29 @@
+// Runs in the main process, so the listeners do not go through remote.
+const {app} = require('electron')
+
+const name = 'emit-tracking'
+
+// Runs |steps| against app and counts the native emits of |name| that reach
+// app.emit, and how many of them a listener got.
+exports.run = function (steps) {
+  let emitted = 0
+  let delivered = 0
+  const listener = () => { delivered++ }
+
+  app.emit = function (event) {
+    if (event === name) emitted++
+    return Object.getPrototypeOf(this).emit.apply(this, arguments)
+  }
+  try {
+    for (const step of steps) {
+      if (step === 'emit') app._emitForTesting(name)
+      else if (step === 'once') app.once(name, listener)
+      else if (step === 'prepend') app.prependListener(name, listener)
+      else if (step === 'remove') app.removeListener(name, listener)
+    }
+  } finally {
+    delete app.emit
+    app.removeListener(name, listener)
+  }
+  return {emitted, delivered}
+}
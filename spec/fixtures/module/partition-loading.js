@@ -0,0 +1,22 @@
+// Runs in the main process, so the partition is still loading when the
+// WebContents is created in the same task.
+const {session, webContents, BrowserWindow} = require('electron')
+
+const capture = function (fn) {
+  try {
+    fn()
+    return null
+  } catch (error) {
+    return error.message
+  }
+}
+
+exports.run = function (partition) {
+  const loaded = session.fromPartitionAsync(partition)
+  const errors = {
+    fromPartition: capture(() => session.fromPartition(partition)),
+    webContents: capture(() => webContents.create({partition})),
+    window: capture(() => new BrowserWindow({show: false, webPreferences: {partition}}))
+  }
+  return loaded.then(() => errors)
+}
@@ -0,0 +1,5 @@
+this.onmessage = function () {
+  this.postMessage([
+    typeof define, typeof requireNative, typeof requireAsync, typeof privates
+  ].join(' '))
+}
@@ -1,7 +1,9 @@
 const assert = require('assert')
+const fs = require('fs')
 const Module = require('module')
 const path = require('path')
 const temp = require('temp')
+const {remote} = require('electron')
 
 describe('third-party module', function () {
   var fixtures = path.join(__dirname, 'fixtures')
@@ -100,3 +102,89 @@ describe('Module._nodeModulePaths', function () {
     })
   })
 })
+
+describe('code cache of the browser process', function () {
+  temp.track()
+
+  it('stores the code of modules required in the browser process', function () {
+    const v8Util = remote.process.atomBinding('v8_util')
+    if (!v8Util.getCodeCacheStats().enabled) return
+
+    const modulePath = path.join(temp.mkdirSync('code-cache'), 'module.js')
+    fs.writeFileSync(modulePath, `module.exports = ${Date.now()}`)
+    const before = v8Util.getCodeCacheStats()
+    remote.require(modulePath)
+    const after = v8Util.getCodeCacheStats()
+    assert.equal(after.misses, before.misses + 1)
+    assert.equal(after.stored, before.stored + 1)
+  })
+
+  it('leaves other callers of vm.runInThisContext alone', function () {
+    const v8Util = remote.process.atomBinding('v8_util')
+    if (!v8Util.getCodeCacheStats().enabled) return
+
+    const before = v8Util.getCodeCacheStats()
+    const vm = remote.require('vm')
+    assert.equal(vm.runInThisContext('1 + 1', {filename: 'script.js'}), 2)
+    const after = v8Util.getCodeCacheStats()
+    assert.equal(after.misses, before.misses)
+    assert.equal(after.hits, before.hits)
+  })
+
+  it('drops cached data that V8 rejects', function (done) {
+    const v8Util = remote.process.atomBinding('v8_util')
+    if (!v8Util.getCodeCacheStats().enabled) return done()
+
+    const modulePath = path.join(temp.mkdirSync('code-cache'), 'module.js')
+    const content = `module.exports = ${Date.now()}`
+    fs.writeFileSync(modulePath, content)
+    const source = Module.wrap(content)
+    v8Util.setCodeCache(modulePath, source, Buffer.from('not a code cache'))
+
+    // Entries are written on a background sequence.
+    const waitForEntry = function () {
+      if (!v8Util.getCodeCache(modulePath, source)) {
+        return setTimeout(waitForEntry, 10)
+      }
+      const before = v8Util.getCodeCacheStats()
+      remote.require(modulePath)
+      const after = v8Util.getCodeCacheStats()
+      assert.equal(after.rejected, before.rejected + 1)
+      assert.equal(after.hits, before.hits)
+      done()
+    }
+    waitForEntry()
+  })
+
+  it('keeps only the directory of the running version', function () {
+    const v8Util = remote.process.atomBinding('v8_util')
+    const stats = v8Util.getCodeCacheStats()
+    if (!stats.enabled) return
+
+    const version = path.basename(stats.directory)
+    assert.ok(version.endsWith(`-${remote.process.versions.v8}`))
+    assert.deepEqual(fs.readdirSync(path.dirname(stats.directory)), [version])
+  })
+
+  it('compiles the modules of workers with the module system in scope',
+     function (done) {
+       const v8Util = remote.process.atomBinding('v8_util')
+       const before = v8Util.getCodeCacheStats()
+       const worker = remote.app.createWorker('fixtures/workers/code-cache')
+       worker.onmessage = function (event) {
+         assert.equal(event.data, 'function function function object')
+         if (before.enabled) {
+           const after = v8Util.getCodeCacheStats()
+           assert.ok(after.hits + after.misses > before.hits + before.misses)
+         }
+         worker.terminate()
+         done()
+       }
+       worker.onerror = function (message) {
+         done(new Error(message))
+       }
+       worker.start(function () {
+         worker.postMessage('')
+       })
+     })
+})
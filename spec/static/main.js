@@ -27,6 +27,9 @@ process.port = 0 // will be used by crash-reporter spec.
 app.commandLine.appendSwitch('js-flags', '--expose_gc')
 app.commandLine.appendSwitch('ignore-certificate-errors')
 app.commandLine.appendSwitch('disable-renderer-backgrounding')
+app.commandLine.appendSwitch('enable-test-hooks')
+// Workers load their modules from the spec directory.
+app.commandLine.appendSwitch('source-root', path.resolve(__dirname, '..'))
 
 // Accessing stdout in the main process will result in the process.stdout
 // throwing UnknownSystemError in renderer process sometimes. This line makes
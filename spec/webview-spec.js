@@ -904,7 +904,7 @@ describe('<webview> tag', function () {
         assert.equal(event.requestMethod, 'GET')
         assert(typeof event.referrer === 'string', 'referrer should be string')
         assert(!!event.headers, 'headers should be present')
-        assert(typeof event.headers === 'object', 'headers should be object')
+        assert.equal(typeof event.headers.toObject(), 'object')
         assert.equal(event.resourceType, expectedType, 'Incorrect resourceType')
         if (responses === Object.keys(expectedResources).length) {
           done()
@@ -913,6 +913,47 @@ describe('<webview> tag', function () {
       webview.src = 'file://' + path.join(fixtures, 'pages', 'did-get-response-details.html')
       document.body.appendChild(webview)
     })
+
+    it('passes the response headers', function (done) {
+      const server = http.createServer(function (req, res) {
+        res.setHeader('Content-Type', 'text/html')
+        res.setHeader('X-Repeated', ['a', 'b'])
+        res.end('<html></html>')
+      })
+      server.listen(0, '127.0.0.1', function () {
+        webview.addEventListener('did-get-response-details', function (event) {
+          server.close()
+          const headers = event.headers
+          assert.deepEqual(headers.get('content-type'), ['text/html'])
+          assert.deepEqual(headers.get('Content-Type'), ['text/html'])
+          assert.deepEqual(headers.get('X-REPEATED'), ['a', 'b'])
+          assert.equal(headers.has('x-repeated'), true)
+          assert.equal(headers.has('x-not-sent'), false)
+          assert.equal(headers.get('x-not-sent'), undefined)
+          assert.deepEqual(headers.toObject()['x-repeated'], ['a', 'b'])
+          done()
+        }, {once: true})
+        webview.src = `http://127.0.0.1:${server.address().port}/`
+        document.body.appendChild(webview)
+      })
+    })
+
+    it('is only forwarded while the webview has listeners', function (done) {
+      const name = 'did-get-response-details'
+      const listener = function () {}
+      webview.addEventListener('did-finish-load', function () {
+        // The listeners are reported over the same channel as remote calls.
+        const guest = webview.getWebContents()
+        assert.equal(guest.listenerCount(name), 0)
+        webview.addEventListener(name, listener)
+        assert.equal(guest.listenerCount(name), 1)
+        webview.removeEventListener(name, listener)
+        assert.equal(guest.listenerCount(name), 0)
+        done()
+      }, {once: true})
+      webview.src = 'file://' + path.join(fixtures, 'pages', 'did-get-response-details.html')
+      document.body.appendChild(webview)
+    })
   })
 
   it('inherits the zoomFactor of the parent window', function (done) {
@@ -971,4 +1012,122 @@ describe('<webview> tag', function () {
       done()
     })
   })
+
+  describe('tab discard policy', function () {
+    const {webContents} = require('electron').remote
+
+    afterEach(function () {
+      webContents.setTabDiscardPolicy({enabled: true})
+    })
+
+    it('does not discard tabs under memory pressure when disabled', function (done) {
+      webview.addEventListener('did-finish-load', function () {
+        const discards = webContents.getTabDiscardStats().discards
+        const detached = () => done(new Error('the tab was discarded'))
+        webview.addEventListener('did-detach', detached)
+        webContents.setTabDiscardPolicy({enabled: false})
+        app.once('memory-reclaimed', function (event, details) {
+          const tabs = details.consumers.find(
+              (consumer) => consumer.name === 'background-tabs')
+          assert.equal(tabs.bytesFreed, 0)
+          assert.equal(webContents.getTabDiscardStats().discards, discards)
+          // Give a tab manager reacting to the pressure time to discard.
+          setTimeout(function () {
+            webview.removeEventListener('did-detach', detached)
+            done()
+          }, 500)
+        })
+        app.sendMemoryPressureAlert('critical')
+      }, {once: true})
+      webview.src = 'file://' + fixtures + '/pages/a.html'
+      document.body.appendChild(webview)
+    })
+  })
+
+  describe('spare renderer pool', function () {
+    let ses = null
+    let partition = null
+
+    beforeEach(function (done) {
+      partition = `spare-renderers-${Date.now()}`
+      ses = session.fromPartition(partition)
+      ses.setSpareRendererPoolSize(1)
+      const waitForSpare = function () {
+        if (ses.getSpareRendererPoolStats().size === 1) {
+          done()
+        } else {
+          setTimeout(waitForSpare, 100)
+        }
+      }
+      waitForSpare()
+    })
+
+    afterEach(function () {
+      ses.setSpareRendererPoolSize(0)
+    })
+
+    it('starts tabs in a spare renderer', function (done) {
+      webview.addEventListener('did-attach', function () {
+        const stats = ses.getSpareRendererPoolStats()
+        assert.equal(stats.hits, 1)
+        assert.equal(stats.misses, 0)
+        done()
+      }, {once: true})
+      webview.setAttribute('partition', partition)
+      webview.src = 'file://' + fixtures + '/pages/a.html'
+      document.body.appendChild(webview)
+    })
+
+    it('does not give a spare to WebUI pages', function (done) {
+      webview.addEventListener('did-attach', function () {
+        const stats = ses.getSpareRendererPoolStats()
+        assert.equal(stats.hits, 0)
+        assert.equal(stats.misses, 0)
+        assert.equal(stats.size, 1)
+        done()
+      }, {once: true})
+      webview.setAttribute('partition', partition)
+      webview.src = 'chrome://gpu/'
+      document.body.appendChild(webview)
+    })
+  })
+
+  describe('web requests', function () {
+    let server = null
+    const partition = 'webview-tab-requests'
+
+    beforeEach(function (done) {
+      server = http.createServer(function (req, res) {
+        if (req.url === '/') {
+          res.end('<iframe src="/frame"></iframe>')
+        } else {
+          res.end('frame')
+        }
+      })
+      server.listen(0, '127.0.0.1', done)
+    })
+
+    afterEach(function () {
+      session.fromPartition(partition).webRequest.onBeforeRequest(null)
+      server.close()
+    })
+
+    it('are attributed to the tab of the webview, sub frames included', function (done) {
+      const tabIds = {}
+      const ses = session.fromPartition(partition)
+      ses.webRequest.onBeforeRequest(function (details, callback) {
+        tabIds[url.parse(details.url).pathname] = details.tabId
+        callback({})
+      })
+      webview.addEventListener('did-finish-load', function () {
+        assert.notEqual(tabIds['/'], undefined)
+        assert.notEqual(tabIds['/'], -1)
+        assert.equal(tabIds['/frame'], tabIds['/'])
+        done()
+      })
+      webview.setAttribute('partition', partition)
+      webview.src = `http://127.0.0.1:${server.address().port}/`
+      document.body.appendChild(webview)
+    })
+  })
 })